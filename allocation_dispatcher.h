@@ -1,6 +1,12 @@
 
 namespace memo
 {	
+	// This struct is put in front of dynamic arrays to keep the size
+	struct _ArrayHeader
+	{
+		size_t m_size;
+	};
+
 	template <typename TYPE>
 		class DefaultAllocationDispatcher
 	{
@@ -25,7 +31,10 @@ namespace memo
 		static void _delete( TYPE * i_pointer )
 		{
 			i_pointer->~TYPE();
-			memo::free( i_pointer );
+			if( std::is_polymorphic<TYPE>::value )
+				memo::free( i_pointer ); // the dynamic type of the object may be bigger than TYPE
+			else
+				memo::free_sized( i_pointer, sizeof(TYPE) );
 		}
 
 		/** _delete( i_allocator, i_pointer ) - destroys and deallocates an object of a given type with the specified allocator.
@@ -33,7 +42,10 @@ namespace memo
 		static void _delete( IAllocator & i_allocator, TYPE * i_pointer )
 		{
 			i_pointer->~TYPE();
-			i_allocator.free( i_pointer );
+			if( std::is_polymorphic<TYPE>::value )
+				i_allocator.free( i_pointer ); // the dynamic type of the object may be bigger than TYPE
+			else
+				i_allocator.free( i_pointer, sizeof(TYPE) );
 		}
 
 		/** lifo_delete( i_pointer ) - destroys and deallocates an object of a given type with the lifo allocator.
@@ -137,15 +149,16 @@ namespace memo
 		static void delete_array( TYPE * i_pointer )
 		{
 			_ArrayHeader * header = reinterpret_cast< _ArrayHeader * >( i_pointer ) - 1;
+			const size_t size = header->m_size;
 		
-			TYPE * curr = i_pointer + header->m_size;
-			while( curr >= i_pointer )
+			TYPE * curr = i_pointer + size;
+			while( curr > i_pointer )
 			{
-				curr->~TYPE();
 				curr--;
+				curr->~TYPE();
 			}
 			
-			return free( header );
+			return free_sized( header, sizeof(TYPE) * size + sizeof(_ArrayHeader) );
 		}
 
 		/** delete_array( i_allocator, i_pointer ) - destroys and deallocates an array of a given type with with the specified allocator.
@@ -153,15 +166,40 @@ namespace memo
 		static void delete_array( IAllocator & i_allocator, TYPE * i_pointer )
 		{
 			_ArrayHeader * header = reinterpret_cast< _ArrayHeader * >( i_pointer ) - 1;
+			const size_t size = header->m_size;
 		
-			TYPE * curr = i_pointer + header->m_size;
-			while( curr >= i_pointer )
+			TYPE * curr = i_pointer + size;
+			while( curr > i_pointer )
 			{
-				curr->~TYPE();
 				curr--;
+				curr->~TYPE();
 			}
 
-			return i_allocator.free( header );
+			return i_allocator.free( header, sizeof(TYPE) * size + sizeof(_ArrayHeader) );
+		}
+
+		/** new_batch<TYPE>( i_count, o_objects ) - allocates and default-constructs many objects with the current allocator of the thread.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_NEW_BATCH instead. */ 
+		static size_t new_batch( size_t i_count, TYPE * * o_objects )
+		{
+			void * * blocks = reinterpret_cast< void * * >( o_objects );
+
+			const size_t count = alloc_batch( i_count, sizeof(TYPE), MEMO_ALIGNMENT_OF( TYPE ), 0, blocks );
+
+			for( size_t index = 0; index < count; index++ )
+				o_objects[ index ] = new( blocks[ index ] ) TYPE;
+
+			return count;
+		}
+
+		/** delete_batch( io_objects, i_count ) - destroys and deallocates many objects of a given type with the allocators used to allocate them.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE_BATCH instead. */
+		static void delete_batch( TYPE * * io_objects, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				io_objects[ index ]->~TYPE();
+
+			free_batch( reinterpret_cast< void * * >( io_objects ), i_count );
 		}
 
 	}; // end of DefaultAllocationDispatcher<TYPE>
@@ -173,12 +211,6 @@ namespace memo
 		class AllocationDispatcher : public DefaultAllocationDispatcher<TYPE>
 			{ };
 
-// This struct is put in front of dynamic arrays to keep the size
-	struct _ArrayHeader
-	{
-		size_t m_size;
-	};
-
 
 	/** _delete( i_pointer ) - destroys and deallocates an object of a given type with the allocator used to allocate it.
 		This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE instead. */
@@ -220,5 +252,13 @@ namespace memo
 		AllocationDispatcher<TYPE>::delete_array( i_allocator, i_pointer );
 	}
 
+	/** _delete_batch( io_objects, i_count ) - destroys and deallocates many objects of a given type with the allocators used to allocate them.
+		This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE_BATCH instead. */
+	template <typename TYPE>
+		inline void _delete_batch( TYPE * * io_objects, size_t i_count )
+	{
+		AllocationDispatcher<TYPE>::delete_batch( io_objects, i_count );
+	}
+
 } // namespace memo
 
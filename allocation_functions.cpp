@@ -8,29 +8,51 @@ namespace memo
 
 	#if MEMO_ONLY_DEFAULT_ALLOCATOR
 
-		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
 		{
-			return DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset );
+			return DefaultAllocator::s_realloc( i_address, i_new_size, i_alignment, i_alignment_offset );
 		}
 
-		void * alloc( IAllocator & /*i_allocator*/, size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		void free_sized( void * i_address, size_t /*i_size*/ )
 		{
-			return DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset );
+			DefaultAllocator::s_free( i_address );
 		}
 
-		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+		void dbg_check( void * i_address )
 		{
-			return DefaultAllocator::s_realloc( i_address, i_new_size, i_alignment, i_alignment_offset );
+			DefaultAllocator::s_dbg_check( i_address );
 		}
 
-		void free( void * i_address )
+		bool try_expand( void * i_address, size_t i_new_size )
 		{
-			DefaultAllocator::s_free( i_address );
+			return DefaultAllocator::s_try_expand( i_address, i_new_size );
 		}
 
-		void dbg_check( void * i_address )
+		size_t usable_size( void * i_address )
 		{
-			DefaultAllocator::s_dbg_check( i_address );
+			return DefaultAllocator::s_usable_size( i_address );
+		}
+
+		size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+			{
+				o_blocks[ index ] = DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset );
+				if( o_blocks[ index ] == nullptr )
+					return index;
+			}
+			return i_count;
+		}
+
+		size_t alloc_batch( IAllocator & /*i_allocator*/, size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			return alloc_batch( i_count, i_size, i_alignment, i_alignment_offset, o_blocks );
+		}
+
+		void free_batch( void * * io_blocks, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				DefaultAllocator::s_free( io_blocks[ index ] );
 		}
 	
 		void * unaligned_alloc( size_t i_size )
@@ -53,45 +75,39 @@ namespace memo
 			DefaultAllocator::s_unaligned_free( i_address );
 		}
 
-		void unaligned_dbg_check( void * i_address )
+		void unaligned_free_sized( void * i_address, size_t /*i_size*/ )
 		{
-			DefaultAllocator::s_unaligned_dbg_check( i_address );
+			DefaultAllocator::s_unaligned_free( i_address );
 		}
 
-	#else
-	
-		struct _AllocationHeader
+		void unaligned_dbg_check( void * i_address )
 		{
-			IAllocator * m_allocator;		
-		};
+			DefaultAllocator::s_unaligned_dbg_check( i_address );
+		}
 
-		void * alloc( IAllocator & i_allocator, size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		bool unaligned_try_expand( void * i_address, size_t i_new_size )
 		{
-			_AllocationHeader * header = static_cast<_AllocationHeader*>(
-				i_allocator.alloc( i_size + sizeof(_AllocationHeader), i_alignment, i_alignment_offset + sizeof(_AllocationHeader) ) );
-
-			if( header != nullptr )
-			{
-				header->m_allocator = &i_allocator;
-
-				return header + 1;
-			}
-			else
-				return nullptr;
+			return DefaultAllocator::s_unaligned_try_expand( i_address, i_new_size );
 		}
-		
-		// alloc
-		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+
+		size_t unaligned_usable_size( void * i_address )
 		{
-			IAllocator * current_allocator = memo_externals::get_current_thread_allocator();
-			return alloc( *current_allocator, i_size, i_alignment, i_alignment_offset );
+			return DefaultAllocator::s_unaligned_usable_size( i_address );
 		}
 
+	#else
+
 		// realloc
 		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
 		{
 			MEMO_ASSERT( i_address != nullptr ); // realloc with null address is not allowed, use alloc instead
 			
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->realloc( i_address, i_new_size, i_alignment, i_alignment_offset );
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
 			_AllocationHeader * new_header = static_cast<_AllocationHeader*>(
@@ -103,14 +119,23 @@ namespace memo
 				return nullptr;
 		}
 
-		// free
-		void free( void * i_address )
+		// free_sized
+		void free_sized( void * i_address, size_t i_size )
 		{
-			MEMO_ASSERT( i_address != nullptr ); // free with null address is not allowed
+			MEMO_ASSERT( i_address != nullptr ); // free_sized with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->free( i_address, i_size );
+					return;
+				}
+			#endif
 
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
-			header->m_allocator->free( header );
+			header->m_allocator->free( header, i_size + sizeof(_AllocationHeader) );
 		}
 
 		// dbg_check
@@ -118,11 +143,123 @@ namespace memo
 		{
 			MEMO_ASSERT( i_address != nullptr ); // dbg_check with null address is not allowed
 
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->dbg_check( i_address );
+					return;
+				}
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
 			header->m_allocator->dbg_check( header );
 		}
 
+		// try_expand
+		bool try_expand( void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // try_expand with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->try_expand( i_address, i_new_size );
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			return header->m_allocator->try_expand( header, i_new_size + sizeof(_AllocationHeader) );
+		}
+
+		// usable_size
+		size_t usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // usable_size with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->usable_size( i_address );
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			const size_t size = header->m_allocator->usable_size( header );
+			return size > sizeof(_AllocationHeader) ? size - sizeof(_AllocationHeader) : 0;
+		}
+
+		// alloc_batch
+		size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			IAllocator * current_allocator = memo_externals::get_current_thread_allocator();
+			return alloc_batch( *current_allocator, i_count, i_size, i_alignment, i_alignment_offset, o_blocks );
+		}
+
+		// alloc_batch
+		size_t alloc_batch( IAllocator & i_allocator, size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			#if MEMO_ENABLE_PAGE_MAP
+				if( i_allocator.is_page_mapped() )
+					return i_allocator.alloc_batch( i_count, i_size, i_alignment, i_alignment_offset, o_blocks ); // the owner is found by address
+			#endif
+
+			const size_t count = i_allocator.alloc_batch( i_count, i_size + sizeof(_AllocationHeader), 
+				i_alignment, i_alignment_offset + sizeof(_AllocationHeader), o_blocks );
+
+			for( size_t index = 0; index < count; index++ )
+			{
+				_AllocationHeader * header = static_cast<_AllocationHeader*>( o_blocks[ index ] );
+				header->m_allocator = &i_allocator;
+				o_blocks[ index ] = header + 1;
+			}
+
+			return count;
+		}
+
+		// _get_block_owner - retrieves the allocator of a block allocated by memo::alloc, and the address of the block for it
+		static IAllocator * _get_block_owner( void * i_address, void * * o_allocator_block )
+		{
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					*o_allocator_block = i_address;
+					return page_owner;
+				}
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+			*o_allocator_block = header;
+			return header->m_allocator;
+		}
+
+		// free_batch
+		void free_batch( void * * io_blocks, size_t i_count )
+		{
+			size_t run_start = 0;
+			while( run_start < i_count )
+			{
+				// find the run of consecutive blocks owned by the same allocator, replacing the addresses in the array
+				MEMO_ASSERT( io_blocks[ run_start ] != nullptr ); // free_batch with null address is not allowed
+				void * allocator_block;
+				IAllocator * const allocator = _get_block_owner( io_blocks[ run_start ], &allocator_block );
+				io_blocks[ run_start ] = allocator_block;
+				size_t run_end = run_start + 1;
+				for( ; run_end < i_count; run_end++ )
+				{
+					MEMO_ASSERT( io_blocks[ run_end ] != nullptr ); // free_batch with null address is not allowed
+					if( _get_block_owner( io_blocks[ run_end ], &allocator_block ) != allocator )
+						break;
+					io_blocks[ run_end ] = allocator_block;
+				}
+
+				allocator->free_batch( io_blocks + run_start, run_end - run_start );
+				run_start = run_end;
+			}
+		}
+
 		// unaligned_alloc
 		void * unaligned_alloc( size_t i_size )
 		{
@@ -133,6 +270,11 @@ namespace memo
 		// unaligned_alloc
 		void * unaligned_alloc( IAllocator & i_allocator, size_t i_size )
 		{
+			#if MEMO_ENABLE_PAGE_MAP
+				if( i_allocator.is_page_mapped() )
+					return i_allocator.unaligned_alloc( i_size ); // the owner is found by address
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>(i_allocator.unaligned_alloc( i_size + sizeof(_AllocationHeader) ) );
 
 			if( header != nullptr )
@@ -150,6 +292,12 @@ namespace memo
 		{
 			MEMO_ASSERT( i_address != nullptr ); // unaligned_realloc with null address is not allowed, use alloc instead
 
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->unaligned_realloc( i_address, i_new_size );
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
 			_AllocationHeader * new_header = static_cast<_AllocationHeader*>(
@@ -166,37 +314,93 @@ namespace memo
 		{
 			MEMO_ASSERT( i_address != nullptr ); // unaligned_free with null address is not allowed
 
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->unaligned_free( i_address );
+					return;
+				}
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
 			header->m_allocator->unaligned_free( header );
 		}
 
+		// unaligned_free_sized
+		void unaligned_free_sized( void * i_address, size_t i_size )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // unaligned_free_sized with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->unaligned_free( i_address, i_size );
+					return;
+				}
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			header->m_allocator->unaligned_free( header, i_size + sizeof(_AllocationHeader) );
+		}
+
 		// unaligned_dbg_check
 		void unaligned_dbg_check( void * i_address )
 		{
 			MEMO_ASSERT( i_address != nullptr ); // unaligned_dbg_check with null address is not allowed
 
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->unaligned_dbg_check( i_address );
+					return;
+				}
+			#endif
+
 			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
 
 			header->m_allocator->unaligned_dbg_check( header );
-		}	
+		}
 
-	#endif
+		// unaligned_try_expand
+		bool unaligned_try_expand( void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // unaligned_try_expand with null address is not allowed
 
-	IAllocator & get_current_allocator()
-	{
-		IAllocator * current_allocator = memo_externals::get_current_thread_allocator();
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->unaligned_try_expand( i_address, i_new_size );
+			#endif
 
-		return *current_allocator;
-	}
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			return header->m_allocator->unaligned_try_expand( header, i_new_size + sizeof(_AllocationHeader) );
+		}
+
+		// unaligned_usable_size
+		size_t unaligned_usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // unaligned_usable_size with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+					return page_owner->unaligned_usable_size( i_address );
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			const size_t size = header->m_allocator->unaligned_usable_size( header );
+			return size > sizeof(_AllocationHeader) ? size - sizeof(_AllocationHeader) : 0;
+		}
+
+	#endif
 
-	ObjectStack & get_lifo_allocator()
-	{
-		ThreadRoot * thread_context = memo_externals::get_thread_root();
-		MEMO_ASSERT( thread_context != nullptr ); // create a memo::ThreadRoot object on the call stack of the thread procedure
-		return thread_context->lifo_allocator();
-	}
-	
 	// lifo_alloc
 	void * lifo_alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset, DeallocationCallback i_deallocation_callback )
 	{
@@ -31,6 +31,17 @@
 		Destroys an array created with MEMO_NEW_ARRAY or MEMO_NEW_ARRAY_SRC, using the allocator that allocated the object. */
 #define MEMO_DELETE_ARRAY( pointer )				::memo::_delete_array( pointer ) // this function redirects the call to the AllocationDispatcher
 
+/** \def MEMO_NEW_BATCH( TYPE, size_t count, TYPE * * objects ) 
+		Default-constructs count instances of TYPE using the current allocator of the calling thread, and writes the pointers to 
+		them in the array objects. Evaluates to the number of objects created, that is less than count only if the allocation fails.
+		Every object can be destroyed either with MEMO_DELETE or with MEMO_DELETE_BATCH. */
+#define MEMO_NEW_BATCH( TYPE, count, objects )		::memo::AllocationDispatcher<TYPE>::new_batch( count, objects )
+
+/** \def MEMO_DELETE_BATCH( TYPE * * objects, size_t count ) 
+		Destroys count objects created with MEMO_NEW or MEMO_NEW_BATCH, using the allocators that allocated them. The content 
+		of the array objects is undefined after the call. */
+#define MEMO_DELETE_BATCH( objects, count )			::memo::_delete_batch( objects, count ) // this function redirects the call to the AllocationDispatcher
+
 
 /** \def MEMO_NEW_ALLOC( memo::IAllocator & allocator, TYPE, ... ) 
 		Creates a new instance of TYPE using the specified allocator. */
@@ -60,6 +71,16 @@
 
 namespace memo
 {
+	#if !MEMO_ONLY_DEFAULT_ALLOCATOR
+
+		/* header of the blocks allocated by memo::alloc with an allocator not registered in the page map */
+		struct _AllocationHeader
+		{
+			IAllocator * m_allocator;		
+		};
+
+	#endif
+
 			///// allocator ////
 
 	IAllocator & get_current_allocator();
@@ -135,6 +156,14 @@ namespace memo
 	*/
 	void free( void * i_address );
 
+	/** deallocates a memory block allocated by memo::alloc or memo::realloc, using the allocator that 
+		allocated it. The size of the block is passed to the allocator (see IAllocator::free), so that
+		it may skip retrieving it.
+		@param i_address address of the memory block to free. It cannot be nullptr.
+		@param i_size size of the block, as requested to the last memo::alloc or memo::realloc performed on it
+	*/
+	void free_sized( void * i_address, size_t i_size );
+
 	/** performs some checks on a new memory block allocated by memo::alloc or memo::realloc, using the 
 		allocator that allocated it. The actual checks depend on the allocator and the configuration 
 		being compiled.
@@ -142,6 +171,54 @@ namespace memo
 	*/
 	void dbg_check( void * i_address );
 
+	/** tries to resize a memory block allocated by memo::alloc or memo::realloc without moving it, using the
+		allocator that allocated it (see IAllocator::try_expand). If the resize fails the block is left unchanged.
+		@param i_address address of the memory block to resize. It cannot be nullptr.
+		@param i_new_size new size of the block in bytes
+		@return true if the block has been resized, false otherwise
+	*/
+	bool try_expand( void * i_address, size_t i_new_size );
+
+	/** retrieves the number of bytes that can be used in a memory block allocated by memo::alloc or memo::realloc,
+		that may be greater than the requested size (see IAllocator::usable_size). Resizing the block up to this size
+		with memo::try_expand never fails.
+		@param i_address address of the memory block. It cannot be nullptr.
+		@return the usable size of the block, or 0 if the allocator that allocated it does not know it
+	*/
+	size_t usable_size( void * i_address );
+
+	/** allocates many memory blocks with the same size and alignment using the current allocator of the calling thread.
+		The blocks are equivalent to blocks allocated by memo::alloc. See IAllocator::alloc_batch.
+		@param i_count number of blocks to allocate
+		@param i_size size of every block in bytes
+		@param i_alignment alignment requested for every block. It must be an integer power of 2
+		@param i_alignment_offset offset from beginning of every block of the address that respects the alignment
+		@param o_blocks array of at least i_count pointers that receives the addresses of the blocks
+		@return number of blocks allocated. It is less than i_count only if the allocation fails.
+	*/
+	size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks );
+
+	/** allocates many memory blocks with the same size and alignment using the specified allocator.
+		The blocks are equivalent to blocks allocated by memo::alloc. See IAllocator::alloc_batch.
+		@param i_allocator allocator to use to perform the allocation. If MEMO_ONLY_DEFAULT_ALLOCATOR is true, this parameter is ignored.
+		@param i_count number of blocks to allocate
+		@param i_size size of every block in bytes
+		@param i_alignment alignment requested for every block. It must be an integer power of 2
+		@param i_alignment_offset offset from beginning of every block of the address that respects the alignment
+		@param o_blocks array of at least i_count pointers that receives the addresses of the blocks
+		@return number of blocks allocated. It is less than i_count only if the allocation fails.
+	*/
+	size_t alloc_batch( IAllocator & i_allocator, size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks );
+
+	/** deallocates many memory blocks allocated by memo::alloc, memo::realloc or memo::alloc_batch, using the allocators
+		that allocated them. Consecutive blocks allocated by the same allocator are freed with a single call to 
+		IAllocator::free_batch.
+		@param io_blocks array of the addresses of the blocks to free. None of them can be nullptr. The content of
+			the array is undefined after the call.
+		@param i_count number of blocks to free
+	*/
+	void free_batch( void * * io_blocks, size_t i_count );
+
 
 
 
@@ -196,6 +273,14 @@ namespace memo
 	*/
 	void unaligned_free( void * i_address );
 
+	/** deallocates a memory block allocated by memo::unaligned_alloc or memo::unaligned_realloc, using 
+		the allocator that allocated it. The size of the block is passed to the allocator (see 
+		IAllocator::unaligned_free), so that it may skip retrieving it.
+		@param i_address address of the memory block to free. It cannot be nullptr.
+		@param i_size size of the block, as requested to the last memo::unaligned_alloc or memo::unaligned_realloc performed on it
+	*/
+	void unaligned_free_sized( void * i_address, size_t i_size );
+
 	/** performs some checks on a new memory block allocated by memo::unaligned_alloc or memo::unaligned_realloc,
 		using the allocator that allocated it. The actual checks depend on the allocator and the 
 		configuration being compiled.
@@ -203,5 +288,21 @@ namespace memo
 	*/
 	void unaligned_dbg_check( void * i_address );
 
+	/** tries to resize a memory block allocated by memo::unaligned_alloc or memo::unaligned_realloc without moving it,
+		using the allocator that allocated it (see IAllocator::unaligned_try_expand). If the resize fails the block is left unchanged.
+		@param i_address address of the memory block to resize. It cannot be nullptr.
+		@param i_new_size new size of the block in bytes
+		@return true if the block has been resized, false otherwise
+	*/
+	bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+	/** retrieves the number of bytes that can be used in a memory block allocated by memo::unaligned_alloc or 
+		memo::unaligned_realloc, that may be greater than the requested size (see IAllocator::unaligned_usable_size).
+		Resizing the block up to this size with memo::unaligned_try_expand never fails.
+		@param i_address address of the memory block. It cannot be nullptr.
+		@return the usable size of the block, or 0 if the allocator that allocated it does not know it
+	*/
+	size_t unaligned_usable_size( void * i_address );
+
 } // namespace memo
 
@@ -0,0 +1,95 @@
+
+/* This source contains the allocation functions that are on the fast path of every allocation. If MEMO_ENABLE_INLINE
+	is non-zero they are expanded inline: together with MEMO_ENABLE_INLINE_TLS, memo::alloc reads the current allocator
+	of the thread and calls it without any other function call. */
+
+namespace memo
+{
+	// get_current_allocator
+	MEMO_INLINE IAllocator & get_current_allocator()
+	{
+		IAllocator * current_allocator = memo_externals::get_current_thread_allocator();
+
+		return *current_allocator;
+	}
+
+	// get_lifo_allocator
+	MEMO_INLINE ObjectStack & get_lifo_allocator()
+	{
+		ThreadRoot * thread_context = memo_externals::get_thread_root();
+		MEMO_ASSERT( thread_context != nullptr ); // create a memo::ThreadRoot object on the call stack of the thread procedure
+		return thread_context->lifo_allocator();
+	}
+
+	#if MEMO_ONLY_DEFAULT_ALLOCATOR
+
+		// alloc
+		MEMO_INLINE void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset );
+		}
+
+		// alloc
+		MEMO_INLINE void * alloc( IAllocator & /*i_allocator*/, size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset );
+		}
+
+		// free
+		MEMO_INLINE void free( void * i_address )
+		{
+			DefaultAllocator::s_free( i_address );
+		}
+
+	#else
+
+		// alloc
+		MEMO_INLINE void * alloc( IAllocator & i_allocator, size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			#if MEMO_ENABLE_PAGE_MAP
+				if( i_allocator.is_page_mapped() )
+					return i_allocator.alloc( i_size, i_alignment, i_alignment_offset ); // the owner is found by address
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>(
+				i_allocator.alloc( i_size + sizeof(_AllocationHeader), i_alignment, i_alignment_offset + sizeof(_AllocationHeader) ) );
+
+			if( header != nullptr )
+			{
+				header->m_allocator = &i_allocator;
+
+				return header + 1;
+			}
+			else
+				return nullptr;
+		}
+		
+		// alloc
+		MEMO_INLINE void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			IAllocator * current_allocator = memo_externals::get_current_thread_allocator();
+			return alloc( *current_allocator, i_size, i_alignment, i_alignment_offset );
+		}
+
+		// free
+		MEMO_INLINE void free( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr ); // free with null address is not allowed
+
+			#if MEMO_ENABLE_PAGE_MAP
+				IAllocator * page_owner = PageMap::find_allocator( i_address );
+				if( page_owner != nullptr )
+				{
+					page_owner->free( i_address );
+					return;
+				}
+			#endif
+
+			_AllocationHeader * header = static_cast<_AllocationHeader*>( i_address ) - 1;
+
+			header->m_allocator->free( header );
+		}
+
+	#endif
+
+} // namespace memo
@@ -178,11 +178,22 @@ namespace memo
 				m_allocator.unaligned_dbg_check( alloc.m_block );
 			alloc._check_mem( alloc.m_block, alloc.m_size );
 
-			// free the memory
+			// free the memory, half of the times passing the size
+			const bool sized = ( generate_rand_32() % 2 ) == 0;
 			if( aligned )
-				m_allocator.free( alloc.m_block );
+			{
+				if( sized )
+					m_allocator.free( alloc.m_block, alloc.m_size );
+				else
+					m_allocator.free( alloc.m_block );
+			}
 			else
-				m_allocator.unaligned_free( alloc.m_block );
+			{
+				if( sized )
+					m_allocator.unaligned_free( alloc.m_block, alloc.m_size );
+				else
+					m_allocator.unaligned_free( alloc.m_block );
+			}
 
 			// done
 			MEMO_ASSERT( m_allocated_memory >= alloc.m_size );
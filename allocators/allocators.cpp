@@ -1,8 +1,9 @@
 
 #if MEMO_ENABLE_TLSF
 
-	#include "..\external_sources\tlsf\tlsf.h"
-	#include "..\external_sources\tlsf\tlsf.c"
+	#define TLSF_FL_INDEX_MAX		MEMO_TLSF_FL_INDEX_MAX
+	#include "../external_sources/tlsf/tlsf.h"
+	#include "../external_sources/tlsf/tlsf.c"
 
 	namespace memo
 	{
@@ -47,6 +48,7 @@
 
 			// realloc
 			TlsfAlignmentHeader & old_header = *( static_cast<TlsfAlignmentHeader*>( i_address ) - 1 );
+			const size_t old_offset = address_diff( i_address, old_header.m_block );
 			const size_t extra_size = ( i_alignment >= sizeof( TlsfAlignmentHeader ) ? i_alignment : sizeof( TlsfAlignmentHeader ) );
 			const size_t new_actual_size = i_new_size + extra_size;
 			void * new_block = tlsf_realloc( i_tlsf, old_header.m_block, new_actual_size );
@@ -55,8 +57,12 @@
 				return nullptr;
 			}
 
-			// setup the header
+			// tlsf_realloc preserves the offset from the beginning of the block, so the content may need to be moved
 			void * aligned_address = lower_align( address_add( new_block, extra_size ), i_alignment, i_alignment_offset );
+			if( address_diff( aligned_address, new_block ) != old_offset )
+				memmove( aligned_address, address_add( new_block, old_offset ), i_new_size );
+
+			// setup the header
 			TlsfAlignmentHeader & new_header = *( static_cast<TlsfAlignmentHeader*>( aligned_address ) - 1 );
 			new_header.m_block = new_block;
 
@@ -64,6 +70,34 @@
 			return aligned_address;
 		}
 
+		// tlsf_aligned_try_expand
+		bool tlsf_aligned_try_expand( void * i_tlsf, void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			TlsfAlignmentHeader & header = *( static_cast<TlsfAlignmentHeader*>( i_address ) - 1 );
+			const size_t offset = address_diff( i_address, header.m_block );
+			return tlsf_try_expand( i_tlsf, header.m_block, i_new_size + offset ) != 0;
+		}
+
+		// tlsf_aligned_usable_size
+		size_t tlsf_aligned_usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			TlsfAlignmentHeader & header = *( static_cast<TlsfAlignmentHeader*>( i_address ) - 1 );
+			return tlsf_block_size( header.m_block ) - address_diff( i_address, header.m_block );
+		}
+
+		// tlsf_aligned_block - returns the tlsf block containing an aligned block
+		void * tlsf_aligned_block( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			TlsfAlignmentHeader & header = *( static_cast<TlsfAlignmentHeader*>( i_address ) - 1 );
+			return header.m_block;
+		}
+
 		// tlsf_aligned_free
 		void tlsf_aligned_free( void * i_tlsf, void * i_address )
 		{
@@ -77,11 +111,20 @@
 #endif
 
 #include "iallocator_config.cpp"
+#include "page_map.cpp"
 #include "default_allocator.cpp"
 #include "decorator_allocator.cpp"
 #include "debug_allocator.cpp"
 #include "statistics_allocator.cpp"
+#include "thread_cache_allocator.cpp"
 #include "region_allocator.cpp"
+#include "linear_allocator.cpp"
+#include "slab_allocator.cpp"
+#include "buddy_allocator.cpp"
+#include "shared_region_allocator.cpp"
 #include "tlsf_allocator.cpp"
+#include "tlsf_arena_allocator.cpp"
+#include "node_arena_allocator.cpp"
+#include "static_allocator.cpp"
 #include "allocator_tester.cpp"
 #include "corruption_detector_allocator.cpp"
\ No newline at end of file
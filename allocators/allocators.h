@@ -1,11 +1,20 @@
 
 
 #include "iallocator.h"
+#include "page_map.h"
 #include "default_allocator.h"
 #include "decorator_allocator.h"
 #include "debug_allocator.h"
 #include "statistics_allocator.h"
+#include "thread_cache_allocator.h"
 #include "region_allocator.h"
+#include "linear_allocator.h"
+#include "slab_allocator.h"
+#include "buddy_allocator.h"
+#include "shared_region_allocator.h"
 #include "tlsf_allocator.h"
+#include "tlsf_arena_allocator.h"
+#include "node_arena_allocator.h"
+#include "static_allocator.h"
 #include "allocator_tester.h"
 #include "corruption_detector_allocator.h"
\ No newline at end of file
@@ -0,0 +1,374 @@
+
+namespace memo
+{
+	/* Data about the blocks of an order */
+	struct BuddyAllocator::Order
+	{
+		size_t * m_free_bitmap; /**< a bit for every block of this order, set if the block is free */
+		size_t m_word_count; /**< number of words in m_free_bitmap */
+		size_t m_free_count; /**< number of bits set in m_free_bitmap */
+		size_t m_first_word; /**< no word before this index has bits set */
+	};
+
+	// BuddyAllocator::Config::configure_allocator
+	IAllocator * BuddyAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+	{
+		BuddyAllocator * allocator;
+		if( i_new_allocator != nullptr )
+			allocator = static_cast< BuddyAllocator * >( i_new_allocator );
+		else
+			allocator = MEMO_NEW( BuddyAllocator, *this );
+
+		RegionAllocator::Config::configure_allocator( allocator );
+
+		return allocator;
+	}
+
+	// BuddyAllocator::Config::try_recognize_property
+	bool BuddyAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( RegionAllocator::Config::try_recognize_property( i_config_reader ) )
+		{
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "min_block_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_min_block_size ) || m_min_block_size == 0 )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "max_block_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_max_block_size ) || m_max_block_size == 0 )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// BuddyAllocator::min_block_size_of - returns the minimum block size rounded up to a power of 2
+	size_t BuddyAllocator::min_block_size_of( const Config & i_config )
+	{
+		size_t min_block_size = MEMO_MIN_ALIGNMENT;
+		while( min_block_size < i_config.m_min_block_size )
+			min_block_size <<= 1;
+		return min_block_size;
+	}
+
+	// BuddyAllocator::max_block_size_of - returns the biggest power of 2 not exceeding neither the maximum block size nor the buffer size
+	size_t BuddyAllocator::max_block_size_of( const Config & i_config )
+	{
+		const size_t limit = std::min( i_config.m_max_block_size, i_config.m_buffer_size );
+		size_t max_block_size = min_block_size_of( i_config );
+		while( max_block_size <= limit / 2 )
+			max_block_size <<= 1;
+		return max_block_size;
+	}
+
+	// BuddyAllocator::constructor
+	BuddyAllocator::BuddyAllocator( const Config & i_config )
+		: RegionAllocator( i_config, max_block_size_of( i_config ), max_block_size_of( i_config ) ),
+		  m_min_block_size( min_block_size_of( i_config ) ), m_order_count( 1 ), m_root_count( 0 ),
+		  m_orders( nullptr ), m_block_orders( nullptr ), m_allocated_size( 0 )
+	{
+		const size_t max_block_size = max_block_size_of( i_config );
+		while( block_size( m_order_count - 1 ) < max_block_size )
+			m_order_count++;
+		if( buffer() != nullptr )
+			m_root_count = buffer_size() / max_block_size;
+
+		// the orders, the bitmaps and the orders of the allocated blocks are stored in the same buffer
+		const size_t min_block_count = m_root_count << ( m_order_count - 1 );
+		size_t word_count = 0;
+		for( size_t order = 0; order < m_order_count; order++ )
+			word_count += ( ( min_block_count >> order ) + s_bits_per_word - 1 ) / s_bits_per_word;
+		const size_t data_size = m_order_count * sizeof( Order ) + word_count * sizeof( size_t ) + min_block_count;
+		void * data = safe_get_default_allocator().unaligned_alloc( data_size );
+		if( data == nullptr )
+		{
+			m_root_count = 0;
+			return;
+		}
+		memset( data, 0, data_size );
+
+		m_orders = static_cast<Order *>( data );
+		size_t * words = static_cast<size_t *>( address_add( data, m_order_count * sizeof( Order ) ) );
+		for( size_t order = 0; order < m_order_count; order++ )
+		{
+			m_orders[ order ].m_free_bitmap = words;
+			m_orders[ order ].m_word_count = ( ( min_block_count >> order ) + s_bits_per_word - 1 ) / s_bits_per_word;
+			words += m_orders[ order ].m_word_count;
+		}
+		m_block_orders = reinterpret_cast<unsigned char *>( words );
+
+		for( size_t root_index = 0; root_index < m_root_count; root_index++ )
+			set_free( m_order_count - 1, root_index );
+	}
+
+	// BuddyAllocator::destructor
+	BuddyAllocator::~BuddyAllocator()
+	{
+		if( m_orders != nullptr )
+			safe_get_default_allocator().unaligned_free( m_orders );
+	}
+
+	// BuddyAllocator::is_free
+	bool BuddyAllocator::is_free( size_t i_order, size_t i_index ) const
+	{
+		const size_t * bitmap = m_orders[ i_order ].m_free_bitmap;
+		return ( bitmap[ i_index / s_bits_per_word ] & ( static_cast<size_t>( 1 ) << ( i_index % s_bits_per_word ) ) ) != 0;
+	}
+
+	// BuddyAllocator::set_free
+	void BuddyAllocator::set_free( size_t i_order, size_t i_index )
+	{
+		MEMO_ASSERT( !is_free( i_order, i_index ) );
+
+		Order & order = m_orders[ i_order ];
+		const size_t word = i_index / s_bits_per_word;
+		order.m_free_bitmap[ word ] |= static_cast<size_t>( 1 ) << ( i_index % s_bits_per_word );
+		order.m_free_count++;
+		order.m_first_word = std::min( order.m_first_word, word );
+	}
+
+	// BuddyAllocator::clear_free
+	void BuddyAllocator::clear_free( size_t i_order, size_t i_index )
+	{
+		MEMO_ASSERT( is_free( i_order, i_index ) );
+
+		Order & order = m_orders[ i_order ];
+		order.m_free_bitmap[ i_index / s_bits_per_word ] &= ~( static_cast<size_t>( 1 ) << ( i_index % s_bits_per_word ) );
+		order.m_free_count--;
+	}
+
+	// BuddyAllocator::find_free - returns the index of the first free block of an order. There must be at least one.
+	size_t BuddyAllocator::find_free( size_t i_order )
+	{
+		Order & order = m_orders[ i_order ];
+		MEMO_ASSERT( order.m_free_count > 0 );
+
+		while( order.m_free_bitmap[ order.m_first_word ] == 0 )
+			order.m_first_word++;
+
+		const size_t word = order.m_free_bitmap[ order.m_first_word ];
+		size_t bit = 0;
+		while( ( word & ( static_cast<size_t>( 1 ) << bit ) ) == 0 )
+			bit++;
+		return order.m_first_word * s_bits_per_word + bit;
+	}
+
+	// BuddyAllocator::find_block - finds the allocated block containing an address
+	void BuddyAllocator::find_block( const void * i_address, size_t * o_offset, size_t * o_order ) const
+	{
+		MEMO_ASSERT( i_address >= buffer() && address_diff( i_address, buffer() ) < m_root_count * max_block_size() );
+
+		// only one allocated block can start at the address lower-aligned to the size of the block
+		const size_t address_offset = address_diff( i_address, buffer() );
+		for( size_t order = 0; order < m_order_count; order++ )
+		{
+			const size_t offset = address_offset & ~( block_size( order ) - 1 );
+			if( m_block_orders[ offset / m_min_block_size ] == order + 1 )
+			{
+				*o_offset = offset;
+				*o_order = order;
+				return;
+			}
+		}
+
+		memo_externals::output_message( "BuddyAllocator: the address does not belong to an allocated block\n" );
+		memo_externals::debug_break();
+		*o_offset = 0;
+		*o_order = 0;
+	}
+
+	// BuddyAllocator::free_block - frees a block, merging it with its buddies
+	void BuddyAllocator::free_block( size_t i_offset, size_t i_order )
+	{
+		m_block_orders[ i_offset / m_min_block_size ] = 0;
+		m_allocated_size -= block_size( i_order );
+
+		size_t order = i_order;
+		size_t index = i_offset / block_size( i_order );
+		while( order + 1 < m_order_count && is_free( order, index ^ 1 ) )
+		{
+			clear_free( order, index ^ 1 );
+			index >>= 1;
+			order++;
+		}
+		set_free( order, index );
+	}
+
+	// BuddyAllocator::alloc
+	void * BuddyAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_alignment > 0 && is_integer_power_of_2( i_alignment ) );
+
+		// blocks are aligned to their size, so if the offset is a multiple of the alignment no extra space is needed
+		const size_t required_size = ( i_alignment_offset & ( i_alignment - 1 ) ) == 0 ?
+			std::max( i_size, i_alignment ) : i_size + i_alignment;
+		if( m_orders == nullptr || required_size < i_size || required_size > max_block_size() )
+			return nullptr;
+
+		size_t order = 0;
+		while( block_size( order ) < required_size )
+			order++;
+
+		size_t free_order = order;
+		while( free_order < m_order_count && m_orders[ free_order ].m_free_count == 0 )
+			free_order++;
+		if( free_order == m_order_count )
+			return nullptr;
+
+		// split the free block, until it has the requested order. The upper halves remain free.
+		size_t index = find_free( free_order );
+		clear_free( free_order, index );
+		while( free_order > order )
+		{
+			free_order--;
+			index <<= 1;
+			set_free( free_order, index + 1 );
+		}
+
+		const size_t offset = index * block_size( order );
+		m_block_orders[ offset / m_min_block_size ] = static_cast<unsigned char>( order + 1 );
+		m_allocated_size += block_size( order );
+
+		return upper_align( address_add( buffer(), offset ), i_alignment, i_alignment_offset );
+	}
+
+	// BuddyAllocator::realloc
+	void * BuddyAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( try_expand( i_address, i_new_size ) )
+			return i_address;
+
+		void * new_block = alloc( i_new_size, i_alignment, i_alignment_offset );
+		if( new_block == nullptr )
+			return nullptr;
+
+		memcpy( new_block, i_address, std::min( usable_size( i_address ), i_new_size ) );
+		free( i_address );
+		return new_block;
+	}
+
+	// BuddyAllocator::free
+	void BuddyAllocator::free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		size_t offset, order;
+		find_block( i_address, &offset, &order );
+		free_block( offset, order );
+	}
+
+	// BuddyAllocator::dbg_check
+	void BuddyAllocator::dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		size_t offset, order;
+		find_block( i_address, &offset, &order );
+		MEMO_ASSERT( !is_free( order, offset / block_size( order ) ) );
+	}
+
+	// BuddyAllocator::try_expand
+	bool BuddyAllocator::try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		size_t offset, order;
+		find_block( i_address, &offset, &order );
+		const size_t address_offset = address_diff( i_address, buffer() );
+		const size_t required_size = address_offset - offset + i_new_size;
+		if( required_size < i_new_size )
+			return false;
+
+		// the block can grow only if it's the lower buddy, and the upper buddy is free
+		size_t new_order = order;
+		size_t index = offset / block_size( order );
+		while( block_size( new_order ) < required_size )
+		{
+			if( new_order + 1 >= m_order_count || ( index & 1 ) != 0 || !is_free( new_order, index + 1 ) )
+				return false;
+			index >>= 1;
+			new_order++;
+		}
+
+		for( size_t merged_order = order; merged_order < new_order; merged_order++ )
+			clear_free( merged_order, ( offset / block_size( merged_order ) ) + 1 );
+
+		m_block_orders[ offset / m_min_block_size ] = static_cast<unsigned char>( new_order + 1 );
+		m_allocated_size += block_size( new_order ) - block_size( order );
+		return true;
+	}
+
+	// BuddyAllocator::usable_size
+	size_t BuddyAllocator::usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		size_t offset, order;
+		find_block( i_address, &offset, &order );
+		return offset + block_size( order ) - address_diff( i_address, buffer() );
+	}
+
+	// BuddyAllocator::unaligned_alloc
+	void * BuddyAllocator::unaligned_alloc( size_t i_size )
+	{
+		return alloc( i_size, MEMO_MIN_ALIGNMENT, 0 );
+	}
+
+	// BuddyAllocator::unaligned_realloc
+	void * BuddyAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+	{
+		return realloc( i_address, i_new_size, MEMO_MIN_ALIGNMENT, 0 );
+	}
+
+	// BuddyAllocator::unaligned_free
+	void BuddyAllocator::unaligned_free( void * i_address )
+	{
+		free( i_address );
+	}
+
+	// BuddyAllocator::unaligned_dbg_check
+	void BuddyAllocator::unaligned_dbg_check( void * i_address )
+	{
+		dbg_check( i_address );
+	}
+
+	// BuddyAllocator::unaligned_try_expand
+	bool BuddyAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		return try_expand( i_address, i_new_size );
+	}
+
+	// BuddyAllocator::unaligned_usable_size
+	size_t BuddyAllocator::unaligned_usable_size( void * i_address )
+	{
+		return usable_size( i_address );
+	}
+
+	// BuddyAllocator::dump_state
+	void BuddyAllocator::dump_state( StateWriter & i_state_writer )
+	{
+		i_state_writer.write( "type", "buddy" );
+
+		RegionAllocator::dump_state( i_state_writer );
+
+		i_state_writer.write_mem_size( "min_block_size", m_min_block_size );
+		i_state_writer.write_mem_size( "max_block_size", max_block_size() );
+		i_state_writer.write_uint( "root_blocks", m_root_count );
+		i_state_writer.write_mem_size( "allocated_size", m_allocated_size );
+
+		size_t free_block_count = 0;
+		for( size_t order = 0; order < m_order_count; order++ )
+			free_block_count += m_orders != nullptr ? m_orders[ order ].m_free_count : 0;
+		i_state_writer.write_uint( "free_blocks", free_block_count );
+	}
+
+} // namespace memo
@@ -0,0 +1,177 @@
+
+namespace memo
+{
+	/**	\class BuddyAllocator
+		Region allocator implementing the binary buddy system, suitable for big buffers whose size is a power of 2, like
+		the buffers used for I/O and compression. The buffer is split in root blocks of the maximum block size, and every
+		block can be split in two halves (buddies), down to the minimum block size. A request is served by the smallest
+		block not smaller than the request. When a block is freed, it is merged with its buddy if it is free too.
+		The buffer is aligned to the maximum block size, so every block is aligned to its size: a block whose size is a
+		power of 2 and whose alignment is not bigger than its size gets a block of exactly that size.
+		The state of the blocks is kept outside the managed memory: for every order there is a bitmap of the free blocks,
+		and for every minimum block a byte stores the order of the allocated block that starts there. So the allocator
+		never touches the memory of the blocks, and pages of free blocks reserved from the virtual memory are not committed.
+		The cost of an allocation is proportional to the number of words of the bitmaps to scan, while the cost of a
+		deallocation is proportional to the number of orders.
+		When there is no free block big enough for a request, the allocation fails. The allocator is not thread safe.
+
+		The following parameters are supported in the configuration file:
+		- size: inherited from RegionAllocator, is the size of the buffer. Only a multiple of the maximum block size is
+			used.
+		- min_block_size: size of the smallest block. It is rounded up to a power of 2. The default is 4 KB.
+		- max_block_size: size of the biggest block. It is rounded down to a power of 2, and it is lowered to the biggest
+			power of 2 not exceeding the size of the buffer. The default is 1 GB.
+		Since the buffer is aligned to the maximum block size, when the maximum block size is big the buffer should be
+		reserved from the virtual memory (see RegionAllocator). */
+	class BuddyAllocator : public RegionAllocator
+	{
+	public:
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name() { return "buddy_allocator"; }
+
+
+								///// configuration /////
+
+		/** Config structure for BuddyAllocator */
+		struct Config : public RegionAllocator::Config
+		{
+		public:
+
+			size_t m_min_block_size; /**< size of the smallest block */
+			size_t m_max_block_size; /**< size of the biggest block */
+
+			Config()
+				: m_min_block_size( 1024 * 4 ), m_max_block_size( 1024 * 1024 * 1024 ) { }
+
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+		};
+
+		/** Constructs the allocator, with all the root blocks free */
+		BuddyAllocator( const Config & i_config );
+
+		/** Destroys the allocator, freeing the bitmaps */
+		~BuddyAllocator();
+
+		/** Returns the size of the smallest block */
+		size_t min_block_size() const					{ return m_min_block_size; }
+
+		/** Returns the size of the biggest block */
+		size_t max_block_size() const					{ return m_min_block_size << ( m_order_count - 1 ); }
+
+
+								///// aligned allocations /////
+
+		/** allocates an aligned memory block. Implements IAllocator::alloc.
+		  @param i_size size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from the address that respects the alignment
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** deallocates a memory block allocated by alloc or realloc, merging it with its free buddies. Implements IAllocator::free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void free( void * i_address );
+
+		/** Implements IAllocator::dbg_check. Checks that the address belongs to an allocated block.
+		  @param i_address address of the memory block to check */
+		void dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			A block can grow merging the buddies that follow it, if they are free.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t usable_size( void * i_address );
+
+
+								///// unaligned allocations /////
+
+		/** allocates a new memory block. Implements IAllocator::unaligned_alloc.
+		  @param i_size size of the block in bytes
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * unaligned_alloc( size_t i_size );
+
+		/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+		/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void unaligned_free( void * i_address );
+
+		/** Implements IAllocator::unaligned_dbg_check. Checks that the address belongs to an allocated block.
+		  @param i_address address of the memory block to check */
+		void unaligned_dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+			Implements IAllocator::unaligned_try_expand. A block can grow merging the buddies that follow it, if they are free.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+			Implements IAllocator::unaligned_usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t unaligned_usable_size( void * i_address );
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer );
+
+	private:
+		BuddyAllocator( const BuddyAllocator & ); // not implemented
+		BuddyAllocator & operator = ( const BuddyAllocator & ); // not implemented
+
+		struct Order;
+
+		static const size_t s_bits_per_word = sizeof( size_t ) * 8;
+
+		static size_t min_block_size_of( const Config & i_config );
+		static size_t max_block_size_of( const Config & i_config );
+
+		size_t block_size( size_t i_order ) const		{ return m_min_block_size << i_order; }
+
+		bool is_free( size_t i_order, size_t i_index ) const;
+		void set_free( size_t i_order, size_t i_index );
+		void clear_free( size_t i_order, size_t i_index );
+		size_t find_free( size_t i_order );
+
+		void find_block( const void * i_address, size_t * o_offset, size_t * o_order ) const;
+		void free_block( size_t i_offset, size_t i_order );
+
+	private: // data members
+		size_t m_min_block_size;
+		size_t m_order_count; /**< number of block sizes, from the minimum to the maximum */
+		size_t m_root_count; /**< number of blocks of the maximum size in the buffer */
+		Order * m_orders; /**< bitmap of the free blocks, and other data for every order */
+		unsigned char * m_block_orders; /**< for every minimum block, zero or 1 + the order of the allocated block starting there */
+		size_t m_allocated_size; /**< total size of the allocated blocks */
+	};
+
+} // namespace memo
@@ -312,6 +312,19 @@ namespace memo
 		dest_allocator().free( block );
 	}
 
+	// DebugAllocator::free
+	void DebugAllocator::free( void * i_address, size_t i_size )
+	{
+		_do_sized_check( i_address, i_size );
+
+		void * const block = address_sub( i_address, m_heading_nomansland_size );
+		const size_t block_size = i_size + m_heading_nomansland_size + m_tailing_nomansland_size;
+
+		_fill_memory( m_deleted_memory_fill_mode, block, block_size );
+
+		dest_allocator().free( block, block_size );
+	}
+
 	// DebugAllocator::_do_check
 	size_t DebugAllocator::_do_check( void * i_address ) const
 	{
@@ -339,6 +352,24 @@ namespace memo
 		return size;
 	}
 
+	// DebugAllocator::_do_sized_check
+	void DebugAllocator::_do_sized_check( void * i_address, size_t i_size ) const
+	{
+		if( m_heading_nomansland_size >= sizeof( void * ) )
+		{
+			if( _do_check( i_address ) != i_size )
+			{
+				memo_externals::output_message( "the size passed to free does not match the size of the block\n" );
+				memo_externals::debug_break();
+			}
+		}
+		else
+		{
+			_do_check( i_address );
+			_check_nomansland( address_add( i_address, i_size ), m_tailing_nomansland_size, i_address );
+		}
+	}
+
 	// DebugAllocator::dbg_check
 	void DebugAllocator::dbg_check( void * i_address )
 	{
@@ -418,6 +449,19 @@ namespace memo
 		dest_allocator().unaligned_free( block );
 	}
 
+	// DebugAllocator::unaligned_free
+	void DebugAllocator::unaligned_free( void * i_address, size_t i_size )
+	{
+		_do_sized_check( i_address, i_size );
+
+		void * const block = address_sub( i_address, m_heading_nomansland_size );
+		const size_t block_size = i_size + m_heading_nomansland_size + m_tailing_nomansland_size;
+
+		_fill_memory( m_deleted_memory_fill_mode, block, block_size );
+
+		dest_allocator().unaligned_free( block, block_size );
+	}
+
 	// DebugAllocator::unaligned_dbg_check
 	void DebugAllocator::unaligned_dbg_check( void * i_address )
 	{
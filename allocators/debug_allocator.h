@@ -102,6 +102,13 @@ namespace memo
 		  @param i_address address of the memory block to free. It cannot be nullptr. */
 		void free( void * i_address );
 
+		/** deallocates a memory block allocated by alloc or realloc, whose size is known. Implements IAllocator::free.
+			The size is checked against the one stored in the block, and it allows to check the tailing no man's land
+			even if the heading no man's land is too small to store the size.
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block */
+		void free( void * i_address, size_t i_size );
+
 		/** Implements IAllocator::dbg_check. All the consistency checks are performed on the memory block.
 		  @param i_address address of the memory block to check */
 		void dbg_check( void * i_address );
@@ -129,6 +136,13 @@ namespace memo
 		  @param i_address address of the memory block to free. It cannot be nullptr. */
 		void unaligned_free( void * i_address );
 
+		/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc, whose size is known. Implements 
+			IAllocator::unaligned_free. The size is checked against the one stored in the block, and it allows to check 
+			the tailing no man's land even if the heading no man's land is too small to store the size.
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block */
+		void unaligned_free( void * i_address, size_t i_size );
+
 		/** This function performs some integrity check on the block. Implements IAllocator::unaligned_dbg_check.
 		  The dest allocator is used to perform the operation. See DecoratorAllocator.
 		  @param i_address address of the memory block to check */
@@ -158,12 +172,15 @@ namespace memo
 		
 	private: // internal services
 
+		friend struct DebugPolicy; // DebugPolicy shares the implementation of the no man's lands
+
 		/** Assigns the configuration struct */
 		void set_config( const Config & i_config );
 		
 		static void * _invert_address( void * i_address );
 
 		size_t _do_check( void * i_address ) const; // returns the size of the block
+		void _do_sized_check( void * i_address, size_t i_size ) const;
 		
 		static void _fill_memory( FillMode i_mode, void * i_start_address, size_t i_size );
 		static void _check_memory( FillMode i_mode, const void * i_start_address, size_t i_size );
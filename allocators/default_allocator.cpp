@@ -52,14 +52,20 @@ namespace memo
 
 		// realloc
 		AlignmentHeader & old_header = *( static_cast<AlignmentHeader*>( i_address ) - 1 );
+		const size_t old_offset = address_diff( i_address, old_header.m_block );
 		const size_t extra_size = ( i_alignment >= sizeof( AlignmentHeader ) ? i_alignment : sizeof( AlignmentHeader ) );
 		const size_t new_actual_size = i_new_size + extra_size;
 		void * new_block = ::realloc( old_header.m_block, new_actual_size );
 		if( new_block == nullptr )
 			return nullptr;
 
-		// setup the header
+		/* the new block may have a different misalignment, so the user content may need to 
+			be moved (::realloc preserves the offset from the beginning of the block) */
 		void * aligned_address = lower_align( address_add( new_block, extra_size ), i_alignment, i_alignment_offset );
+		if( address_diff( aligned_address, new_block ) != old_offset )
+			memmove( aligned_address, address_add( new_block, old_offset ), i_new_size );
+
+		// setup the header
 		AlignmentHeader & new_header = *( static_cast<AlignmentHeader*>( aligned_address ) - 1 );
 		new_header.m_block = new_block;
 
@@ -67,6 +73,39 @@ namespace memo
 		return aligned_address;
 	}
 
+	// DefaultAllocator::s_usable_size
+	size_t DefaultAllocator::s_usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		AlignmentHeader & header = *( static_cast<AlignmentHeader*>( i_address ) - 1 );
+		return s_unaligned_usable_size( header.m_block ) - address_diff( i_address, header.m_block );
+	}
+
+	// DefaultAllocator::s_try_expand
+	bool DefaultAllocator::s_try_expand( void * i_address, size_t i_new_size )
+	{
+		return i_new_size <= s_usable_size( i_address );
+	}
+
+	// DefaultAllocator::s_unaligned_usable_size
+	size_t DefaultAllocator::s_unaligned_usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		#ifdef _MSC_VER
+			return ::_msize( i_address );
+		#else
+			return ::malloc_usable_size( i_address );
+		#endif
+	}
+
+	// DefaultAllocator::s_unaligned_try_expand
+	bool DefaultAllocator::s_unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		return i_new_size <= s_unaligned_usable_size( i_address );
+	}
+
 	// DefaultAllocator::dump_state
 	void DefaultAllocator::dump_state( StateWriter & i_state_writer )
 	{
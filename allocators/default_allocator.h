@@ -77,6 +77,23 @@ namespace memo
 		void dbg_check( void * i_address )
 			{ s_dbg_check( i_address ); }
 
+		/** \brief tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			The resize succeeds if the new size fits in the block actually allocated by ::malloc.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise
+		*/
+		bool try_expand( void * i_address, size_t i_new_size )
+			{ return s_try_expand( i_address, i_new_size ); }
+
+		/** \brief retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+			The size is queried to the C runtime (malloc_usable_size or _msize).
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block
+		*/
+		size_t usable_size( void * i_address )
+			{ return s_usable_size( i_address ); }
+
 
 
 
@@ -112,6 +129,24 @@ namespace memo
 		void unaligned_dbg_check( void * i_address )
 			{ s_unaligned_dbg_check( i_address ); }
 
+		/** \brief tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it. 
+			Implements IAllocator::unaligned_try_expand. The resize succeeds if the new size fits in the block actually
+			allocated by ::malloc.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise
+		*/
+		bool unaligned_try_expand( void * i_address, size_t i_new_size )
+			{ return s_unaligned_try_expand( i_address, i_new_size ); }
+
+		/** \brief retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc. 
+			Implements IAllocator::unaligned_usable_size. The size is queried to the C runtime (malloc_usable_size or _msize).
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block
+		*/
+		size_t unaligned_usable_size( void * i_address )
+			{ return s_unaligned_usable_size( i_address ); }
+
 		
 		/** Writes out in a human readable way the state of the allocator */
 		void dump_state( StateWriter & i_state_writer );
@@ -123,11 +158,15 @@ namespace memo
 		static void * s_realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
 		static void s_free( void * i_address );
 		static void s_dbg_check( void * i_address );
+		static bool s_try_expand( void * i_address, size_t i_new_size );
+		static size_t s_usable_size( void * i_address );
 
 		static void * s_unaligned_alloc( size_t i_size );
 		static void * s_unaligned_realloc( void * i_address, size_t i_new_size );
 		static void s_unaligned_free( void * i_address );
 		static void s_unaligned_dbg_check( void * i_address );
+		static bool s_unaligned_try_expand( void * i_address, size_t i_new_size );
+		static size_t s_unaligned_usable_size( void * i_address );
 
 	private:
 		struct AlignmentHeader;
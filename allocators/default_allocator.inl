@@ -20,7 +20,7 @@ namespace memo
 	{
 		if( _g_default_allocator == nullptr )
 		{
-			_g_default_allocator = new( DefaultAllocator::s_unaligned_alloc( sizeof( _g_default_allocator ) ) ) DefaultAllocator();
+			_g_default_allocator = new( DefaultAllocator::s_unaligned_alloc( sizeof( DefaultAllocator ) ) ) DefaultAllocator();
 		}
 		return *_g_default_allocator;
 	}
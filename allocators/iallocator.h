@@ -94,11 +94,35 @@ namespace memo
 		  @param i_address address of the memory block to free. It cannot be nullptr. */
 		virtual void free( void * i_address ) = 0;
 
+		/** Deallocates a memory block allocated by alloc or realloc, whose size is known by the caller. Allocators that 
+			keep the size of the blocks can override this function to avoid retrieving it. The default implementation 
+			just calls free( i_address ).
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block, as requested to the last alloc or realloc performed on it */
+		virtual void free( void * i_address, size_t i_size )
+			{ MEMO_UNUSED( i_size ); free( i_address ); }
+
 		/** Performs some checks on a new memory block allocated by alloc or realloc. The actual checks depend on the
 			allocator and the configuration being compiled.
 		  @param i_address address of the memory block to check */
 		virtual void dbg_check( void * i_address ) = 0;
 
+		/** Tries to change the size of a memory block allocated by alloc or realloc, without moving it. The alignment 
+			offset of the block must not be greater than the new size. The default implementation always fails.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false if it has been left unchanged */
+		virtual bool try_expand( void * i_address, size_t i_new_size )
+			{ MEMO_UNUSED( i_address ); MEMO_UNUSED( i_new_size ); return false; }
+
+		/** Retrieves the number of bytes that can be used in a memory block allocated by alloc or realloc, that may be 
+			more than the size requested. To use the slack, the block must be resized with try_expand, that never fails
+			up to this size. The default implementation returns zero.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block, or zero if the allocator can't tell it */
+		virtual size_t usable_size( void * i_address )
+			{ MEMO_UNUSED( i_address ); return 0; }
+
 
 
 
@@ -130,11 +154,73 @@ namespace memo
 		  @param i_address address of the memory block to free. It cannot be nullptr. */
 		virtual void unaligned_free( void * i_address ) = 0;
 
+		/** Deallocates a memory block allocated by unaligned_alloc or unaligned_realloc, whose size is known by the 
+			caller. Allocators that keep the size of the blocks can override this function to avoid retrieving it.
+			The default implementation just calls unaligned_free( i_address ).
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block, as requested to the last unaligned_alloc or unaligned_realloc performed on it */
+		virtual void unaligned_free( void * i_address, size_t i_size )
+			{ MEMO_UNUSED( i_size ); unaligned_free( i_address ); }
+
 		/** Performs some checks on a new memory block allocated by unaligned_alloc or unaligned_realloc. The actual checks
 			depend on the allocator and the configuration being compiled.
 		  @param i_address address of the memory block to check */
 		virtual void unaligned_dbg_check( void * i_address ) = 0;
 
+		/** Tries to change the size of a memory block allocated by unaligned_alloc or unaligned_realloc, without moving
+			it. The default implementation always fails.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false if it has been left unchanged */
+		virtual bool unaligned_try_expand( void * i_address, size_t i_new_size )
+			{ MEMO_UNUSED( i_address ); MEMO_UNUSED( i_new_size ); return false; }
+
+		/** Retrieves the number of bytes that can be used in a memory block allocated by unaligned_alloc or 
+			unaligned_realloc, that may be more than the size requested. To use the slack, the block must be resized with 
+			unaligned_try_expand, that never fails up to this size. The default implementation returns zero.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block, or zero if the allocator can't tell it */
+		virtual size_t unaligned_usable_size( void * i_address )
+			{ MEMO_UNUSED( i_address ); return 0; }
+
+
+
+
+					///// batch allocations /////
+
+		/** Allocates many memory blocks with the same size and alignment. The blocks are equivalent to blocks allocated
+			by alloc, so they can be reallocated with realloc and freed with free or free_batch. The default implementation
+			calls alloc for every block. Allocators can override this function to avoid doing once per block work that can
+			be done once per batch, like locking a mutex.
+		  @param i_count number of blocks to allocate
+		  @param i_size size of every block in bytes
+		  @param i_alignment alignment requested for every block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of every block of the address that respects the alignment
+		  @param o_blocks array of at least i_count pointers that receives the addresses of the blocks
+		  @return number of blocks allocated. If it is less than i_count the allocator has run out of memory, and only
+			the first elements of o_blocks are assigned. */
+		virtual size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+			{
+				o_blocks[ index ] = alloc( i_size, i_alignment, i_alignment_offset );
+				if( o_blocks[ index ] == nullptr )
+					return index;
+			}
+			return i_count;
+		}
+
+		/** Deallocates many memory blocks allocated by alloc, realloc or alloc_batch. The default implementation calls 
+			free for every block. 
+		  @param io_blocks array of the addresses of the blocks to free. None of them can be nullptr. The implementation
+			may use the array as temporary storage, so its content is undefined after the call.
+		  @param i_count number of blocks to free */
+		virtual void free_batch( void * * io_blocks, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				free( io_blocks[ index ] );
+		}
+
 		/** virtual destructor */
 		virtual ~IAllocator() { }
 
@@ -165,6 +251,30 @@ namespace memo
 				@param i_write_function Function to call for every property
 				@param i_user_param user parameter to be passed to i_write_function */
 		virtual void dump_state( StateWriter & i_state_writer ) = 0;
+
+		#if MEMO_ENABLE_PAGE_MAP
+
+				//// Page Map ////
+
+			/** Registers the memory owned by the allocator in the page map (see PageMap), so that memo::free and memo::realloc
+				can find the allocator from the address of a block, and memo::alloc can omit the allocation header. Only
+				allocators that own their memory (like region allocators) can be registered, so the default implementation
+				does nothing and returns false. The memory manager calls this function on the allocators of the contexts.
+				An allocator registered in the page map must not be used as target of another allocator.
+			  @return true if the allocator is registered in the page map */
+			virtual bool register_in_page_map() { return false; }
+
+			/** Returns whether the allocator is registered in the page map. If so, memo::alloc and memo::unaligned_alloc
+				don't add the allocation header to the blocks. */
+			bool is_page_mapped() const { return m_page_mapped; }
+
+		protected:
+
+			IAllocator() : m_page_mapped( false ) { }
+
+			bool m_page_mapped; /**< to be set by the implementations of register_in_page_map */
+
+		#endif
 	};
 
 } // namespace memo
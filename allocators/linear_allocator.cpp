@@ -0,0 +1,176 @@
+
+namespace memo
+{
+	// LinearAllocator::Config::configure_allocator
+	IAllocator * LinearAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+	{
+		LinearAllocator * allocator;
+		if( i_new_allocator != nullptr )
+			allocator = static_cast< LinearAllocator * >( i_new_allocator );
+		else
+			allocator = MEMO_NEW( LinearAllocator, *this );
+
+		RegionAllocator::Config::configure_allocator( allocator );
+
+		return allocator;
+	}
+
+	// LinearAllocator::constructor
+	LinearAllocator::LinearAllocator( const Config & i_config )
+		: RegionAllocator( i_config, sizeof( Header ) ), m_curr_offset( 0 ), m_peak_offset( 0 )
+	{
+	}
+
+	// LinearAllocator::rewind_to
+	void LinearAllocator::rewind_to( Mark i_mark )
+	{
+		MEMO_ASSERT( i_mark <= m_curr_offset );
+		m_curr_offset = i_mark;
+	}
+
+	// LinearAllocator::is_last_block - returns whether the block ends at the current position
+	bool LinearAllocator::is_last_block( const void * i_address ) const
+	{
+		const Header & header = get_header( i_address );
+		return address_add( i_address, header.m_size ) == address_add( buffer(), m_curr_offset );
+	}
+
+	// LinearAllocator::alloc
+	void * LinearAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_alignment > 0 && is_integer_power_of_2( i_alignment ) );
+
+		// blocks are always aligned at least to MEMO_MIN_ALIGNMENT
+		const size_t alignment = std::max( i_alignment, static_cast<size_t>( MEMO_MIN_ALIGNMENT ) );
+		void * const curr = address_add( buffer(), m_curr_offset );
+
+		/* the header is placed at the aligned address preceding the block (see get_header), so with any alignment
+			offset it can't start before curr */
+		void * const header_start = upper_align( curr, MEMO_ALIGNMENT_OF( Header ) );
+		void * const block = upper_align( address_add( header_start, sizeof( Header ) ), alignment, i_alignment_offset );
+		const size_t new_offset = address_diff( block, buffer() ) + i_size;
+		if( new_offset > buffer_size() || new_offset < m_curr_offset )
+			return nullptr;
+
+		get_header( block ).m_size = i_size;
+		m_curr_offset = new_offset;
+		m_peak_offset = std::max( m_peak_offset, new_offset );
+		return block;
+	}
+
+	// LinearAllocator::realloc
+	void * LinearAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_aligned( address_add( i_address, i_alignment_offset ), i_alignment ) && try_expand( i_address, i_new_size ) )
+			return i_address;
+
+		void * new_block = alloc( i_new_size, i_alignment, i_alignment_offset );
+		if( new_block == nullptr )
+			return nullptr;
+
+		memcpy( new_block, i_address, std::min( get_header( i_address ).m_size, i_new_size ) );
+		return new_block;
+	}
+
+	// LinearAllocator::free
+	void LinearAllocator::free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+		MEMO_UNUSED( i_address );
+	}
+
+	// LinearAllocator::dbg_check
+	void LinearAllocator::dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+		MEMO_ASSERT( address_diff( i_address, buffer() ) >= sizeof( Header ) );
+		MEMO_ASSERT( address_diff( i_address, buffer() ) + get_header( i_address ).m_size <= m_curr_offset );
+		MEMO_UNUSED( i_address );
+	}
+
+	// LinearAllocator::try_expand
+	bool LinearAllocator::try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header & header = get_header( i_address );
+		if( i_new_size <= header.m_size )
+		{
+			// shrinking always succeeds, but only the last block gives back its space
+			if( is_last_block( i_address ) )
+				m_curr_offset -= header.m_size - i_new_size;
+			header.m_size = i_new_size;
+			return true;
+		}
+
+		if( !is_last_block( i_address ) )
+			return false;
+
+		const size_t new_offset = address_diff( i_address, buffer() ) + i_new_size;
+		if( new_offset > buffer_size() || new_offset < m_curr_offset )
+			return false;
+
+		header.m_size = i_new_size;
+		m_curr_offset = new_offset;
+		m_peak_offset = std::max( m_peak_offset, new_offset );
+		return true;
+	}
+
+	// LinearAllocator::usable_size
+	size_t LinearAllocator::usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		return get_header( i_address ).m_size;
+	}
+
+	// LinearAllocator::unaligned_alloc
+	void * LinearAllocator::unaligned_alloc( size_t i_size )
+	{
+		return alloc( i_size, MEMO_MIN_ALIGNMENT, 0 );
+	}
+
+	// LinearAllocator::unaligned_realloc
+	void * LinearAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+	{
+		return realloc( i_address, i_new_size, MEMO_MIN_ALIGNMENT, 0 );
+	}
+
+	// LinearAllocator::unaligned_free
+	void LinearAllocator::unaligned_free( void * i_address )
+	{
+		free( i_address );
+	}
+
+	// LinearAllocator::unaligned_dbg_check
+	void LinearAllocator::unaligned_dbg_check( void * i_address )
+	{
+		dbg_check( i_address );
+	}
+
+	// LinearAllocator::unaligned_try_expand
+	bool LinearAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		return try_expand( i_address, i_new_size );
+	}
+
+	// LinearAllocator::unaligned_usable_size
+	size_t LinearAllocator::unaligned_usable_size( void * i_address )
+	{
+		return usable_size( i_address );
+	}
+
+	// LinearAllocator::dump_state
+	void LinearAllocator::dump_state( StateWriter & i_state_writer )
+	{
+		i_state_writer.write( "type", "linear" );
+
+		RegionAllocator::dump_state( i_state_writer );
+
+		i_state_writer.write_mem_size( "used_size", m_curr_offset );
+		i_state_writer.write_mem_size( "peak_size", m_peak_offset );
+	}
+
+} // namespace memo
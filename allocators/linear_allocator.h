@@ -0,0 +1,159 @@
+
+namespace memo
+{
+	/**	\class LinearAllocator
+		Region allocator that allocates blocks incrementing a pointer inside its buffer (bump-pointer allocation).
+		Freeing a block does nothing: the memory is reclaimed all at once by reset, or back to a position saved with
+		mark by rewind_to. It is suitable for contexts whose objects all die at the same time, for example the objects
+		allocated to serve a request or to compute a frame.
+		Only the last allocated block can be resized in-place. A size_t is added as overhead to every memory block, to
+		support realloc and usable_size. When the buffer is exhausted, allocations fail.
+		The allocator is not thread safe.
+
+		The following parameters are supported in the configuration file:
+		- size: inherited from RegionAllocator, is the size of the buffer. */
+	class LinearAllocator : public RegionAllocator
+	{
+	public:
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name() { return "linear_allocator"; }
+
+
+								///// configuration /////
+
+		/** Config structure for LinearAllocator */
+		struct Config : public RegionAllocator::Config
+		{
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+		};
+
+		/** Constructs the allocator, with the whole buffer free */
+		LinearAllocator( const Config & i_config );
+
+
+								///// reset and rewind /////
+
+		/** Position in the buffer, returned by mark */
+		typedef size_t Mark;
+
+		/** Returns the current position in the buffer. The blocks allocated after this call can be freed by rewind_to. */
+		Mark mark() const								{ return m_curr_offset; }
+
+		/** Frees all the blocks allocated after the call to mark that returned i_mark. Any block allocated after
+			the mark must not be used anymore. Marks must be used in LIFO order.
+			@param i_mark a position returned by mark. It can't be after the current position. */
+		void rewind_to( Mark i_mark );
+
+		/** Frees all the blocks. Any block allocated by this allocator must not be used anymore. */
+		void reset()									{ rewind_to( 0 ); }
+
+		/** Returns the number of bytes used in the buffer, including the headers and the alignment padding */
+		size_t used_size() const						{ return m_curr_offset; }
+
+
+								///// aligned allocations /////
+
+		/** allocates an aligned memory block, incrementing the current position. Implements IAllocator::alloc.
+		  @param i_size size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+			The last allocated block is resized in-place, while any other block is copied in a new block.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from the address that respects the alignment
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** Does nothing: the memory is reclaimed by reset or rewind_to. Implements IAllocator::free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void free( void * i_address );
+
+		/** Implements IAllocator::dbg_check. Checks that the block is inside the used part of the buffer.
+		  @param i_address address of the memory block to check */
+		void dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			Only the last allocated block can be resized.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t usable_size( void * i_address );
+
+
+								///// unaligned allocations /////
+
+		/** allocates a new memory block, incrementing the current position. Implements IAllocator::unaligned_alloc.
+		  @param i_size size of the block in bytes
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * unaligned_alloc( size_t i_size );
+
+		/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+			The last allocated block is resized in-place, while any other block is copied in a new block.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+		/** Does nothing: the memory is reclaimed by reset or rewind_to. Implements IAllocator::unaligned_free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void unaligned_free( void * i_address );
+
+		/** Implements IAllocator::unaligned_dbg_check. Checks that the block is inside the used part of the buffer.
+		  @param i_address address of the memory block to check */
+		void unaligned_dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+			Implements IAllocator::unaligned_try_expand. Only the last allocated block can be resized.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+			Implements IAllocator::unaligned_usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t unaligned_usable_size( void * i_address );
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer );
+
+	private:
+		LinearAllocator( const LinearAllocator & ); // not implemented
+		LinearAllocator & operator = ( const LinearAllocator & ); // not implemented
+
+		/** Header preceding every block. It is aligned, so there may be some padding between it and the block. */
+		struct Header
+		{
+			size_t m_size; /**< size of the block, as requested */
+		};
+
+		static Header & get_header( void * i_address )
+			{ return *static_cast<Header *>( lower_align( address_sub( i_address, sizeof( Header ) ), MEMO_ALIGNMENT_OF( Header ) ) ); }
+
+		static const Header & get_header( const void * i_address )
+			{ return *static_cast<const Header *>( lower_align( address_sub( i_address, sizeof( Header ) ), MEMO_ALIGNMENT_OF( Header ) ) ); }
+
+		bool is_last_block( const void * i_address ) const;
+
+	private: // data members
+		size_t m_curr_offset; /**< offset of the first free byte of the buffer */
+		size_t m_peak_offset; /**< maximum value of m_curr_offset */
+	};
+
+} // namespace memo
@@ -0,0 +1,316 @@
+
+#if MEMO_ENABLE_TLSF && MEMO_ENABLE_NUMA
+
+	namespace memo
+	{
+		// Header preceding every block
+		struct NodeArenaAllocator::Header
+		{
+			Arena * m_arena;
+		};
+
+		// Arena of a node. Arenas are allocated with the default allocator.
+		struct NodeArenaAllocator::Arena
+		{
+			memo_externals::Mutex m_mutex; /**< protects m_tlsf */
+			TlsfAllocator m_tlsf;
+
+			Arena( const TlsfAllocator::Config & i_config )
+				: m_tlsf( i_config ) { }
+		};
+
+		// NodeArenaAllocator::Config::configure_allocator
+		IAllocator * NodeArenaAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+		{
+			NodeArenaAllocator * allocator;
+			if( i_new_allocator != nullptr )
+				allocator = static_cast< NodeArenaAllocator * >( i_new_allocator );
+			else
+				allocator = MEMO_NEW( NodeArenaAllocator, *this );
+
+			IAllocator::Config::configure_allocator( allocator );
+
+			return allocator;
+		}
+
+		// NodeArenaAllocator::Config::try_recognize_property
+		bool NodeArenaAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+		{
+			if( i_config_reader.try_recognize_property( "arena_size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_arena_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "growth" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_growth_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "max_size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "huge_pages" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strcmp( value, "true" ) == 0 )
+					m_huge_pages = true;
+				else if( strcmp( value, "false" ) == 0 )
+					m_huge_pages = false;
+				else
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// NodeArenaAllocator::constructor
+		NodeArenaAllocator::NodeArenaAllocator( const Config & i_config )
+			: m_arenas( nullptr ), m_arena_count( 0 )
+		{
+			TlsfAllocator::Config arena_config;
+			arena_config.m_buffer_size = i_config.m_arena_size;
+			arena_config.m_growth_size = i_config.m_growth_size;
+			arena_config.m_max_size = i_config.m_max_size;
+			arena_config.m_virtual_memory = true;
+			arena_config.m_huge_pages = i_config.m_huge_pages;
+
+			DefaultAllocator & default_allocator = safe_get_default_allocator();
+			const size_t node_count = memo_externals::numa_node_count();
+			m_arenas = static_cast<Arena * *>( default_allocator.unaligned_alloc( node_count * sizeof( Arena * ) ) );
+			if( m_arenas == nullptr )
+			{
+				memo_externals::output_message( "NodeArenaAllocator: allocation of the arenas failed\n" );
+				memo_externals::debug_break();
+				return;
+			}
+
+			// with a single node binding the regions would be useless
+			for( size_t node = 0; node < node_count; node++ )
+			{
+				arena_config.m_numa_node = node_count > 1 ? node : RegionAllocator::s_no_numa_node;
+				m_arenas[ node ] = MEMO_NEW_ALLOC( default_allocator, Arena, arena_config );
+			}
+			m_arena_count = node_count;
+		}
+
+		// NodeArenaAllocator::destructor
+		NodeArenaAllocator::~NodeArenaAllocator()
+		{
+			DefaultAllocator & default_allocator = safe_get_default_allocator();
+			for( size_t node = 0; node < m_arena_count; node++ )
+				MEMO_DELETE_ALLOC( default_allocator, m_arenas[ node ] );
+			if( m_arenas != nullptr )
+				default_allocator.unaligned_free( m_arenas );
+		}
+
+		// NodeArenaAllocator::arena_alloc
+		void * NodeArenaAllocator::arena_alloc( Arena & i_arena, size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			Header * header;
+			{
+				MutexLock lock( i_arena.m_mutex );
+				header = static_cast<Header *>( i_aligned
+					? i_arena.m_tlsf.alloc( i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) )
+					: i_arena.m_tlsf.unaligned_alloc( i_size + sizeof( Header ) ) );
+			}
+			if( header == nullptr )
+				return nullptr;
+
+			header->m_arena = &i_arena;
+			return header + 1;
+		}
+
+		/* NodeArenaAllocator::alloc_block - allocates in the arena of the current node, and then in the arenas of the
+			other nodes, starting from the next one */
+		void * NodeArenaAllocator::alloc_block( size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			if( m_arena_count == 0 )
+				return nullptr;
+
+			const size_t current_node = m_arena_count > 1 ? memo_externals::numa_current_node() : 0;
+			for( size_t index = 0; index < m_arena_count; index++ )
+			{
+				Arena & arena = *m_arenas[ ( current_node + index ) % m_arena_count ];
+				void * block = arena_alloc( arena, i_size, i_alignment, i_alignment_offset, i_aligned );
+				if( block != nullptr )
+					return block;
+			}
+			return nullptr;
+		}
+
+		// NodeArenaAllocator::realloc_block - reallocates in the arena of the block, or moves the block
+		void * NodeArenaAllocator::realloc_block( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena & arena = *header->m_arena;
+			size_t old_size;
+			{
+				MutexLock lock( arena.m_mutex );
+				Header * new_header = static_cast<Header *>( i_aligned
+					? arena.m_tlsf.realloc( header, i_new_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) )
+					: arena.m_tlsf.unaligned_realloc( header, i_new_size + sizeof( Header ) ) );
+				if( new_header != nullptr )
+					return new_header + 1;
+
+				/* the size word of the tlsf block is rewritten when the previous block is allocated or freed, so it 
+					is read under the mutex */
+				old_size = ( i_aligned ? arena.m_tlsf.usable_size( header ) : arena.m_tlsf.unaligned_usable_size( header ) ) - sizeof( Header );
+			}
+
+			// the arena is full: the block is moved to another arena
+			void * new_block = alloc_block( i_new_size, i_alignment, i_alignment_offset, i_aligned );
+			if( new_block == nullptr )
+				return nullptr;
+
+			memcpy( new_block, i_address, std::min( old_size, i_new_size ) );
+			free_block( i_address, i_aligned );
+			return new_block;
+		}
+
+		// NodeArenaAllocator::free_block
+		void NodeArenaAllocator::free_block( void * i_address, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena & arena = *header->m_arena;
+			MutexLock lock( arena.m_mutex );
+			if( i_aligned )
+				arena.m_tlsf.free( header );
+			else
+				arena.m_tlsf.unaligned_free( header );
+		}
+
+		// NodeArenaAllocator::try_expand_block
+		bool NodeArenaAllocator::try_expand_block( void * i_address, size_t i_new_size, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena & arena = *header->m_arena;
+			MutexLock lock( arena.m_mutex );
+			return i_aligned ? arena.m_tlsf.try_expand( header, i_new_size + sizeof( Header ) )
+				: arena.m_tlsf.unaligned_try_expand( header, i_new_size + sizeof( Header ) );
+		}
+
+		// NodeArenaAllocator::alloc
+		void * NodeArenaAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return alloc_block( i_size, i_alignment, i_alignment_offset, true );
+		}
+
+		// NodeArenaAllocator::realloc
+		void * NodeArenaAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return realloc_block( i_address, i_new_size, i_alignment, i_alignment_offset, true );
+		}
+
+		// NodeArenaAllocator::free
+		void NodeArenaAllocator::free( void * i_address )
+		{
+			free_block( i_address, true );
+		}
+
+		// NodeArenaAllocator::dbg_check
+		void NodeArenaAllocator::dbg_check( void * i_address )
+		{
+			MEMO_UNUSED( i_address );
+			MEMO_ASSERT( i_address != nullptr );
+
+			#if MEMO_ENABLE_ASSERT
+				Header * header = static_cast<Header *>( i_address ) - 1;
+				bool found = false;
+				for( size_t node = 0; node < m_arena_count; node++ )
+					found = found || m_arenas[ node ] == header->m_arena;
+				MEMO_ASSERT( found ); // the block does not belong to this allocator
+			#endif
+		}
+
+		// NodeArenaAllocator::try_expand
+		bool NodeArenaAllocator::try_expand( void * i_address, size_t i_new_size )
+		{
+			return try_expand_block( i_address, i_new_size, true );
+		}
+
+		// NodeArenaAllocator::usable_size
+		size_t NodeArenaAllocator::usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			// the size word of the tlsf block is shared with the flags of the previous block, so the mutex is needed
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena & arena = *header->m_arena;
+			MutexLock lock( arena.m_mutex );
+			return arena.m_tlsf.usable_size( header ) - sizeof( Header );
+		}
+
+		// NodeArenaAllocator::unaligned_alloc
+		void * NodeArenaAllocator::unaligned_alloc( size_t i_size )
+		{
+			return alloc_block( i_size, 0, 0, false );
+		}
+
+		// NodeArenaAllocator::unaligned_realloc
+		void * NodeArenaAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+		{
+			return realloc_block( i_address, i_new_size, 0, 0, false );
+		}
+
+		// NodeArenaAllocator::unaligned_free
+		void NodeArenaAllocator::unaligned_free( void * i_address )
+		{
+			free_block( i_address, false );
+		}
+
+		// NodeArenaAllocator::unaligned_dbg_check
+		void NodeArenaAllocator::unaligned_dbg_check( void * i_address )
+		{
+			dbg_check( i_address );
+		}
+
+		// NodeArenaAllocator::unaligned_try_expand
+		bool NodeArenaAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+		{
+			return try_expand_block( i_address, i_new_size, false );
+		}
+
+		// NodeArenaAllocator::unaligned_usable_size
+		size_t NodeArenaAllocator::unaligned_usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena & arena = *header->m_arena;
+			MutexLock lock( arena.m_mutex );
+			return arena.m_tlsf.unaligned_usable_size( header ) - sizeof( Header );
+		}
+
+		// NodeArenaAllocator::dump_state
+		void NodeArenaAllocator::dump_state( StateWriter & i_state_writer )
+		{
+			i_state_writer.write( "type", "node_arena" );
+			i_state_writer.write_uint( "arenas", m_arena_count );
+			for( size_t node = 0; node < m_arena_count; node++ )
+			{
+				i_state_writer.tab( "arena" );
+				MutexLock lock( m_arenas[ node ]->m_mutex );
+				m_arenas[ node ]->m_tlsf.dump_state( i_state_writer );
+				i_state_writer.untab();
+			}
+		}
+
+	} // namespace memo
+
+#endif // #if MEMO_ENABLE_TLSF && MEMO_ENABLE_NUMA
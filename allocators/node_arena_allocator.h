@@ -0,0 +1,162 @@
+
+namespace memo
+{
+	#if MEMO_ENABLE_TLSF && MEMO_ENABLE_NUMA
+
+		/**	\class NodeArenaAllocator
+			Allocator that keeps a tlsf arena (a TlsfAllocator) for every NUMA node of the system, whose regions are
+			bound to the memory of the node (see RegionAllocator::Config::m_numa_node). A block is allocated in the arena
+			of the node of the processor running the calling thread, so that threads use local memory. If that arena
+			can't perform the allocation, the arenas of the other nodes are tried.
+			On a system with a single node there is a single arena, whose regions are not bound to any node.
+			Every block has a header storing its arena, so any thread can free any block. Every arena is protected by a
+			mutex. A pointer is added as overhead to every memory block.
+
+			The following parameters are supported in the configuration file:
+			- arena_size: size of the first region of every arena. The default is 16 MB.
+			- growth: size of the extra regions of the arenas (see TlsfAllocator). The default is 4 MB.
+			- max_size: maximum size of every arena (see TlsfAllocator). The default is zero, that means no limit.
+			- huge_pages: "true" or "false". If true the system is asked to back the regions with huge pages. The
+				default is false. */
+		class NodeArenaAllocator : public IAllocator
+		{
+		public:
+
+			/** Static function returning the name of the allocator class, used to register the type.
+			   This name can be used to instantiate this allocator in the configuration file. */
+			static const char * type_name() { return "node_arena_allocator"; }
+
+
+									///// configuration /////
+
+			/** Config structure for NodeArenaAllocator */
+			struct Config : public IAllocator::Config
+			{
+			public:
+
+				size_t m_arena_size; /**< size of the first region of every arena */
+				size_t m_growth_size; /**< size of the extra regions of the arenas */
+				size_t m_max_size; /**< maximum size of every arena, or zero if there is no limit */
+				bool m_huge_pages; /**< whether the regions should be backed by huge pages */
+
+				Config()
+					: m_arena_size( 1024 * 1024 * 16 ), m_growth_size( 1024 * 1024 * 4 ), m_max_size( 0 ), m_huge_pages( false ) { }
+
+			protected:
+
+				/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+				virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+				/** Tries to recognize the current property from the stream, and eventually reads its value.
+				  @param i_config_reader the source stream
+				  @return true if the property has been recognized, false otherwise */
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+			};
+
+			/** Constructs the allocator, creating an arena for every NUMA node */
+			NodeArenaAllocator( const Config & i_config );
+
+			/** Destroys all the arenas */
+			~NodeArenaAllocator();
+
+			/** Returns the number of arenas, that is the number of NUMA nodes */
+			size_t arena_count() const						{ return m_arena_count; }
+
+
+									///// aligned allocations /////
+
+			/** allocates an aligned memory block in the arena of the current node. Implements IAllocator::alloc.
+			  @param i_size size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+				The block is moved to another arena only if its arena can't perform the reallocation.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from the address that respects the alignment
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void free( void * i_address );
+
+			/** Implements IAllocator::dbg_check.
+			  @param i_address address of the memory block to check */
+			void dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t usable_size( void * i_address );
+
+
+								///// unaligned allocations /////
+
+			/** allocates a new memory block in the arena of the current node. Implements IAllocator::unaligned_alloc.
+			  @param i_size size of the block in bytes
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * unaligned_alloc( size_t i_size );
+
+			/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+				The block is moved to another arena only if its arena can't perform the reallocation.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+			/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void unaligned_free( void * i_address );
+
+			/** Implements IAllocator::unaligned_dbg_check.
+			  @param i_address address of the memory block to check */
+			void unaligned_dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+				Implements IAllocator::unaligned_try_expand.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+				Implements IAllocator::unaligned_usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t unaligned_usable_size( void * i_address );
+
+			/** Writes out in a human readable way the state of the allocator */
+			void dump_state( StateWriter & i_state_writer );
+
+		private:
+			NodeArenaAllocator( const NodeArenaAllocator & ); // not implemented
+			NodeArenaAllocator & operator = ( const NodeArenaAllocator & ); // not implemented
+
+			struct Header;
+			struct Arena;
+
+			void * alloc_block( size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+			void * arena_alloc( Arena & i_arena, size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+			void * realloc_block( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+			void free_block( void * i_address, bool i_aligned );
+			bool try_expand_block( void * i_address, size_t i_new_size, bool i_aligned );
+
+		private: // data members
+			Arena * * m_arenas; /**< arena of every node, indexed by node */
+			size_t m_arena_count;
+		};
+
+	#endif // #if MEMO_ENABLE_TLSF && MEMO_ENABLE_NUMA
+
+} // namespace memo
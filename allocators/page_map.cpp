@@ -0,0 +1,90 @@
+
+#if MEMO_ENABLE_PAGE_MAP
+
+	namespace memo
+	{
+		PageMap::Mid * PageMap::s_root[ PageMap::s_root_size ];
+		memo_externals::Mutex PageMap::s_mutex;
+
+		// PageMap::get_entry
+		IAllocator ** PageMap::get_entry( uintptr_t i_page, bool i_create )
+		{
+			const uintptr_t root_index = i_page >> ( s_mid_bits + s_leaf_bits );
+			MEMO_ASSERT( root_index < s_root_size ); // the address is outside the range covered by the map
+
+			Mid * mid = load_node( s_root[ root_index ] );
+			if( mid == nullptr )
+			{
+				if( !i_create )
+					return nullptr;
+				mid = static_cast<Mid*>( DefaultAllocator::s_unaligned_alloc( sizeof( Mid ) ) );
+				if( mid == nullptr )
+					return nullptr;
+				memset( mid, 0, sizeof( Mid ) );
+				publish_node( s_root[ root_index ], mid );
+			}
+
+			Leaf * & leaf_slot = mid->m_leaves[ ( i_page >> s_leaf_bits ) & ( s_mid_size - 1 ) ];
+			Leaf * leaf = load_node( leaf_slot );
+			if( leaf == nullptr )
+			{
+				if( !i_create )
+					return nullptr;
+				Leaf * new_leaf = static_cast<Leaf*>( DefaultAllocator::s_unaligned_alloc( sizeof( Leaf ) ) );
+				if( new_leaf == nullptr )
+					return nullptr;
+				memset( new_leaf, 0, sizeof( Leaf ) );
+				publish_node( leaf_slot, new_leaf );
+				leaf = new_leaf;
+			}
+
+			return &leaf->m_allocators[ i_page & ( s_leaf_size - 1 ) ];
+		}
+
+		// PageMap::set_range
+		void PageMap::set_range( const void * i_start, size_t i_size, IAllocator * i_allocator )
+		{
+			const uintptr_t first_page = reinterpret_cast<uintptr_t>( i_start ) >> s_page_size_log2;
+			const uintptr_t last_page = ( reinterpret_cast<uintptr_t>( i_start ) + i_size - 1 ) >> s_page_size_log2;
+			for( uintptr_t page = first_page; page <= last_page; page++ )
+			{
+				IAllocator ** entry = get_entry( page, false );
+				MEMO_ASSERT( entry != nullptr );
+				MEMO_ASSERT( ( *entry == nullptr ) != ( i_allocator == nullptr ) ); // the page is already registered, or it is not registered
+				*entry = i_allocator;
+			}
+		}
+
+		// PageMap::register_range
+		bool PageMap::register_range( const void * i_start, size_t i_size, IAllocator & i_allocator )
+		{
+			MEMO_ASSERT( i_size > 0 );
+
+			MutexLock lock( s_mutex );
+
+			// create all the nodes before changing the map, so that if an allocation fails the map is left unchanged
+			const uintptr_t first_page = reinterpret_cast<uintptr_t>( i_start ) >> s_page_size_log2;
+			const uintptr_t last_page = ( reinterpret_cast<uintptr_t>( i_start ) + i_size - 1 ) >> s_page_size_log2;
+			for( uintptr_t page = first_page; page <= last_page; page++ )
+			{
+				if( get_entry( page, true ) == nullptr )
+					return false;
+			}
+
+			set_range( i_start, i_size, &i_allocator );
+			return true;
+		}
+
+		// PageMap::unregister_range
+		void PageMap::unregister_range( const void * i_start, size_t i_size )
+		{
+			MEMO_ASSERT( i_size > 0 );
+
+			MutexLock lock( s_mutex );
+
+			set_range( i_start, i_size, nullptr );
+		}
+
+	} // namespace memo
+
+#endif // #if MEMO_ENABLE_PAGE_MAP
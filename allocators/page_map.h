@@ -0,0 +1,101 @@
+
+namespace memo
+{
+	#if MEMO_ENABLE_PAGE_MAP
+
+		/**	\class PageMap
+			Global radix tree that maps the address space, with a granularity of s_page_size bytes, to the allocators
+			owning it. Allocators that own their memory (see IAllocator::register_in_page_map) register their address
+			ranges in this map, so that memo::free and memo::realloc can find the owner of a memory block from its
+			address, and the blocks allocated by these allocators don't need an allocation header.
+			A lookup does not take any lock, and reads only the nodes of the tree, not the memory block. Registering and
+			unregistering address ranges is protected by a mutex. New nodes are published with a release store, and
+			read with acquire loads, so a lookup never sees a node before it is zeroed. The nodes of the tree are allocated with the default
+			allocator, and are never released. */
+		class PageMap
+		{
+		public:
+
+			static const size_t s_page_size_log2 = 16; /**< log2 of the granularity of the map */
+			static const size_t s_page_size = static_cast<size_t>( 1 ) << s_page_size_log2; /**< granularity of the map */
+
+			/** Retrieves the allocator that has registered the page containing the given address
+			  @param i_address address to look up
+			  @return the allocator owning the page, or nullptr if the page is not registered */
+			static IAllocator * find_allocator( const void * i_address )
+			{
+				const uintptr_t page = reinterpret_cast<uintptr_t>( i_address ) >> s_page_size_log2;
+				const uintptr_t root_index = page >> ( s_mid_bits + s_leaf_bits );
+				if( root_index >= s_root_size )
+					return nullptr;
+				const Mid * mid = load_node( s_root[ root_index ] );
+				if( mid == nullptr )
+					return nullptr;
+				const Leaf * leaf = load_node( mid->m_leaves[ ( page >> s_leaf_bits ) & ( s_mid_size - 1 ) ] );
+				if( leaf == nullptr )
+					return nullptr;
+				return leaf->m_allocators[ page & ( s_leaf_size - 1 ) ];
+			}
+
+			/** Assigns to an allocator all the pages overlapping an address range. None of these pages should be already
+				registered. The range should be aligned to s_page_size, otherwise the allocator gets the ownership of the
+				whole boundary pages.
+			  @param i_start first byte of the range
+			  @param i_size size of the range in bytes
+			  @param i_allocator allocator that will own the pages
+			  @return true on success, false if a node of the tree could not be allocated. In this case the map is left unchanged. */
+			static bool register_range( const void * i_start, size_t i_size, IAllocator & i_allocator );
+
+			/** Removes from the map all the pages overlapping an address range, previously registered with register_range.
+			  @param i_start first byte of the range
+			  @param i_size size of the range in bytes */
+			static void unregister_range( const void * i_start, size_t i_size );
+
+		private:
+
+			static const size_t s_address_bits = sizeof( void * ) >= 8 ? 48 : 32;
+			static const size_t s_page_index_bits = s_address_bits - s_page_size_log2;
+			static const size_t s_leaf_bits = ( s_page_index_bits + 2 ) / 3;
+			static const size_t s_mid_bits = s_leaf_bits;
+			static const size_t s_root_bits = s_page_index_bits - s_mid_bits - s_leaf_bits;
+			static const size_t s_leaf_size = static_cast<size_t>( 1 ) << s_leaf_bits;
+			static const size_t s_mid_size = static_cast<size_t>( 1 ) << s_mid_bits;
+			static const size_t s_root_size = static_cast<size_t>( 1 ) << s_root_bits;
+
+			struct Leaf
+			{
+				IAllocator * m_allocators[ s_leaf_size ];
+			};
+
+			struct Mid
+			{
+				Leaf * m_leaves[ s_mid_size ];
+			};
+
+			/** reads a pointer to a node of the tree, which may be published concurrently by publish_node */
+			template < typename NODE >
+				static NODE * load_node( NODE * const & i_node )
+			{
+				return static_cast<NODE *>( memo_externals::atomic_load_pointer_acquire( 
+					reinterpret_cast<void * const volatile *>( &i_node ) ) );
+			}
+
+			/** stores a pointer to a new node, after its content has been initialized */
+			template < typename NODE >
+				static void publish_node( NODE * & o_node, NODE * i_new_node )
+			{
+				memo_externals::atomic_store_pointer_release( reinterpret_cast<void * volatile *>( &o_node ), i_new_node );
+			}
+
+			static IAllocator ** get_entry( uintptr_t i_page, bool i_create );
+
+			static void set_range( const void * i_start, size_t i_size, IAllocator * i_allocator );
+
+		private: // data members
+			static Mid * s_root[ s_root_size ];
+			static memo_externals::Mutex s_mutex; /**< protects the writes to the map */
+		};
+
+	#endif
+
+} // namespace memo
@@ -3,11 +3,23 @@
 namespace memo
 {
 	// RegionAllocator::constructor
-	RegionAllocator::RegionAllocator( const Config & i_config, size_t i_minimum_buffer_size ) 
-		: m_extern_allocator( &safe_get_default_allocator() )
+	RegionAllocator::RegionAllocator( const Config & i_config, size_t i_minimum_buffer_size, size_t i_buffer_alignment ) 
+		: m_extern_allocator( &safe_get_default_allocator() ), m_buffer_alignment( i_buffer_alignment )
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			, m_virtual_memory( i_config.m_virtual_memory || i_config.m_huge_pages ), m_huge_pages( i_config.m_huge_pages )
+		#endif
+		#if MEMO_ENABLE_NUMA
+			, m_numa_node( i_config.m_numa_node )
+		#endif
 	{
-		m_buffer_size = std::max( i_config.m_buffer_size, i_minimum_buffer_size );
-		m_buffer = m_extern_allocator->unaligned_alloc( m_buffer_size );
+		#if MEMO_ENABLE_NUMA
+			// only pages reserved from the virtual memory can be bound to a node
+			if( m_numa_node != s_no_numa_node )
+				m_virtual_memory = true;
+		#endif
+
+		m_buffer_size = round_region_size( std::max( i_config.m_buffer_size, i_minimum_buffer_size ) );
+		m_buffer = alloc_region_buffer( m_buffer_size );
 		if( m_buffer == nullptr )
 		{
 			memo_externals::output_message( "region allocation failed\n" );
@@ -18,10 +30,95 @@ namespace memo
 	// RegionAllocator::destructor
 	RegionAllocator::~RegionAllocator()
 	{
+		#if MEMO_ENABLE_PAGE_MAP
+			if( m_page_mapped )
+				PageMap::unregister_range( m_buffer, m_buffer_size );
+		#endif
 		if( m_buffer != nullptr )
-			m_extern_allocator->unaligned_free( m_buffer );
+			free_region_buffer( m_buffer, m_buffer_size );
+	}
+
+	// RegionAllocator::round_region_size
+	size_t RegionAllocator::round_region_size( size_t i_size ) const
+	{
+		size_t granularity = 1;
+		#if MEMO_ENABLE_PAGE_MAP
+			// the pages of the region must not be shared with other allocators
+			granularity = PageMap::s_page_size;
+		#endif
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			if( m_virtual_memory )
+				granularity = std::max( granularity, memo_externals::virtual_page_size() );
+		#endif
+		return ( i_size + granularity - 1 ) & ~( granularity - 1 );
 	}
 
+	// RegionAllocator::alloc_region_buffer
+	void * RegionAllocator::alloc_region_buffer( size_t i_size )
+	{
+		MEMO_ASSERT( i_size == round_region_size( i_size ) );
+
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			if( m_virtual_memory )
+			{
+				#if MEMO_ENABLE_PAGE_MAP
+					const size_t alignment = PageMap::s_page_size;
+				#else
+					const size_t alignment = memo_externals::virtual_page_size();
+				#endif
+				void * buffer = memo_externals::virtual_alloc( i_size, std::max( alignment, m_buffer_alignment ), m_huge_pages );
+				#if MEMO_ENABLE_NUMA
+					if( buffer != nullptr && m_numa_node != s_no_numa_node )
+						memo_externals::virtual_bind( buffer, i_size, m_numa_node );
+				#endif
+				return buffer;
+			}
+		#endif
+
+		#if MEMO_ENABLE_PAGE_MAP
+			return m_extern_allocator->alloc( i_size, m_buffer_alignment > PageMap::s_page_size ? m_buffer_alignment : PageMap::s_page_size, 0 );
+		#else
+			if( m_buffer_alignment > MEMO_MIN_ALIGNMENT )
+				return m_extern_allocator->alloc( i_size, m_buffer_alignment, 0 );
+			else
+				return m_extern_allocator->unaligned_alloc( i_size );
+		#endif
+	}
+
+	// RegionAllocator::free_region_buffer
+	void RegionAllocator::free_region_buffer( void * i_buffer, size_t i_size )
+	{
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			if( m_virtual_memory )
+			{
+				memo_externals::virtual_free( i_buffer, i_size );
+				return;
+			}
+		#endif
+
+		MEMO_UNUSED( i_size );
+		#if MEMO_ENABLE_PAGE_MAP
+			m_extern_allocator->free( i_buffer );
+		#else
+			if( m_buffer_alignment > MEMO_MIN_ALIGNMENT )
+				m_extern_allocator->free( i_buffer );
+			else
+				m_extern_allocator->unaligned_free( i_buffer );
+		#endif
+	}
+
+	#if MEMO_ENABLE_PAGE_MAP
+
+		// RegionAllocator::register_in_page_map
+		bool RegionAllocator::register_in_page_map()
+		{
+			if( !m_page_mapped && m_buffer != nullptr )
+				m_page_mapped = PageMap::register_range( m_buffer, m_buffer_size, *this );
+			return m_page_mapped;
+		}
+
+	#endif
+
 	// RegionAllocator::Config::configure_allocator
 	IAllocator * RegionAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
 	{
@@ -43,6 +140,41 @@ namespace memo
 
 			return true;
 		}	
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			else if( i_config_reader.try_recognize_property( "virtual_memory" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strcmp( value, "true" ) == 0 )
+					m_virtual_memory = true;
+				else if( strcmp( value, "false" ) == 0 )
+					m_virtual_memory = false;
+				else
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "huge_pages" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strcmp( value, "true" ) == 0 )
+					m_huge_pages = true;
+				else if( strcmp( value, "false" ) == 0 )
+					m_huge_pages = false;
+				else
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+		#endif
+		#if MEMO_ENABLE_NUMA
+			else if( i_config_reader.try_recognize_property( "numa_node" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_numa_node ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+		#endif
 
 		return false;
 	}
@@ -51,6 +183,17 @@ namespace memo
 	void RegionAllocator::dump_state( StateWriter & i_state_writer )
 	{
 		i_state_writer.write_mem_size( "buffer_size", m_buffer_size );
+		#if MEMO_ENABLE_PAGE_MAP
+			i_state_writer.write( "page_mapped", m_page_mapped ? "true" : "false" );
+		#endif
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			if( m_virtual_memory )
+				i_state_writer.write( "memory", m_huge_pages ? "virtual, huge pages" : "virtual" );
+		#endif
+		#if MEMO_ENABLE_NUMA
+			if( m_numa_node != s_no_numa_node )
+				i_state_writer.write_uint( "numa_node", m_numa_node );
+		#endif
 	}
 
 } // namespace memo
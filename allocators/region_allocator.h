@@ -6,7 +6,20 @@ namespace memo
 		allocated with an extern allocator, which usually is the default allocator. 
 		Derived classes may use their own algorithm to manage the buffer and perform allocations. If the allocation
 		is not possible (i.e. the space in the monolithic buffer is over), the extern allocator is used to perform the 
-		allocation. */
+		allocation. 
+		If MEMO_ENABLE_PAGE_MAP is non-zero, the buffer is aligned to PageMap::s_page_size, and its size is rounded up
+		to a multiple of it, so that the region can be registered in the page map.
+		If MEMO_ENABLE_VIRTUAL_MEMORY is non-zero, the configuration may ask to reserve the buffer directly from the
+		virtual memory of the system (see memo_externals::virtual_alloc) instead of using the extern allocator. In this 
+		case the pages of the buffer take physical memory only when they are touched, and they can be backed by huge pages.
+
+		The following parameters are supported in the configuration file:
+		- size: size of the buffer.
+		- virtual_memory: "true" or "false". If true the buffer is reserved from the virtual memory. The default is false.
+		- huge_pages: "true" or "false". If true the buffer is reserved from the virtual memory, and the system is asked 
+			to back it with huge pages. The default is false.
+		- numa_node: index of the NUMA node whose memory should back the buffers (see memo_externals::virtual_bind). If
+			specified, the buffer is reserved from the virtual memory. By default the buffers are not bound to any node. */
 	class RegionAllocator : public IAllocator
 	{
 	public:
@@ -14,15 +27,35 @@ namespace memo
 		/** Static function returning the name of the allocator class */
 		static const char * type_name() { return "region_allocator"; }
 
+		#if MEMO_ENABLE_NUMA
+			static const size_t s_no_numa_node = ~static_cast<size_t>( 0 ); /**< value of m_numa_node for buffers not bound to any node */
+		#endif
+
 		/** Config structure for RegionAllocator */
 		struct Config : public IAllocator::Config
 		{
 		public:
 
-			Config()	: m_buffer_size( 0 ) { }
+			Config()	: m_buffer_size( 0 )
+				#if MEMO_ENABLE_VIRTUAL_MEMORY
+					, m_virtual_memory( false ), m_huge_pages( false )
+				#endif
+				#if MEMO_ENABLE_NUMA
+					, m_numa_node( s_no_numa_node )
+				#endif
+					{ }
 
 			size_t m_buffer_size;
 
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				bool m_virtual_memory; /**< whether the buffer is reserved from the virtual memory */
+				bool m_huge_pages; /**< whether the buffer is reserved from the virtual memory using huge pages */
+			#endif
+
+			#if MEMO_ENABLE_NUMA
+				size_t m_numa_node; /**< NUMA node to which the buffers are bound, or s_no_numa_node */
+			#endif
+
 		protected:
 
 			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
@@ -40,6 +73,13 @@ namespace memo
 			dependant minimum, and the member m_buffer_size in the configuration struct */
 		size_t buffer_size() const						{ return m_buffer_size; }
 
+		#if MEMO_ENABLE_NUMA
+
+			/** Returns the NUMA node to which the buffers of the regions are bound, or s_no_numa_node */
+			size_t numa_node() const						{ return m_numa_node; }
+
+		#endif
+
 		/** retrieves the extern allocator. */
 		IAllocator & extern_allocator() const
 			{ return *m_extern_allocator; }
@@ -50,20 +90,58 @@ namespace memo
 		/** Writes out in a human readable way the state of the allocator */
 		void dump_state( StateWriter & i_state_writer );
 
+		#if MEMO_ENABLE_PAGE_MAP
+
+			/** Registers the buffer of the region in the page map. Implements IAllocator::register_in_page_map.
+			  @return true if the allocator is registered in the page map */
+			bool register_in_page_map();
+
+		#endif
+
 	protected:
 
 		/** Constructs a RegionAllocator, allocating the buffer to use for the region 
 			@param i_minimum_buffer_size The actual buffer size is the maximum between this parameter 
-				and the member m_buffer_size in the configuration struct. */
-		RegionAllocator( const Config & i_config, size_t i_minimum_buffer_size );
+				and the member m_buffer_size in the configuration struct.
+			@param i_buffer_alignment minimum alignment of the buffers of the regions. It must be an integer power of 2. */
+		RegionAllocator( const Config & i_config, size_t i_minimum_buffer_size, size_t i_buffer_alignment = MEMO_MIN_ALIGNMENT );
 
 		/** Returns a pointer to the start of the buffer */
 		void * buffer() const { return m_buffer; }
 
+		/** Returns true if the buffers of the regions are reserved from the virtual memory */
+		bool uses_virtual_memory() const
+		{
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				return m_virtual_memory;
+			#else
+				return false;
+			#endif
+		}
+
+		/** Rounds up the size of a buffer, as required by the page map and by the virtual memory */
+		size_t round_region_size( size_t i_size ) const;
+
+		/** Allocates a buffer for a region, in the same way the buffer of this region has been allocated. Derived classes
+			may use this function to allocate extra regions.
+			@param i_size size of the buffer. It must have been rounded with round_region_size.
+			@return the address of the buffer, or nullptr in case of failure */
+		void * alloc_region_buffer( size_t i_size );
+
+		/** Frees a buffer allocated with alloc_region_buffer */
+		void free_region_buffer( void * i_buffer, size_t i_size );
+
 	private: // data members
 		IAllocator * m_extern_allocator;
 		size_t m_buffer_size;
+		size_t m_buffer_alignment;
 		void * m_buffer;
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+			bool m_virtual_memory, m_huge_pages;
+		#endif
+		#if MEMO_ENABLE_NUMA
+			size_t m_numa_node;
+		#endif
 	};
 
 } // namespace memo
@@ -0,0 +1,562 @@
+
+#if MEMO_ENABLE_SHARED_MEMORY
+
+	namespace memo
+	{
+		/* Header of every block of the heap. The blocks are contiguous, and their offsets and sizes are multiples of
+			sizeof( Block ). The heap ends with a used block of zero size, so that every block has a next block. */
+		struct SharedRegionAllocator::Block
+		{
+			static const size_t s_free_bit = 1;
+
+			size_t m_prev_block; /**< offset of the previous block, or zero for the first block */
+			size_t m_size; /**< size of the block, including the header, or'ed with s_free_bit if the block is free */
+
+			size_t size() const							{ return m_size & ~s_free_bit; }
+			bool is_free() const						{ return ( m_size & s_free_bit ) != 0; }
+		};
+
+		/* Links of the free list of a free block, stored just after its header */
+		struct SharedRegionAllocator::FreeLinks
+		{
+			size_t m_next; /**< offset of the next block in the list, or zero */
+			size_t m_prev; /**< offset of the previous block in the list, or zero */
+		};
+
+		/* State of the heap, stored at the beginning of the shared memory object. A free block smaller than
+			1 << s_small_size_log2 is in the list ( 0, size / sizeof( Block ) ). A bigger block is in the list whose first
+			level is log2( size ) - s_small_size_log2 + 1, and whose second level is given by the s_second_level_log2 bits
+			following the highest set bit of the size. */
+		struct SharedRegionAllocator::Heap
+		{
+			static const uint32_t s_magic = 0x6F6D656D;
+			static const unsigned s_init_wait_milliseconds = 1000; /**< how long an attaching process waits for the creator to initialize the heap */
+			static const size_t s_granularity_log2 = sizeof( size_t ) == 8 ? 4 : 3;
+			static const size_t s_min_block_size = sizeof( Block ) + sizeof( FreeLinks );
+			static const size_t s_second_level_log2 = 4;
+			static const size_t s_second_level_count = static_cast<size_t>( 1 ) << s_second_level_log2;
+			static const size_t s_small_size_log2 = s_granularity_log2 + s_second_level_log2;
+			static const size_t s_first_level_count = sizeof( size_t ) * 8 - s_small_size_log2 + 1;
+
+			memo_externals::SharedMutex m_mutex;
+			uint32_t m_magic; /**< s_magic when the heap has been initialized */
+			size_t m_size; /**< size of the shared memory object */
+			size_t m_allocated_size; /**< total size of the used blocks, including the headers */
+			size_t m_block_count; /**< number of used blocks */
+			size_t m_first_level_bitmap; /**< bit i is set if m_second_level_bitmaps[ i ] is not zero */
+			uint32_t m_second_level_bitmaps[ s_first_level_count ]; /**< bit j of entry i is set if the list ( i, j ) is not empty */
+			size_t m_free_lists[ s_first_level_count ][ s_second_level_count ]; /**< offset of the first block of every list, or zero */
+
+			static size_t first_block()
+				{ return ( sizeof( Heap ) + sizeof( Block ) - 1 ) & ~( sizeof( Block ) - 1 ); }
+
+			static size_t lowest_bit( size_t i_word )
+			{
+				MEMO_ASSERT( i_word != 0 );
+				size_t bit = 0;
+				while( ( i_word & ( static_cast<size_t>( 1 ) << bit ) ) == 0 )
+					bit++;
+				return bit;
+			}
+
+			static size_t highest_bit( size_t i_word )
+			{
+				MEMO_ASSERT( i_word != 0 );
+				size_t bit = sizeof( size_t ) * 8 - 1;
+				while( ( i_word >> bit ) == 0 )
+					bit--;
+				return bit;
+			}
+
+			static void mapping( size_t i_size, size_t * o_first_level, size_t * o_second_level )
+			{
+				if( i_size < ( static_cast<size_t>( 1 ) << s_small_size_log2 ) )
+				{
+					*o_first_level = 0;
+					*o_second_level = i_size >> s_granularity_log2;
+				}
+				else
+				{
+					const size_t high_bit = highest_bit( i_size );
+					*o_first_level = high_bit - s_small_size_log2 + 1;
+					*o_second_level = ( i_size >> ( high_bit - s_second_level_log2 ) ) & ( s_second_level_count - 1 );
+				}
+			}
+		};
+
+		// SharedRegionAllocator::Config::configure_allocator
+		IAllocator * SharedRegionAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+		{
+			SharedRegionAllocator * allocator;
+			if( i_new_allocator != nullptr )
+				allocator = static_cast< SharedRegionAllocator * >( i_new_allocator );
+			else
+				allocator = MEMO_NEW( SharedRegionAllocator, *this );
+
+			IAllocator::Config::configure_allocator( allocator );
+
+			return allocator;
+		}
+
+		// SharedRegionAllocator::Config::try_recognize_property
+		bool SharedRegionAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+		{
+			if( i_config_reader.try_recognize_property( "name" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strlen( value ) >= s_max_name_length )
+					i_config_reader.output_message( serialization::eWrongContent );
+				else
+					strcpy( m_name, value );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// SharedRegionAllocator::constructor
+		SharedRegionAllocator::SharedRegionAllocator( const Config & i_config )
+			: m_heap( nullptr ), m_size( 0 ), m_creator( false )
+		{
+			memcpy( m_name, i_config.m_name, sizeof( m_name ) );
+			if( m_name[ 0 ] == 0 )
+			{
+				memo_externals::output_message( "SharedRegionAllocator: the name of the shared memory object is missing\n" );
+				memo_externals::debug_break();
+				return;
+			}
+
+			const size_t min_size = Heap::first_block() + Heap::s_min_block_size + sizeof( Block );
+			const size_t size = ( i_config.m_size + sizeof( Block ) - 1 ) & ~( sizeof( Block ) - 1 );
+			m_size = size > min_size ? size : min_size;
+
+			const size_t requested_size = m_size;
+			void * address = memo_externals::shared_memory_open( m_name, &m_size, &m_creator );
+			if( address == nullptr )
+			{
+				memo_externals::output_message( "SharedRegionAllocator: the shared memory object could not be opened\n" );
+				memo_externals::debug_break();
+				return;
+			}
+
+			// the heap is not accessed if the object has been created by a process with a different configuration
+			if( m_size != requested_size )
+			{
+				memo_externals::output_message( "SharedRegionAllocator: the size of the shared memory object does not match\n" );
+				memo_externals::debug_break();
+				memo_externals::shared_memory_close( address, m_size );
+				return;
+			}
+			m_heap = static_cast<Heap *>( address );
+
+			if( m_creator )
+			{
+				SharedMutexLock lock( m_heap->m_mutex );
+				init_heap();
+			}
+			else
+			{
+				// the creator may still be initializing the heap, or it may have died before doing it
+				bool initialized = false;
+				for( unsigned retry = 0; !initialized && retry < Heap::s_init_wait_milliseconds; retry++ )
+				{
+					{
+						SharedMutexLock lock( m_heap->m_mutex );
+						initialized = m_heap->m_magic == Heap::s_magic;
+					}
+					if( !initialized )
+						memo_externals::sleep_milliseconds( 1 );
+				}
+				if( !initialized )
+				{
+					memo_externals::output_message( "SharedRegionAllocator: the shared memory object has not been initialized by its creator\n" );
+					memo_externals::debug_break();
+					memo_externals::shared_memory_close( m_heap, m_size );
+					m_heap = nullptr;
+					return;
+				}
+				MEMO_ASSERT( m_heap->m_size == m_size );
+			}
+		}
+
+		// SharedRegionAllocator::destructor
+		SharedRegionAllocator::~SharedRegionAllocator()
+		{
+			if( m_heap != nullptr )
+			{
+				memo_externals::shared_memory_close( m_heap, m_size );
+				if( m_creator )
+					memo_externals::shared_memory_remove( m_name );
+			}
+		}
+
+		// SharedRegionAllocator::init_heap - initializes a zero filled heap, with a single free block
+		void SharedRegionAllocator::init_heap()
+		{
+			const size_t first_block = Heap::first_block();
+			const size_t end_block = ( m_size - sizeof( Block ) ) & ~( sizeof( Block ) - 1 );
+
+			m_heap->m_size = m_size;
+
+			Block * block = block_at( first_block );
+			block->m_prev_block = 0;
+			block->m_size = end_block - first_block;
+
+			Block * end = block_at( end_block );
+			end->m_prev_block = first_block;
+			end->m_size = 0;
+
+			insert_free( first_block );
+			m_heap->m_magic = Heap::s_magic;
+		}
+
+		// SharedRegionAllocator::block_at
+		SharedRegionAllocator::Block * SharedRegionAllocator::block_at( size_t i_offset ) const
+		{
+			return static_cast<Block *>( address_add( m_heap, i_offset ) );
+		}
+
+		// SharedRegionAllocator::links_at
+		SharedRegionAllocator::FreeLinks * SharedRegionAllocator::links_at( size_t i_block ) const
+		{
+			return reinterpret_cast<FreeLinks *>( block_at( i_block ) + 1 );
+		}
+
+		/* SharedRegionAllocator::block_of - returns the offset of the block containing an address returned by alloc. The
+			address may be up to sizeof( Block ) - 1 bytes after the header, if the alignment offset required so. */
+		size_t SharedRegionAllocator::block_of( const void * i_address ) const
+		{
+			return ( offset_of( i_address ) - sizeof( Block ) ) & ~( sizeof( Block ) - 1 );
+		}
+
+		// SharedRegionAllocator::insert_free - marks a block as free, and adds it to its free list
+		void SharedRegionAllocator::insert_free( size_t i_block )
+		{
+			Block * block = block_at( i_block );
+			block->m_size |= Block::s_free_bit;
+
+			size_t first_level, second_level;
+			Heap::mapping( block->size(), &first_level, &second_level );
+			size_t & head = m_heap->m_free_lists[ first_level ][ second_level ];
+
+			FreeLinks * links = links_at( i_block );
+			links->m_next = head;
+			links->m_prev = 0;
+			if( head != 0 )
+				links_at( head )->m_prev = i_block;
+			head = i_block;
+
+			m_heap->m_second_level_bitmaps[ first_level ] |= static_cast<uint32_t>( 1 ) << second_level;
+			m_heap->m_first_level_bitmap |= static_cast<size_t>( 1 ) << first_level;
+		}
+
+		// SharedRegionAllocator::remove_free - removes a block from its free list, and marks it as used
+		void SharedRegionAllocator::remove_free( size_t i_block )
+		{
+			Block * block = block_at( i_block );
+			MEMO_ASSERT( block->is_free() );
+
+			size_t first_level, second_level;
+			Heap::mapping( block->size(), &first_level, &second_level );
+
+			FreeLinks * links = links_at( i_block );
+			if( links->m_next != 0 )
+				links_at( links->m_next )->m_prev = links->m_prev;
+			if( links->m_prev != 0 )
+				links_at( links->m_prev )->m_next = links->m_next;
+			else
+			{
+				MEMO_ASSERT( m_heap->m_free_lists[ first_level ][ second_level ] == i_block );
+				m_heap->m_free_lists[ first_level ][ second_level ] = links->m_next;
+				if( links->m_next == 0 )
+				{
+					m_heap->m_second_level_bitmaps[ first_level ] &= ~( static_cast<uint32_t>( 1 ) << second_level );
+					if( m_heap->m_second_level_bitmaps[ first_level ] == 0 )
+						m_heap->m_first_level_bitmap &= ~( static_cast<size_t>( 1 ) << first_level );
+				}
+			}
+
+			block->m_size &= ~Block::s_free_bit;
+		}
+
+		/* SharedRegionAllocator::find_free - returns the offset of a free block of at least the given size, or zero. The
+			size is rounded up to the next list, so that any block of the list found is big enough. */
+		size_t SharedRegionAllocator::find_free( size_t i_size )
+		{
+			size_t size = i_size;
+			if( size >= ( static_cast<size_t>( 1 ) << Heap::s_small_size_log2 ) )
+				size += ( static_cast<size_t>( 1 ) << ( Heap::highest_bit( size ) - Heap::s_second_level_log2 ) ) - 1;
+
+			size_t first_level, second_level;
+			Heap::mapping( size, &first_level, &second_level );
+
+			uint32_t second_level_bitmap = m_heap->m_second_level_bitmaps[ first_level ] & ( ~static_cast<uint32_t>( 0 ) << second_level );
+			if( second_level_bitmap == 0 )
+			{
+				const size_t first_level_bitmap = m_heap->m_first_level_bitmap & ( ~static_cast<size_t>( 0 ) << ( first_level + 1 ) );
+				if( first_level_bitmap == 0 )
+					return 0;
+
+				first_level = Heap::lowest_bit( first_level_bitmap );
+				second_level_bitmap = m_heap->m_second_level_bitmaps[ first_level ];
+			}
+
+			return m_heap->m_free_lists[ first_level ][ Heap::lowest_bit( second_level_bitmap ) ];
+		}
+
+		/* SharedRegionAllocator::split - shrinks a used block to the given size, if the remaining space is enough for a
+			free block. The new free block is merged with the next block, if it is free. */
+		void SharedRegionAllocator::split( size_t i_block, size_t i_size )
+		{
+			Block * block = block_at( i_block );
+			MEMO_ASSERT( !block->is_free() && block->size() >= i_size );
+
+			const size_t remaining_size = block->size() - i_size;
+			if( remaining_size < Heap::s_min_block_size )
+				return;
+
+			block->m_size = i_size;
+
+			const size_t free_block = i_block + i_size;
+			Block * free_header = block_at( free_block );
+			free_header->m_prev_block = i_block;
+			free_header->m_size = remaining_size;
+
+			Block * next_header = block_at( free_block + remaining_size );
+			if( next_header->is_free() )
+			{
+				remove_free( free_block + remaining_size );
+				free_header->m_size += next_header->size();
+				next_header = block_at( free_block + free_header->size() );
+			}
+			next_header->m_prev_block = free_block;
+
+			insert_free( free_block );
+		}
+
+		// SharedRegionAllocator::alloc
+		void * SharedRegionAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			MEMO_ASSERT( i_alignment > 0 && is_integer_power_of_2( i_alignment ) );
+			MEMO_ASSERT( i_alignment_offset <= i_size );
+
+			if( m_heap == nullptr || i_size >= m_size )
+				return nullptr;
+
+			/* When the address just after the header respects the alignment, the block needs only the header and the
+				requested size. Otherwise the block must be big enough for any position of the aligned address, and for
+				the free block that may be left before it. */
+			const size_t alignment = i_alignment > MEMO_MIN_ALIGNMENT ? i_alignment : MEMO_MIN_ALIGNMENT;
+			const bool header_aligned = alignment <= sizeof( Block ) && ( i_alignment_offset & ( alignment - 1 ) ) == 0;
+			size_t search_size = sizeof( Block ) + i_size;
+			if( !header_aligned )
+				search_size += alignment + sizeof( Block ) + Heap::s_min_block_size;
+			search_size = ( search_size + sizeof( Block ) - 1 ) & ~( sizeof( Block ) - 1 );
+			if( search_size < Heap::s_min_block_size )
+				search_size = Heap::s_min_block_size;
+
+			SharedMutexLock lock( m_heap->m_mutex );
+
+			size_t block = find_free( search_size );
+			if( block == 0 )
+				return nullptr;
+			remove_free( block );
+
+			// the aligned address must leave before it either no space or enough space for a free block
+			void * start = block_at( block ) + 1;
+			void * address = upper_align( start, alignment, i_alignment_offset );
+			size_t used_block = block_of( address );
+			if( used_block != block && used_block - block < Heap::s_min_block_size )
+			{
+				address = upper_align( address_add( start, Heap::s_min_block_size ), alignment, i_alignment_offset );
+				used_block = block_of( address );
+			}
+			if( used_block != block )
+			{
+				Block * free_header = block_at( block );
+				Block * used_header = block_at( used_block );
+				used_header->m_prev_block = block;
+				used_header->m_size = free_header->size() - ( used_block - block );
+				block_at( used_block + used_header->m_size )->m_prev_block = used_block;
+				free_header->m_size = used_block - block;
+				insert_free( block );
+			}
+
+			const size_t end = ( offset_of( address ) + i_size + sizeof( Block ) - 1 ) & ~( sizeof( Block ) - 1 );
+			split( used_block, end - used_block > Heap::s_min_block_size ? end - used_block : Heap::s_min_block_size );
+
+			m_heap->m_allocated_size += block_at( used_block )->size();
+			m_heap->m_block_count++;
+			return address;
+		}
+
+		// SharedRegionAllocator::realloc
+		void * SharedRegionAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			if( is_aligned( address_add( i_address, i_alignment_offset ), i_alignment ) && try_expand( i_address, i_new_size ) )
+				return i_address;
+
+			void * new_address = alloc( i_new_size, i_alignment, i_alignment_offset );
+			if( new_address == nullptr )
+				return nullptr;
+
+			memcpy( new_address, i_address, std::min( usable_size( i_address ), i_new_size ) );
+			free( i_address );
+			return new_address;
+		}
+
+		// SharedRegionAllocator::free
+		void SharedRegionAllocator::free( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			SharedMutexLock lock( m_heap->m_mutex );
+
+			size_t block = block_of( i_address );
+			Block * header = block_at( block );
+			MEMO_ASSERT( !header->is_free() ); // the block has already been freed
+			size_t size = header->size();
+			m_heap->m_allocated_size -= size;
+			m_heap->m_block_count--;
+
+			// merge with the next block
+			Block * next_header = block_at( block + size );
+			if( next_header->is_free() )
+			{
+				remove_free( block + size );
+				size += next_header->size();
+			}
+
+			// merge with the previous block
+			const size_t prev_block = header->m_prev_block;
+			if( prev_block != 0 && block_at( prev_block )->is_free() )
+			{
+				remove_free( prev_block );
+				size += block - prev_block;
+				block = prev_block;
+				header = block_at( block );
+			}
+
+			header->m_size = size;
+			block_at( block + size )->m_prev_block = block;
+			insert_free( block );
+		}
+
+		// SharedRegionAllocator::dbg_check
+		void SharedRegionAllocator::dbg_check( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr && offset_of( i_address ) >= Heap::first_block() + sizeof( Block ) );
+			MEMO_ASSERT( !block_at( block_of( i_address ) )->is_free() );
+			MEMO_UNUSED( i_address );
+		}
+
+		// SharedRegionAllocator::try_expand
+		bool SharedRegionAllocator::try_expand( void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			if( i_new_size >= m_size )
+				return false;
+
+			SharedMutexLock lock( m_heap->m_mutex );
+
+			const size_t block = block_of( i_address );
+			Block * header = block_at( block );
+			const size_t end = ( offset_of( i_address ) + i_new_size + sizeof( Block ) - 1 ) & ~( sizeof( Block ) - 1 );
+			if( end <= block + header->size() )
+				return true;
+
+			// the block can grow only merging the next block
+			const size_t next_block = block + header->size();
+			Block * next_header = block_at( next_block );
+			if( !next_header->is_free() || end > next_block + next_header->size() )
+				return false;
+
+			remove_free( next_block );
+			const size_t old_size = header->size();
+			header->m_size = old_size + next_header->size();
+			block_at( block + header->m_size )->m_prev_block = block;
+			split( block, end - block );
+
+			m_heap->m_allocated_size += header->size() - old_size;
+			return true;
+		}
+
+		// SharedRegionAllocator::usable_size
+		size_t SharedRegionAllocator::usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			const size_t block = block_of( i_address );
+			return block + block_at( block )->size() - offset_of( i_address );
+		}
+
+		// SharedRegionAllocator::unaligned_alloc
+		void * SharedRegionAllocator::unaligned_alloc( size_t i_size )
+		{
+			return alloc( i_size, MEMO_MIN_ALIGNMENT, 0 );
+		}
+
+		// SharedRegionAllocator::unaligned_realloc
+		void * SharedRegionAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+		{
+			return realloc( i_address, i_new_size, MEMO_MIN_ALIGNMENT, 0 );
+		}
+
+		// SharedRegionAllocator::unaligned_free
+		void SharedRegionAllocator::unaligned_free( void * i_address )
+		{
+			free( i_address );
+		}
+
+		// SharedRegionAllocator::unaligned_dbg_check
+		void SharedRegionAllocator::unaligned_dbg_check( void * i_address )
+		{
+			dbg_check( i_address );
+		}
+
+		// SharedRegionAllocator::unaligned_try_expand
+		bool SharedRegionAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+		{
+			return try_expand( i_address, i_new_size );
+		}
+
+		// SharedRegionAllocator::unaligned_usable_size
+		size_t SharedRegionAllocator::unaligned_usable_size( void * i_address )
+		{
+			return usable_size( i_address );
+		}
+
+		// SharedRegionAllocator::dump_state
+		void SharedRegionAllocator::dump_state( StateWriter & i_state_writer )
+		{
+			i_state_writer.write( "type", "shared_region" );
+			i_state_writer.write( "name", m_name );
+			i_state_writer.write_mem_size( "size", m_size );
+
+			if( m_heap != nullptr )
+			{
+				size_t allocated_size, block_count;
+				{
+					SharedMutexLock lock( m_heap->m_mutex );
+					allocated_size = m_heap->m_allocated_size;
+					block_count = m_heap->m_block_count;
+				}
+				i_state_writer.write_mem_size( "allocated", allocated_size );
+				i_state_writer.write_uint( "blocks", block_count );
+			}
+		}
+
+	} // namespace memo
+
+#endif // #if MEMO_ENABLE_SHARED_MEMORY
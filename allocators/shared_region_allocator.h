@@ -0,0 +1,201 @@
+
+namespace memo
+{
+	#if MEMO_ENABLE_SHARED_MEMORY
+
+		/**	\class SharedRegionAllocator
+			Allocator managing a heap inside a named shared memory object (see memo_externals::shared_memory_open), so
+			that more processes can allocate and free blocks in the same memory, and pass them to each other without
+			copying. The first allocator opening the object creates and initializes the heap, while the others attach
+			to it.
+			Every process may map the object at a different address, so the state of the heap is stored in the object
+			itself, and it refers to blocks only by their offset from the beginning of the object. The processes should
+			exchange blocks as offsets too (see offset_of and address_of).
+			The heap uses the tlsf algorithm (two level segregated fit): the free blocks are kept in lists segregated by
+			size, and two levels of bitmaps allow to find a list with a block big enough in constant time. When a block
+			is freed it is merged with the adjacent free blocks. Every block is preceded by a header of two words.
+			Every operation locks a memo_externals::SharedMutex stored in the object, so the allocator can be used by
+			more threads and more processes at the same time. If a process dies while holding the lock, the heap
+			remains locked.
+			When the allocator that has created the object is destroyed, the name of the object is removed, so that no
+			other process can attach. The processes already attached can continue to use the heap.
+			An alignment bigger than the page size is guaranteed only in the address space of the allocating process.
+
+			The following parameters are supported in the configuration file:
+			- name: name of the shared memory object. This parameter is mandatory.
+			- size: size of the shared memory object. All the processes must specify the same size. */
+		class SharedRegionAllocator : public IAllocator
+		{
+		public:
+
+			/** Static function returning the name of the allocator class, used to register the type.
+			   This name can be used to instantiate this allocator in the configuration file. */
+			static const char * type_name() { return "shared_region_allocator"; }
+
+			static const size_t s_max_name_length = 64; /**< size of the buffer of the name, including the terminator */
+
+
+									///// configuration /////
+
+			/** Config structure for SharedRegionAllocator */
+			struct Config : public IAllocator::Config
+			{
+			public:
+
+				char m_name[ s_max_name_length ]; /**< name of the shared memory object */
+				size_t m_size; /**< size of the shared memory object */
+
+				Config()
+					: m_size( 1024 * 1024 ) { m_name[ 0 ] = 0; }
+
+			protected:
+
+				/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+				virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+				/** Tries to recognize the current property from the stream, and eventually reads its value.
+				  @param i_config_reader the source stream
+				  @return true if the property has been recognized, false otherwise */
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+			};
+
+			/** Opens the shared memory object, creating and initializing the heap if the object does not exist, or
+				attaching to the existing heap otherwise. An attaching allocator waits for about one second for the
+				creator to initialize the heap, and then fails (see is_open). */
+			SharedRegionAllocator( const Config & i_config );
+
+			/** Unmaps the shared memory object, and removes its name if this allocator has created it */
+			~SharedRegionAllocator();
+
+			/** Returns true if the shared memory object has been opened successfully */
+			bool is_open() const							{ return m_heap != nullptr; }
+
+			/** Returns true if this allocator has created the shared memory object */
+			bool is_creator() const							{ return m_creator; }
+
+			/** Returns the size of the shared memory object */
+			size_t size() const								{ return m_size; }
+
+			/** Returns the offset of an address from the beginning of the shared memory object. Another process can
+				get the address of the same byte with address_of.
+				@param i_address address inside the shared memory object */
+			size_t offset_of( const void * i_address ) const
+			{
+				MEMO_ASSERT( address_diff( i_address, m_heap ) < m_size );
+				return address_diff( i_address, m_heap );
+			}
+
+			/** Returns the address of the byte of the shared memory object at the given offset
+				@param i_offset offset from the beginning of the shared memory object, as returned by offset_of */
+			void * address_of( size_t i_offset ) const
+			{
+				MEMO_ASSERT( i_offset < m_size );
+				return address_add( m_heap, i_offset );
+			}
+
+
+									///// aligned allocations /////
+
+			/** allocates an aligned memory block. Implements IAllocator::alloc.
+			  @param i_size size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from the address that respects the alignment
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+				The block may have been allocated by another process.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void free( void * i_address );
+
+			/** Implements IAllocator::dbg_check. Checks that the address belongs to an allocated block.
+			  @param i_address address of the memory block to check */
+			void dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+				The block can grow only if it is followed by a free block big enough.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t usable_size( void * i_address );
+
+
+									///// unaligned allocations /////
+
+			/** allocates a new memory block. Implements IAllocator::unaligned_alloc.
+			  @param i_size size of the block in bytes
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * unaligned_alloc( size_t i_size );
+
+			/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+			/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void unaligned_free( void * i_address );
+
+			/** Implements IAllocator::unaligned_dbg_check. Checks that the address belongs to an allocated block.
+			  @param i_address address of the memory block to check */
+			void unaligned_dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+				Implements IAllocator::unaligned_try_expand. The block can grow only if it is followed by a free block big enough.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+				Implements IAllocator::unaligned_usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t unaligned_usable_size( void * i_address );
+
+			/** Writes out in a human readable way the state of the allocator */
+			void dump_state( StateWriter & i_state_writer );
+
+		private:
+			SharedRegionAllocator( const SharedRegionAllocator & ); // not implemented
+			SharedRegionAllocator & operator = ( const SharedRegionAllocator & ); // not implemented
+
+			struct Heap;
+			struct Block;
+			struct FreeLinks;
+
+			Block * block_at( size_t i_offset ) const;
+			FreeLinks * links_at( size_t i_block ) const;
+			size_t block_of( const void * i_address ) const;
+
+			void insert_free( size_t i_block );
+			void remove_free( size_t i_block );
+			size_t find_free( size_t i_size );
+			void split( size_t i_block, size_t i_size );
+
+			void init_heap();
+
+		private: // data members
+			Heap * m_heap;
+			size_t m_size;
+			bool m_creator;
+			char m_name[ s_max_name_length ];
+		};
+
+	#endif // #if MEMO_ENABLE_SHARED_MEMORY
+
+} // namespace memo
@@ -0,0 +1,433 @@
+
+namespace memo
+{
+	/* Header at the beginning of every slab. The free blocks of the slab are linked by their first word. */
+	struct SlabAllocator::Slab
+	{
+		size_t m_size_class;
+		size_t m_block_count; /**< number of allocated blocks */
+		size_t m_unused_offset; /**< offset from the slab of the first block never allocated */
+		void * m_free_blocks; /**< list of the free blocks */
+		Slab * m_prev; /**< previous slab in the list of the size class */
+		Slab * m_next; /**< next slab in the list of the size class, or in the stack of the free slabs */
+
+		bool is_full( size_t i_block_size, size_t i_slab_size ) const
+			{ return m_free_blocks == nullptr && m_unused_offset + i_block_size > i_slab_size; }
+	};
+
+	// SlabAllocator::Config::destructor
+	SlabAllocator::Config::~Config()
+	{
+		if( m_target != nullptr )
+		{
+			MEMO_DELETE( m_target );
+		}
+	}
+
+	// SlabAllocator::Config::configure_allocator
+	IAllocator * SlabAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+	{
+		SlabAllocator * allocator;
+		if( i_new_allocator != nullptr )
+			allocator = static_cast< SlabAllocator * >( i_new_allocator );
+		else
+			allocator = MEMO_NEW( SlabAllocator, *this );
+
+		RegionAllocator::Config::configure_allocator( allocator );
+
+		// create the target allocator
+		MEMO_ASSERT( allocator->m_target_allocator == nullptr );
+		if( m_target != nullptr )
+			allocator->m_target_allocator = m_target->create_allocator();
+
+		return allocator;
+	}
+
+	// SlabAllocator::Config::try_recognize_property
+	bool SlabAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( RegionAllocator::Config::try_recognize_property( i_config_reader ) )
+		{
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "target" ) )
+		{
+			if( m_target != nullptr )
+			{
+				MEMO_DELETE( m_target );
+				m_target = nullptr;
+			}
+
+			const char * target_allocator = i_config_reader.curr_property_vakue_as_string();
+			m_target = MemoryManager::get_instance().allocator_config_factor().create_allocator_config( target_allocator );
+			if( m_target == nullptr )
+				i_config_reader.output_message( serialization::eWrongContent );
+			else
+			{
+				i_config_reader.tab();
+
+				m_target->load( i_config_reader );
+
+				i_config_reader.untab();
+			}
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "max_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "slab_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_slab_size ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// SlabAllocator::first_block_offset - returns the offset of the first block from the beginning of a slab
+	size_t SlabAllocator::first_block_offset()
+	{
+		return ( sizeof( Slab ) + s_size_class_granularity - 1 ) & ~( s_size_class_granularity - 1 );
+	}
+
+	// SlabAllocator::slab_size_of - returns the size of the slabs, a power of 2 big enough for a block of the biggest class
+	size_t SlabAllocator::slab_size_of( const Config & i_config )
+	{
+		const size_t max_block_size = size_of_class( size_class_of( std::max<size_t>( i_config.m_max_size, 1 ) ) );
+		const size_t min_size = std::max( i_config.m_slab_size, first_block_offset() + max_block_size );
+
+		size_t slab_size = 1;
+		while( slab_size < min_size )
+			slab_size <<= 1;
+		return slab_size;
+	}
+
+	// SlabAllocator::constructor
+	SlabAllocator::SlabAllocator( const Config & i_config )
+		: RegionAllocator( i_config, slab_size_of( i_config ) ), m_target_allocator( nullptr ),
+		  m_unused_offset( 0 ), m_free_slabs( nullptr ), m_slab_count( 0 )
+	{
+		m_class_count = size_class_of( std::max<size_t>( i_config.m_max_size, 1 ) ) + 1;
+		m_max_size = size_of_class( m_class_count - 1 );
+		m_slab_size = slab_size_of( i_config );
+		m_slabs_end = buffer() != nullptr ? ( buffer_size() & ~( m_slab_size - 1 ) ) : 0;
+
+		m_partial_slabs = static_cast<Slab * *>( safe_get_default_allocator().unaligned_alloc( m_class_count * sizeof( Slab * ) ) );
+		for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+			m_partial_slabs[ size_class ] = nullptr;
+	}
+
+	// SlabAllocator::destructor
+	SlabAllocator::~SlabAllocator()
+	{
+		if( m_target_allocator != nullptr )
+		{
+			MEMO_DELETE( m_target_allocator );
+		}
+		safe_get_default_allocator().unaligned_free( m_partial_slabs );
+	}
+
+	// SlabAllocator::slab_of
+	SlabAllocator::Slab * SlabAllocator::slab_of( void * i_address ) const
+	{
+		MEMO_ASSERT( is_in_slab( i_address ) );
+		const size_t slab_offset = address_diff( i_address, buffer() ) & ~( m_slab_size - 1 );
+		return static_cast<Slab *>( address_add( buffer(), slab_offset ) );
+	}
+
+	// SlabAllocator::new_slab - takes a free slab, and puts it in the list of the size class
+	SlabAllocator::Slab * SlabAllocator::new_slab( size_t i_size_class )
+	{
+		Slab * slab;
+		if( m_free_slabs != nullptr )
+		{
+			slab = m_free_slabs;
+			m_free_slabs = slab->m_next;
+		}
+		else if( m_unused_offset < m_slabs_end )
+		{
+			slab = static_cast<Slab *>( address_add( buffer(), m_unused_offset ) );
+			m_unused_offset += m_slab_size;
+		}
+		else
+			return nullptr;
+
+		slab->m_size_class = i_size_class;
+		slab->m_block_count = 0;
+		slab->m_unused_offset = first_block_offset();
+		slab->m_free_blocks = nullptr;
+		slab->m_prev = nullptr;
+		slab->m_next = m_partial_slabs[ i_size_class ];
+		if( slab->m_next != nullptr )
+			slab->m_next->m_prev = slab;
+		m_partial_slabs[ i_size_class ] = slab;
+		m_slab_count++;
+		return slab;
+	}
+
+	// SlabAllocator::unlink_slab - removes a slab from the list of its size class
+	void SlabAllocator::unlink_slab( Slab * i_slab )
+	{
+		if( i_slab->m_prev != nullptr )
+			i_slab->m_prev->m_next = i_slab->m_next;
+		else
+			m_partial_slabs[ i_slab->m_size_class ] = i_slab->m_next;
+		if( i_slab->m_next != nullptr )
+			i_slab->m_next->m_prev = i_slab->m_prev;
+		i_slab->m_prev = i_slab->m_next = nullptr;
+	}
+
+	// SlabAllocator::slab_alloc - allocates a block from a slab, or returns nullptr if there are no free slabs
+	void * SlabAllocator::slab_alloc( size_t i_size )
+	{
+		const size_t size_class = size_class_of( i_size );
+		const size_t block_size = size_of_class( size_class );
+
+		Slab * slab = m_partial_slabs[ size_class ];
+		if( slab == nullptr )
+		{
+			slab = new_slab( size_class );
+			if( slab == nullptr )
+				return nullptr;
+		}
+
+		void * block;
+		if( slab->m_free_blocks != nullptr )
+		{
+			block = slab->m_free_blocks;
+			slab->m_free_blocks = *static_cast<void * *>( block );
+		}
+		else
+		{
+			block = address_add( slab, slab->m_unused_offset );
+			slab->m_unused_offset += block_size;
+		}
+		slab->m_block_count++;
+
+		// full slabs are not kept in the list of the size class
+		if( slab->is_full( block_size, m_slab_size ) )
+			unlink_slab( slab );
+
+		return block;
+	}
+
+	// SlabAllocator::slab_free
+	void SlabAllocator::slab_free( void * i_address )
+	{
+		Slab * slab = slab_of( i_address );
+		const size_t size_class = slab->m_size_class;
+		MEMO_ASSERT( size_class < m_class_count && slab->m_block_count > 0 );
+
+		if( slab->is_full( size_of_class( size_class ), m_slab_size ) )
+		{
+			slab->m_prev = nullptr;
+			slab->m_next = m_partial_slabs[ size_class ];
+			if( slab->m_next != nullptr )
+				slab->m_next->m_prev = slab;
+			m_partial_slabs[ size_class ] = slab;
+		}
+
+		*static_cast<void * *>( i_address ) = slab->m_free_blocks;
+		slab->m_free_blocks = i_address;
+		slab->m_block_count--;
+
+		// the slab is released if it's empty, unless it's the only one of the size class
+		if( slab->m_block_count == 0 && ( slab->m_prev != nullptr || slab->m_next != nullptr ) )
+		{
+			unlink_slab( slab );
+			slab->m_next = m_free_slabs;
+			m_free_slabs = slab;
+			m_slab_count--;
+		}
+	}
+
+	// SlabAllocator::slab_realloc
+	void * SlabAllocator::slab_realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+	{
+		const size_t block_size = size_of_class( slab_of( i_address )->m_size_class );
+		if( i_new_size <= block_size && ( !i_aligned || is_aligned( address_add( i_address, i_alignment_offset ), i_alignment ) ) )
+			return i_address;
+
+		void * new_block = i_aligned ? alloc( i_new_size, i_alignment, i_alignment_offset ) : unaligned_alloc( i_new_size );
+		if( new_block == nullptr )
+			return nullptr;
+
+		memcpy( new_block, i_address, std::min( block_size, i_new_size ) );
+		slab_free( i_address );
+		return new_block;
+	}
+
+	// SlabAllocator::alloc
+	void * SlabAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		if( is_slab_size( i_size, i_alignment, i_alignment_offset ) )
+		{
+			void * block = slab_alloc( i_size );
+			if( block != nullptr )
+				return block;
+		}
+
+		return target_allocator().alloc( i_size, i_alignment, i_alignment_offset );
+	}
+
+	// SlabAllocator::realloc
+	void * SlabAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return slab_realloc( i_address, i_new_size, i_alignment, i_alignment_offset, true );
+
+		return target_allocator().realloc( i_address, i_new_size, i_alignment, i_alignment_offset );
+	}
+
+	// SlabAllocator::free
+	void SlabAllocator::free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			slab_free( i_address );
+		else
+			target_allocator().free( i_address );
+	}
+
+	// SlabAllocator::dbg_check
+	void SlabAllocator::dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+		{
+			const Slab * slab = slab_of( i_address );
+			MEMO_ASSERT( slab->m_size_class < m_class_count && slab->m_block_count > 0 );
+			MEMO_ASSERT( address_diff( i_address, slab ) >= first_block_offset() && address_diff( i_address, slab ) < slab->m_unused_offset );
+			MEMO_ASSERT( ( address_diff( i_address, slab ) - first_block_offset() ) % size_of_class( slab->m_size_class ) == 0 );
+			MEMO_UNUSED( slab );
+		}
+		else
+			target_allocator().dbg_check( i_address );
+	}
+
+	// SlabAllocator::try_expand
+	bool SlabAllocator::try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return i_new_size <= size_of_class( slab_of( i_address )->m_size_class );
+
+		return target_allocator().try_expand( i_address, i_new_size );
+	}
+
+	// SlabAllocator::usable_size
+	size_t SlabAllocator::usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return size_of_class( slab_of( i_address )->m_size_class );
+
+		return target_allocator().usable_size( i_address );
+	}
+
+	// SlabAllocator::unaligned_alloc
+	void * SlabAllocator::unaligned_alloc( size_t i_size )
+	{
+		if( i_size <= m_max_size )
+		{
+			void * block = slab_alloc( i_size );
+			if( block != nullptr )
+				return block;
+		}
+
+		return target_allocator().unaligned_alloc( i_size );
+	}
+
+	// SlabAllocator::unaligned_realloc
+	void * SlabAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return slab_realloc( i_address, i_new_size, MEMO_MIN_ALIGNMENT, 0, false );
+
+		return target_allocator().unaligned_realloc( i_address, i_new_size );
+	}
+
+	// SlabAllocator::unaligned_free
+	void SlabAllocator::unaligned_free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			slab_free( i_address );
+		else
+			target_allocator().unaligned_free( i_address );
+	}
+
+	// SlabAllocator::unaligned_dbg_check
+	void SlabAllocator::unaligned_dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			dbg_check( i_address );
+		else
+			target_allocator().unaligned_dbg_check( i_address );
+	}
+
+	// SlabAllocator::unaligned_try_expand
+	bool SlabAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return i_new_size <= size_of_class( slab_of( i_address )->m_size_class );
+
+		return target_allocator().unaligned_try_expand( i_address, i_new_size );
+	}
+
+	// SlabAllocator::unaligned_usable_size
+	size_t SlabAllocator::unaligned_usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		if( is_in_slab( i_address ) )
+			return size_of_class( slab_of( i_address )->m_size_class );
+
+		return target_allocator().unaligned_usable_size( i_address );
+	}
+
+	// SlabAllocator::dump_state
+	void SlabAllocator::dump_state( StateWriter & i_state_writer )
+	{
+		i_state_writer.write( "type", "slab" );
+
+		RegionAllocator::dump_state( i_state_writer );
+
+		i_state_writer.write_mem_size( "slab_size", m_slab_size );
+		i_state_writer.write_mem_size( "max_size", m_max_size );
+		i_state_writer.write_uint( "used_slabs", m_slab_count );
+		i_state_writer.write_uint( "free_slabs", m_slabs_end / m_slab_size - m_slab_count );
+
+		if( m_target_allocator != nullptr )
+		{
+			i_state_writer.tab( "allocator" );
+			m_target_allocator->dump_state( i_state_writer );
+			i_state_writer.untab();
+		}
+		else
+		{
+			i_state_writer.write( "target", "extern" );
+		}
+	}
+
+} // namespace memo
@@ -0,0 +1,205 @@
+
+namespace memo
+{
+	/**	\class SlabAllocator
+		Region allocator that serves small blocks from slabs carved out of its buffer. The buffer is split in slabs of
+		the same size, and every slab in use is dedicated to a size class. A header at the beginning of every slab stores
+		its size class and its list of free blocks, so no header is added to the blocks: when a block is freed, its slab
+		is found by address. The slabs of every size class that have free blocks are kept in a list, and slabs that become
+		completely free are given back to the region, to be used by any size class.
+		Blocks bigger than the maximum size, or requiring an alignment bigger than MEMO_MIN_ALIGNMENT, are allocated
+		by the target allocator. The target allocator is used also when there are no more free slabs in the region.
+		Allocation and deallocation of small blocks are O(1), and no coalescing is performed. It is suitable for contexts
+		that allocate many small objects, like strings and nodes of containers.
+		The allocator is not thread safe. It is never registered in the page map, as the blocks of the target allocator
+		would not be found by address.
+
+		The following parameters are supported in the configuration file:
+		- size: inherited from RegionAllocator, is the size of the buffer.
+		- target: name of the type of allocator used for the blocks that are not served by the slabs (for example
+			"default_allocator", "tlsf_allocator"). The default is to use the extern allocator of the region, that is
+			the default allocator.
+		- max_size: maximum size of the blocks served by the slabs. The default is 1024.
+		- slab_size: size of the slabs. It is rounded up to a power of 2. The default is 16 KB. */
+	class SlabAllocator : public RegionAllocator
+	{
+	public:
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name() { return "slab_allocator"; }
+
+
+								///// configuration /////
+
+		/** Config structure for SlabAllocator */
+		struct Config : public RegionAllocator::Config
+		{
+		public:
+
+			size_t m_max_size; /**< maximum size of the blocks served by the slabs */
+			size_t m_slab_size; /**< size of the slabs */
+
+			/** Pointer to the config of the target allocator, or nullptr to use the extern allocator. It has the
+				ownership of the pointed object. */
+			IAllocator::Config * m_target;
+
+			Config()
+				: m_max_size( 1024 ), m_slab_size( 1024 * 16 ), m_target( nullptr ) { }
+
+			/** Deletes the config pointed by m_target, if not null */
+			~Config();
+
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+		};
+
+		/** Constructs the allocator, with all the slabs free. The target allocator is created by the config structure. */
+		SlabAllocator( const Config & i_config );
+
+		/** Destroys the allocator and its target allocator */
+		~SlabAllocator();
+
+		/** Retrieves the allocator used for the blocks that are not served by the slabs */
+		IAllocator & target_allocator() const
+			{ return m_target_allocator != nullptr ? *m_target_allocator : extern_allocator(); }
+
+		#if MEMO_ENABLE_PAGE_MAP
+
+			/** Does nothing and returns false, as the blocks of the target allocator would not be found by address.
+				Overrides RegionAllocator::register_in_page_map. */
+			bool register_in_page_map() { return false; }
+
+		#endif
+
+
+								///// aligned allocations /////
+
+		/** allocates an aligned memory block. Implements IAllocator::alloc.
+			Small blocks are taken from a slab, the others are allocated by the target allocator.
+		  @param i_size size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+			A block of a slab is not moved if the new size does not exceed the size of its class.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from the address that respects the alignment
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void free( void * i_address );
+
+		/** Implements IAllocator::dbg_check.
+		  @param i_address address of the memory block to check */
+		void dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			A block of a slab can be resized up to the size of its class.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t usable_size( void * i_address );
+
+
+								///// unaligned allocations /////
+
+		/** allocates a new memory block. Implements IAllocator::unaligned_alloc.
+			Small blocks are taken from a slab, the others are allocated by the target allocator.
+		  @param i_size size of the block in bytes
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * unaligned_alloc( size_t i_size );
+
+		/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+			A block of a slab is not moved if the new size does not exceed the size of its class.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+		/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void unaligned_free( void * i_address );
+
+		/** Implements IAllocator::unaligned_dbg_check.
+		  @param i_address address of the memory block to check */
+		void unaligned_dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+			Implements IAllocator::unaligned_try_expand. A block of a slab can be resized up to the size of its class.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+			Implements IAllocator::unaligned_usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t unaligned_usable_size( void * i_address );
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer );
+
+	private:
+		SlabAllocator( const SlabAllocator & ); // not implemented
+		SlabAllocator & operator = ( const SlabAllocator & ); // not implemented
+
+		struct Slab;
+
+		static const size_t s_size_class_granularity = 16;
+
+		static size_t size_class_of( size_t i_size )
+			{ return i_size > 0 ? ( i_size - 1 ) / s_size_class_granularity : 0; }
+
+		static size_t size_of_class( size_t i_size_class )
+			{ return ( i_size_class + 1 ) * s_size_class_granularity; }
+
+		static size_t first_block_offset();
+		static size_t slab_size_of( const Config & i_config );
+
+		bool is_slab_size( size_t i_size, size_t i_alignment, size_t i_alignment_offset ) const
+			{ return i_size <= m_max_size && i_alignment <= MEMO_MIN_ALIGNMENT && ( i_alignment_offset & ( i_alignment - 1 ) ) == 0; }
+
+		bool is_in_slab( const void * i_address ) const
+			{ return i_address >= buffer() && address_diff( i_address, buffer() ) < m_slabs_end; }
+
+		Slab * slab_of( void * i_address ) const;
+
+		Slab * new_slab( size_t i_size_class );
+		void unlink_slab( Slab * i_slab );
+		void * slab_alloc( size_t i_size );
+		void slab_free( void * i_address );
+		void * slab_realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+
+	private: // data members
+		IAllocator * m_target_allocator; /**< allocator created from the target config, or nullptr */
+		size_t m_max_size;
+		size_t m_class_count;
+		size_t m_slab_size;
+		size_t m_slabs_end; /**< offset of the end of the last slab that fits in the buffer */
+		size_t m_unused_offset; /**< offset of the first slab never used */
+		Slab * m_free_slabs; /**< stack of the slabs that have been used and then released */
+		Slab * * m_partial_slabs; /**< for every size class, list of slabs with free blocks */
+		size_t m_slab_count; /**< number of slabs in use */
+	};
+
+} // namespace memo
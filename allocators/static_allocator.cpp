@@ -0,0 +1,221 @@
+
+namespace memo
+{
+	// _static_allocator_name
+	void _static_allocator_name( char * o_dest, size_t i_capacity, const char * const * i_names, size_t i_name_count )
+	{
+		MEMO_ASSERT( i_capacity > 0 );
+
+		const char prefix[] = "static";
+		size_t length = 0;
+		for( const char * source = prefix; *source != 0 && length + 1 < i_capacity; source++ )
+			o_dest[ length++ ] = *source;
+
+		for( size_t name_index = 0; name_index < i_name_count; name_index++ )
+		{
+			if( i_names[ name_index ] == nullptr )
+				continue;
+
+			if( length + 1 < i_capacity )
+				o_dest[ length++ ] = '_';
+			for( const char * source = i_names[ name_index ]; *source != 0 && length + 1 < i_capacity; source++ )
+				o_dest[ length++ ] = *source;
+		}
+
+		o_dest[ length ] = 0;
+	}
+
+	#if MEMO_ENABLE_TLSF
+
+		// TlsfBackend::Config::try_recognize_property
+		bool TlsfBackend::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+		{
+			if( i_config_reader.try_recognize_property( "size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_buffer_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// TlsfBackend::_make_tlsf_config
+		TlsfAllocator::Config TlsfBackend::_make_tlsf_config( const Config & i_config )
+		{
+			TlsfAllocator::Config tlsf_config;
+			tlsf_config.m_buffer_size = i_config.m_buffer_size;
+			return tlsf_config;
+		}
+
+	#endif // #if MEMO_ENABLE_TLSF
+
+	// DebugPolicy::Options::constructor
+	DebugPolicy::Options::Options()
+	{
+		DebugAllocator::Config defaults;
+		m_new_memory_fill_mode = defaults.m_new_memory_fill_mode;
+		m_deleted_memory_fill_mode = defaults.m_deleted_memory_fill_mode;
+		m_nomansland_words = defaults.m_nomansland_words;
+	}
+
+	// DebugPolicy::Options::try_recognize_property
+	bool DebugPolicy::Options::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( i_config_reader.try_recognize_property( "new_memory_fill" ) )
+		{
+			const char * fill_mode_string = i_config_reader.curr_property_vakue_as_string();
+
+			if( !DebugAllocator::string_to_fill_mode( fill_mode_string, &m_new_memory_fill_mode ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "deleted_memory_fill" ) )
+		{
+			const char * fill_mode_string = i_config_reader.curr_property_vakue_as_string();
+
+			if( !DebugAllocator::string_to_fill_mode( fill_mode_string, &m_deleted_memory_fill_mode ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "nomansland_words" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_nomansland_words ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// DebugPolicy::State::constructor
+	DebugPolicy::State::State( const Options & i_options )
+		: m_new_memory_fill_mode( i_options.m_new_memory_fill_mode ),
+		  m_deleted_memory_fill_mode( i_options.m_deleted_memory_fill_mode )
+	{
+		m_tailing_nomansland_size = m_heading_nomansland_size = i_options.m_nomansland_words / 2;
+		m_heading_nomansland_size += i_options.m_nomansland_words & 1;
+
+		m_heading_nomansland_size *= sizeof( void * );
+		m_tailing_nomansland_size *= sizeof( void * );
+	}
+
+	// DebugPolicy::s_on_alloc
+	void * DebugPolicy::s_on_alloc( const State & i_state, void * i_block, size_t i_size )
+	{
+		void * const user_block = address_add( i_block, i_state.m_heading_nomansland_size );
+
+		void * const user_block_end = address_add( user_block, i_size );
+
+		DebugAllocator::_set_nomansland( i_block, i_state.m_heading_nomansland_size, user_block );
+
+		if( i_state.m_heading_nomansland_size >= sizeof( void * ) )
+			*reinterpret_cast< void * * >( i_block ) = DebugAllocator::_invert_address( user_block_end );
+
+		DebugAllocator::_fill_memory( i_state.m_new_memory_fill_mode, user_block, i_size );
+
+		DebugAllocator::_set_nomansland( user_block_end, i_state.m_tailing_nomansland_size, user_block );
+
+		return user_block;
+	}
+
+	// DebugPolicy::s_on_realloc
+	void * DebugPolicy::s_on_realloc( const State & i_state, void * i_block, size_t i_old_size, size_t i_new_size )
+	{
+		void * const user_block = address_add( i_block, i_state.m_heading_nomansland_size );
+
+		void * const user_block_end = address_add( user_block, i_new_size );
+
+		DebugAllocator::_set_nomansland( i_block, i_state.m_heading_nomansland_size, user_block );
+
+		DebugAllocator::_set_nomansland( user_block_end, i_state.m_tailing_nomansland_size, user_block );
+
+		if( i_state.m_heading_nomansland_size >= sizeof( void * ) )
+		{
+			*reinterpret_cast< void * * >( i_block ) = DebugAllocator::_invert_address( user_block_end );
+
+			if( i_new_size > i_old_size )
+				DebugAllocator::_fill_memory( i_state.m_new_memory_fill_mode, address_add( user_block, i_old_size ), i_new_size - i_old_size );
+		}
+
+		return user_block;
+	}
+
+	// DebugPolicy::s_check
+	size_t DebugPolicy::s_check( const State & i_state, void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr ); // i_address can't be null
+
+		void * const block = address_sub( i_address, i_state.m_heading_nomansland_size );
+
+		size_t size = 0;
+
+		if( i_state.m_heading_nomansland_size >= sizeof( void * ) )
+		{
+			DebugAllocator::_check_nomansland( block, i_state.m_heading_nomansland_size - sizeof( void * ), 
+				address_add( i_address, sizeof( void * ) ) );
+
+			void * user_block_end = DebugAllocator::_invert_address( *reinterpret_cast< void * * >( block ) );
+			size = address_diff( user_block_end, i_address );
+
+			DebugAllocator::_check_nomansland( user_block_end, i_state.m_tailing_nomansland_size, i_address );
+		}
+		else
+		{
+			DebugAllocator::_check_nomansland( block, i_state.m_heading_nomansland_size, i_address );
+		}
+
+		return size;
+	}
+
+	// DebugPolicy::s_on_free
+	void * DebugPolicy::s_on_free( const State & i_state, void * i_address )
+	{
+		const size_t old_size = s_check( i_state, i_address ); // the return value is valid only if m_heading_nomansland_size >= sizeof( void * )
+
+		void * const block = address_sub( i_address, i_state.m_heading_nomansland_size );
+
+		if( i_state.m_heading_nomansland_size >= sizeof( void * ) )
+			DebugAllocator::_fill_memory( i_state.m_deleted_memory_fill_mode, block, old_size + i_state.overhead() );
+		else
+			DebugAllocator::_fill_memory( i_state.m_deleted_memory_fill_mode, block, i_state.overhead() );
+
+		return block;
+	}
+
+	// DebugPolicy::s_on_free
+	void * DebugPolicy::s_on_free( const State & i_state, void * i_address, size_t i_size )
+	{
+		if( i_state.m_heading_nomansland_size >= sizeof( void * ) )
+		{
+			if( s_check( i_state, i_address ) != i_size )
+			{
+				memo_externals::output_message( "the size passed to free does not match the size of the block\n" );
+				memo_externals::debug_break();
+			}
+		}
+		else
+		{
+			s_check( i_state, i_address );
+			DebugAllocator::_check_nomansland( address_add( i_address, i_size ), i_state.m_tailing_nomansland_size, i_address );
+		}
+
+		void * const block = address_sub( i_address, i_state.m_heading_nomansland_size );
+
+		DebugAllocator::_fill_memory( i_state.m_deleted_memory_fill_mode, block, i_size + i_state.overhead() );
+
+		return block;
+	}
+
+	// DebugPolicy::s_dump_state
+	void DebugPolicy::s_dump_state( const State & i_state, IAllocator::StateWriter & i_state_writer )
+	{
+		i_state_writer.write_mem_size( "heading_nomansland_size", i_state.m_heading_nomansland_size );
+		i_state_writer.write_mem_size( "tailing_nomansland_size", i_state.m_tailing_nomansland_size );
+	}
+
+} // namespace memo
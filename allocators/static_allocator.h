@@ -0,0 +1,593 @@
+
+namespace memo
+{
+	/** Placeholder for the unused parameters of Static. */
+	struct NoPolicy
+	{
+		static const char * name() { return nullptr; }
+	};
+
+	/**	\class Static
+		Allocator composed at compile time by a stack of policies ending with a backend. For example:
+
+			memo::Static< memo::StatPolicy, memo::DebugPolicy, memo::TlsfBackend >
+
+		has the same behaviour of the runtime stack stat_allocator -> debug_allocator -> tlsf_allocator, but
+		the layers are not separate allocators: every policy is a class template (POLICY::Layer) that derives
+		from the next layer and calls it without any virtual call, so the whole stack can be inlined, and only
+		the call to the outer IAllocator is dispatched dynamically.
+		The name of the type is generated from the policies, prefixing "static_" to the names of the policies
+		separated by '_' (for example "static_stat_debug_tlsf"). The type must be registered in the AllocatorConfigFactory
+		to be used in the configuration file (see AllocatorConfigFactory::register_allocator). The properties
+		supported in the configuration file are the union of the properties supported by the policies.
+
+		A policy is a struct with:
+			- a static function name(), returning the name of the policy
+			- a nested class template Layer< NEXT >, deriving from NEXT, with a nested struct Config deriving from
+			  NEXT::Config, and a constructor taking a const Config &.
+		A backend is a class that can be used as NEXT parameter of a layer, that is:
+			- a static function name(), returning the name of the backend
+			- a nested struct Config, with a function bool try_recognize_property( serialization::IConfigReader & )
+			- a constructor taking a const Config &
+			- the non-virtual functions alloc, realloc, free, dbg_check, unaligned_alloc, unaligned_realloc,
+			  unaligned_free, unaligned_dbg_check and dump_state, with the same signature of the ones of IAllocator.
+		Both the layers and the backend must provide the sized overloads of free and unaligned_free. */
+	template < typename POLICY_1, typename POLICY_2 = NoPolicy, typename POLICY_3 = NoPolicy, typename POLICY_4 = NoPolicy >
+		class Static;
+
+	/** Writes in a buffer the name of a Static allocator, given the names of its policies. Null names are skipped.
+		@param o_dest destination buffer
+		@param i_capacity size of the destination buffer. The name is truncated if it is too long.
+		@param i_names array of names of the policies
+		@param i_name_count number of names in i_names */
+	void _static_allocator_name( char * o_dest, size_t i_capacity, const char * const * i_names, size_t i_name_count );
+
+	/** Composes the stack of layers of a Static allocator. */
+	template < typename POLICY_1, typename POLICY_2, typename POLICY_3, typename POLICY_4 >
+		struct _StaticStack
+	{
+		typedef typename POLICY_1::template Layer< typename _StaticStack< POLICY_2, POLICY_3, POLICY_4, NoPolicy >::Type > Type;
+	};
+	template < typename BACKEND >
+		struct _StaticStack< BACKEND, NoPolicy, NoPolicy, NoPolicy >
+	{
+		typedef BACKEND Type;
+	};
+
+
+
+							///// backends /////
+
+	/**	\class DefaultBackend
+		Backend for Static that uses the default allocator (see DefaultAllocator). */
+	class DefaultBackend
+	{
+	public:
+
+		static const char * name() { return "default"; }
+
+		struct Config
+		{
+			bool try_recognize_property( serialization::IConfigReader & /*i_config_reader*/ ) { return false; }
+		};
+
+		DefaultBackend( const Config & /*i_config*/ ) { }
+
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+			{ return DefaultAllocator::s_alloc( i_size, i_alignment, i_alignment_offset ); }
+
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+			{ return DefaultAllocator::s_realloc( i_address, i_new_size, i_alignment, i_alignment_offset ); }
+
+		void free( void * i_address )
+			{ DefaultAllocator::s_free( i_address ); }
+
+		void free( void * i_address, size_t /*i_size*/ )
+			{ DefaultAllocator::s_free( i_address ); }
+
+		void dbg_check( void * i_address )
+			{ DefaultAllocator::s_dbg_check( i_address ); }
+
+		void * unaligned_alloc( size_t i_size )
+			{ return DefaultAllocator::s_unaligned_alloc( i_size ); }
+
+		void * unaligned_realloc( void * i_address, size_t i_new_size )
+			{ return DefaultAllocator::s_unaligned_realloc( i_address, i_new_size ); }
+
+		void unaligned_free( void * i_address )
+			{ DefaultAllocator::s_unaligned_free( i_address ); }
+
+		void unaligned_free( void * i_address, size_t /*i_size*/ )
+			{ DefaultAllocator::s_unaligned_free( i_address ); }
+
+		void unaligned_dbg_check( void * i_address )
+			{ DefaultAllocator::s_unaligned_dbg_check( i_address ); }
+
+		void dump_state( IAllocator::StateWriter & i_state_writer )
+			{ i_state_writer.write( "backend", name() ); }
+	};
+
+	#if MEMO_ENABLE_TLSF
+
+		/**	\class TlsfBackend
+			Backend for Static that uses a tlsf region (see TlsfAllocator). The functions of the TlsfAllocator are
+			called without virtual dispatch.
+			The following parameters are supported in the configuration file:
+				- size: size of the region in bytes (see RegionAllocator::Config::m_buffer_size) */
+		class TlsfBackend
+		{
+		public:
+
+			static const char * name() { return "tlsf"; }
+
+			struct Config
+			{
+				size_t m_buffer_size; /**< size of the region */
+
+				Config() : m_buffer_size( 0 ) { }
+
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+			};
+
+			TlsfBackend( const Config & i_config )
+				: m_allocator( _make_tlsf_config( i_config ) ) { }
+
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+				{ return m_allocator.TlsfAllocator::alloc( i_size, i_alignment, i_alignment_offset ); }
+
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+				{ return m_allocator.TlsfAllocator::realloc( i_address, i_new_size, i_alignment, i_alignment_offset ); }
+
+			void free( void * i_address )
+				{ m_allocator.TlsfAllocator::free( i_address ); }
+
+			void free( void * i_address, size_t /*i_size*/ )
+				{ m_allocator.TlsfAllocator::free( i_address ); }
+
+			void dbg_check( void * i_address )
+				{ m_allocator.TlsfAllocator::dbg_check( i_address ); }
+
+			void * unaligned_alloc( size_t i_size )
+				{ return m_allocator.TlsfAllocator::unaligned_alloc( i_size ); }
+
+			void * unaligned_realloc( void * i_address, size_t i_new_size )
+				{ return m_allocator.TlsfAllocator::unaligned_realloc( i_address, i_new_size ); }
+
+			void unaligned_free( void * i_address )
+				{ m_allocator.TlsfAllocator::unaligned_free( i_address ); }
+
+			void unaligned_free( void * i_address, size_t /*i_size*/ )
+				{ m_allocator.TlsfAllocator::unaligned_free( i_address ); }
+
+			void unaligned_dbg_check( void * i_address )
+				{ m_allocator.TlsfAllocator::unaligned_dbg_check( i_address ); }
+
+			void dump_state( IAllocator::StateWriter & i_state_writer )
+			{
+				i_state_writer.write( "backend", name() );
+				m_allocator.RegionAllocator::dump_state( i_state_writer );
+			}
+
+		private:
+			static TlsfAllocator::Config _make_tlsf_config( const Config & i_config );
+
+		private: // data members
+			TlsfAllocator m_allocator;
+		};
+
+	#endif // #if MEMO_ENABLE_TLSF
+
+
+
+							///// policies /////
+
+	/**	\struct StatPolicy
+		Policy for Static that collects statistics, like StatAllocator. The statistics can be retrieved
+		with Layer::get_stats (for example allocator.stack().get_stats( stats ) ). */
+	struct StatPolicy
+	{
+		static const char * name() { return "stat"; }
+
+		template < typename NEXT >
+			class Layer : public NEXT
+		{
+		public:
+
+			struct Config : public NEXT::Config
+			{
+			};
+
+			Layer( const Config & i_config )
+				: NEXT( i_config ) { }
+
+			/** retrieves the current statistics of the layer */
+			void get_stats( StatAllocator::Statistics & o_dest )
+			{
+				MutexLock lock( m_mutex );
+				o_dest = m_stats;
+			}
+
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+			{
+				Header * header = static_cast<Header *>( NEXT::alloc( i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+				if( header == nullptr )
+					return nullptr;
+				header->m_block_size = i_size;
+				on_alloc( header + 1, i_size );
+				return header + 1;
+			}
+
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+			{
+				Header * const prev_header = static_cast<Header*>( i_address ) - 1;
+				const size_t prev_size = prev_header->m_block_size;
+				Header * header = static_cast<Header *>( NEXT::realloc( prev_header, i_new_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+				if( header == nullptr )
+					return nullptr;
+				header->m_block_size = i_new_size;
+				on_realloc( header + 1, prev_size, i_new_size );
+				return header + 1;
+			}
+
+			void free( void * i_address )
+			{
+				Header * const header = static_cast<Header*>( i_address ) - 1;
+				const size_t size = header->m_block_size;
+				NEXT::free( header, size + sizeof( Header ) );
+				on_free( size );
+			}
+
+			void free( void * i_address, size_t i_size )
+			{
+				Header * const header = static_cast<Header*>( i_address ) - 1;
+				MEMO_ASSERT( header->m_block_size == i_size ); // wrong size
+				NEXT::free( header, i_size + sizeof( Header ) );
+				on_free( i_size );
+			}
+
+			void dbg_check( void * i_address )
+			{
+				NEXT::dbg_check( static_cast<Header*>( i_address ) - 1 );
+			}
+
+			void * unaligned_alloc( size_t i_size )
+			{
+				Header * header = static_cast<Header *>( NEXT::unaligned_alloc( i_size + sizeof( Header ) ) );
+				if( header == nullptr )
+					return nullptr;
+				header->m_block_size = i_size;
+				on_alloc( header + 1, i_size );
+				return header + 1;
+			}
+
+			void * unaligned_realloc( void * i_address, size_t i_new_size )
+			{
+				Header * const prev_header = static_cast<Header*>( i_address ) - 1;
+				const size_t prev_size = prev_header->m_block_size;
+				Header * header = static_cast<Header *>( NEXT::unaligned_realloc( prev_header, i_new_size + sizeof( Header ) ) );
+				if( header == nullptr )
+					return nullptr;
+				header->m_block_size = i_new_size;
+				on_realloc( header + 1, prev_size, i_new_size );
+				return header + 1;
+			}
+
+			void unaligned_free( void * i_address )
+			{
+				Header * const header = static_cast<Header*>( i_address ) - 1;
+				const size_t size = header->m_block_size;
+				NEXT::unaligned_free( header, size + sizeof( Header ) );
+				on_free( size );
+			}
+
+			void unaligned_free( void * i_address, size_t i_size )
+			{
+				Header * const header = static_cast<Header*>( i_address ) - 1;
+				MEMO_ASSERT( header->m_block_size == i_size ); // wrong size
+				NEXT::unaligned_free( header, i_size + sizeof( Header ) );
+				on_free( i_size );
+			}
+
+			void unaligned_dbg_check( void * i_address )
+			{
+				NEXT::unaligned_dbg_check( static_cast<Header*>( i_address ) - 1 );
+			}
+
+			void dump_state( IAllocator::StateWriter & i_state_writer )
+			{
+				StatAllocator::Statistics statistics;
+				get_stats( statistics );
+				i_state_writer.write_uint( "allocation_count", statistics.m_allocation_count );
+				i_state_writer.write_mem_size( "total_allocated", statistics.m_total_allocated );
+				i_state_writer.write_uint( "allocation_count_peak", statistics.m_allocation_count_peak );
+				i_state_writer.write_mem_size( "total_allocated_peak", statistics.m_total_allocated_peak );
+				NEXT::dump_state( i_state_writer );
+			}
+
+		private:
+
+			struct Header
+			{
+				size_t m_block_size;
+			};
+
+			void on_alloc( void * i_address, size_t i_size )
+			{
+				MutexLock lock( m_mutex );
+				m_stats.m_allocation_count++;
+				m_stats.m_total_allocated += i_size;
+				m_stats.m_allocation_count_peak = std::max( m_stats.m_allocation_count_peak, m_stats.m_allocation_count );
+				m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
+				m_stats.m_min_address = std::min( m_stats.m_min_address, i_address );
+				m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( i_address, i_size ) );
+			}
+
+			void on_realloc( void * i_address, size_t i_prev_size, size_t i_new_size )
+			{
+				MutexLock lock( m_mutex );
+				MEMO_ASSERT( m_stats.m_total_allocated >= i_prev_size );
+				m_stats.m_total_allocated -= i_prev_size;
+				m_stats.m_total_allocated += i_new_size;
+				m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
+				m_stats.m_min_address = std::min( m_stats.m_min_address, i_address );
+				m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( i_address, i_new_size ) );
+			}
+
+			void on_free( size_t i_size )
+			{
+				MutexLock lock( m_mutex );
+				MEMO_ASSERT( m_stats.m_allocation_count > 0 );
+				MEMO_ASSERT( m_stats.m_total_allocated >= i_size );
+				m_stats.m_total_allocated -= i_size;
+				m_stats.m_allocation_count--;
+			}
+
+		private: // data members
+			StatAllocator::Statistics m_stats;
+			memo_externals::Mutex m_mutex;
+		};
+	};
+
+	/**	\struct DebugPolicy
+		Policy for Static that adds no man's lands and fills the memory, like DebugAllocator.
+		The following parameters are supported in the configuration file: new_memory_fill, deleted_memory_fill,
+		nomansland_words. See DebugAllocator::Config. */
+	struct DebugPolicy
+	{
+		static const char * name() { return "debug"; }
+
+		/** Parameters of the policy, read from the configuration file */
+		struct Options
+		{
+			DebugAllocator::FillMode m_new_memory_fill_mode; /**< see DebugAllocator::Config::m_new_memory_fill_mode */
+			DebugAllocator::FillMode m_deleted_memory_fill_mode; /**< see DebugAllocator::Config::m_deleted_memory_fill_mode */
+			size_t m_nomansland_words; /**< see DebugAllocator::Config::m_nomansland_words */
+
+			Options();
+
+			bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+		};
+
+		/** State of a layer, computed from the options */
+		struct State
+		{
+			DebugAllocator::FillMode m_new_memory_fill_mode, m_deleted_memory_fill_mode;
+			size_t m_heading_nomansland_size, m_tailing_nomansland_size;
+
+			State( const Options & i_options );
+
+			size_t overhead() const { return m_heading_nomansland_size + m_tailing_nomansland_size; }
+		};
+
+		/** setups the no man's lands of a new block, and fills it. Returns the user block. */
+		static void * s_on_alloc( const State & i_state, void * i_block, size_t i_size );
+
+		/** setups the no man's lands of a reallocated block, and fills the new memory. Returns the user block. */
+		static void * s_on_realloc( const State & i_state, void * i_block, size_t i_old_size, size_t i_new_size );
+
+		/** checks the no man's lands of a block. Returns the size of the block, if it is known (see DebugAllocator::get_block_size) */
+		static size_t s_check( const State & i_state, void * i_address );
+
+		/** checks and fills a block being freed. Returns the address of the block to free. */
+		static void * s_on_free( const State & i_state, void * i_address );
+
+		/** checks and fills a block of known size being freed. Returns the address of the block to free. */
+		static void * s_on_free( const State & i_state, void * i_address, size_t i_size );
+
+		static void s_dump_state( const State & i_state, IAllocator::StateWriter & i_state_writer );
+
+		template < typename NEXT >
+			class Layer : public NEXT
+		{
+		public:
+
+			struct Config : public NEXT::Config
+			{
+				Options m_debug;
+
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader )
+					{ return m_debug.try_recognize_property( i_config_reader ) || NEXT::Config::try_recognize_property( i_config_reader ); }
+			};
+
+			Layer( const Config & i_config )
+				: NEXT( i_config ), m_state( i_config.m_debug ) { }
+
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+			{
+				void * const block = NEXT::alloc( i_size + m_state.overhead(), i_alignment, i_alignment_offset + m_state.m_heading_nomansland_size );
+				return block != nullptr ? s_on_alloc( m_state, block, i_size ) : nullptr;
+			}
+
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+			{
+				const size_t old_size = s_check( m_state, i_address );
+				void * const new_block = NEXT::realloc( address_sub( i_address, m_state.m_heading_nomansland_size ),
+					i_new_size + m_state.overhead(), i_alignment, i_alignment_offset + m_state.m_heading_nomansland_size );
+				return new_block != nullptr ? s_on_realloc( m_state, new_block, old_size, i_new_size ) : nullptr;
+			}
+
+			void free( void * i_address )
+				{ NEXT::free( s_on_free( m_state, i_address ) ); }
+
+			void free( void * i_address, size_t i_size )
+				{ NEXT::free( s_on_free( m_state, i_address, i_size ), i_size + m_state.overhead() ); }
+
+			void dbg_check( void * i_address )
+				{ s_check( m_state, i_address ); }
+
+			void * unaligned_alloc( size_t i_size )
+			{
+				void * const block = NEXT::unaligned_alloc( i_size + m_state.overhead() );
+				return block != nullptr ? s_on_alloc( m_state, block, i_size ) : nullptr;
+			}
+
+			void * unaligned_realloc( void * i_address, size_t i_new_size )
+			{
+				const size_t old_size = s_check( m_state, i_address );
+				void * const new_block = NEXT::unaligned_realloc( address_sub( i_address, m_state.m_heading_nomansland_size ),
+					i_new_size + m_state.overhead() );
+				return new_block != nullptr ? s_on_realloc( m_state, new_block, old_size, i_new_size ) : nullptr;
+			}
+
+			void unaligned_free( void * i_address )
+				{ NEXT::unaligned_free( s_on_free( m_state, i_address ) ); }
+
+			void unaligned_free( void * i_address, size_t i_size )
+				{ NEXT::unaligned_free( s_on_free( m_state, i_address, i_size ), i_size + m_state.overhead() ); }
+
+			void unaligned_dbg_check( void * i_address )
+				{ s_check( m_state, i_address ); }
+
+			void dump_state( IAllocator::StateWriter & i_state_writer )
+			{
+				s_dump_state( m_state, i_state_writer );
+				NEXT::dump_state( i_state_writer );
+			}
+
+		private: // data members
+			State m_state;
+		};
+	};
+
+
+
+							///// Static /////
+
+	template < typename POLICY_1, typename POLICY_2, typename POLICY_3, typename POLICY_4 >
+		class Static : public IAllocator
+	{
+	public:
+
+		/** Type of the stack of layers */
+		typedef typename _StaticStack< POLICY_1, POLICY_2, POLICY_3, POLICY_4 >::Type Stack;
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name()
+		{
+			static char s_name[ 128 ];
+			if( s_name[ 0 ] == 0 )
+			{
+				const char * const names[] = { POLICY_1::name(), POLICY_2::name(), POLICY_3::name(), POLICY_4::name() };
+				_static_allocator_name( s_name, sizeof( s_name ), names, sizeof( names ) / sizeof( names[ 0 ] ) );
+			}
+			return s_name;
+		}
+
+		/** Config structure for Static */
+		struct Config : public IAllocator::Config
+		{
+		public:
+
+			typename Stack::Config m_stack; /**< configuration of the layers */
+
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const
+			{
+				IAllocator * allocator = i_new_allocator != nullptr ? i_new_allocator : MEMO_NEW( Static, *this );
+				return IAllocator::Config::configure_allocator( allocator );
+			}
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			virtual bool try_recognize_property( serialization::IConfigReader & i_config_reader )
+				{ return m_stack.try_recognize_property( i_config_reader ); }
+		};
+
+		/** Constructs the stack of layers */
+		Static( const Config & i_config )
+			: m_stack( i_config.m_stack ) { }
+
+		/** retrieves the stack of layers, that gives access to the functions of the policies (like StatPolicy::Layer::get_stats) */
+		Stack & stack() { return m_stack; }
+
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+			{ return m_stack.alloc( i_size, i_alignment, i_alignment_offset ); }
+
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+			{ return m_stack.realloc( i_address, i_new_size, i_alignment, i_alignment_offset ); }
+
+		void free( void * i_address )
+			{ m_stack.free( i_address ); }
+
+		void free( void * i_address, size_t i_size )
+			{ m_stack.free( i_address, i_size ); }
+
+		void dbg_check( void * i_address )
+			{ m_stack.dbg_check( i_address ); }
+
+		void * unaligned_alloc( size_t i_size )
+			{ return m_stack.unaligned_alloc( i_size ); }
+
+		void * unaligned_realloc( void * i_address, size_t i_new_size )
+			{ return m_stack.unaligned_realloc( i_address, i_new_size ); }
+
+		void unaligned_free( void * i_address )
+			{ m_stack.unaligned_free( i_address ); }
+
+		void unaligned_free( void * i_address, size_t i_size )
+			{ m_stack.unaligned_free( i_address, i_size ); }
+
+		void unaligned_dbg_check( void * i_address )
+			{ m_stack.unaligned_dbg_check( i_address ); }
+
+		/** allocates many aligned memory blocks. Implements IAllocator::alloc_batch. The whole batch is allocated
+			with a single virtual call. */
+		size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+			{
+				o_blocks[ index ] = m_stack.alloc( i_size, i_alignment, i_alignment_offset );
+				if( o_blocks[ index ] == nullptr )
+					return index;
+			}
+			return i_count;
+		}
+
+		/** deallocates many memory blocks. Implements IAllocator::free_batch. The whole batch is freed with
+			a single virtual call. */
+		void free_batch( void * * io_blocks, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				m_stack.free( io_blocks[ index ] );
+		}
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer )
+		{
+			i_state_writer.write( "type", type_name() );
+			m_stack.dump_state( i_state_writer );
+		}
+
+	private:
+		Static( const Static & ); // not implemented
+		Static & operator = ( const Static & ); // not implemented
+
+	private: // data members
+		Stack m_stack;
+	};
+
+} // namespace memo
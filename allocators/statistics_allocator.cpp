@@ -6,6 +6,32 @@ namespace memo
 		size_t m_block_size;
 	};
 	
+	/* Statistics collected by a thread, with eApproximatePeaks. The counters are deltas to be added to the statistics
+		of the allocator, as a thread may free blocks allocated by other threads. The shard is allocated with the default 
+		allocator (the allocator itself can't be used, as it may be the current allocator of the thread).
+		Only the owning thread writes the counters, so they are updated without locks. They are written and read by 
+		other threads with atomic functions, so that get_stats does not read torn values. */
+	struct StatAllocator::Shard : public ThreadRoot::LocalObject
+	{
+		StatAllocator * m_allocator;
+		ThreadRoot * m_thread_root;
+		Shard * m_prev_shard; /**< previous shard of the same allocator, protected by the mutex of the allocator */
+		Shard * m_next_shard; /**< next shard of the same allocator, protected by the mutex of the allocator */
+		volatile size_t m_allocation_count; /**< signed delta, stored in two's complement */
+		volatile size_t m_total_allocated; /**< signed delta, stored in two's complement */
+		void * volatile m_min_address;
+		void * volatile m_max_address;
+		size_t m_operation_count; /**< number of operations since the last fold. Accessed only by the owning thread */
+
+		Shard( StatAllocator & i_allocator, ThreadRoot & i_thread_root )
+			: m_allocator( &i_allocator ), m_thread_root( &i_thread_root ), m_prev_shard( nullptr ), m_next_shard( nullptr ),
+			  m_allocation_count( 0 ), m_total_allocated( 0 ), m_min_address( reinterpret_cast<void*>( std::numeric_limits<uintptr_t>::max() ) ),
+			  m_max_address( nullptr ), m_operation_count( 0 ) { }
+
+		virtual void on_thread_exit()
+			{ m_allocator->destroy_shard( this ); }
+	};
+
 	// StatAllocator::Config::configure_allocator
 	IAllocator * StatAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
 	{
@@ -16,28 +42,196 @@ namespace memo
 			allocator = MEMO_NEW( StatAllocator );
 
 		DecoratorAllocator::Config::configure_allocator( allocator );
+
+		allocator->m_peak_mode = m_peak_mode;
 		
 		return allocator;
 	}
 
+	// StatAllocator::Config::try_recognize_property
+	bool StatAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( DecoratorAllocator::Config::try_recognize_property( i_config_reader ) )
+		{
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "peaks" ) )
+		{
+			const char * peak_mode = i_config_reader.curr_property_vakue_as_string();
+			if( strcmp( peak_mode, "exact" ) == 0 )
+				m_peak_mode = eExactPeaks;
+			else if( strcmp( peak_mode, "approximate" ) == 0 )
+				m_peak_mode = eApproximatePeaks;
+			else
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+
+		return false;
+	}
+
 	StatAllocator::Statistics::Statistics()
 		: m_allocation_count( 0 ), m_allocation_count_peak( 0 ),
 		 m_total_allocated( 0 ), m_total_allocated_peak( 0 ),
-		 m_min_address( ), m_max_address( reinterpret_cast<void*>( std::numeric_limits<uintptr_t>::max() ) )
+		 m_min_address( reinterpret_cast<void*>( std::numeric_limits<uintptr_t>::max() ) ), m_max_address( nullptr )
 	{
 	}
 
 	StatAllocator::StatAllocator()
+		: m_peak_mode( eExactPeaks ), m_first_shard( nullptr )
 	{
 	}
+
+	// StatAllocator::destructor
+	StatAllocator::~StatAllocator()
+	{
+		while( m_first_shard != nullptr )
+		{
+			Shard * shard = m_first_shard;
+			shard->m_thread_root->remove_local_object( shard );
+			destroy_shard( shard );
+		}
+	}
 	
 	void StatAllocator::get_stats( Statistics & o_dest )
 	{
 		MutexLock lock( m_mutex );
+		aggregate_shards( o_dest );
+	}
+
+	// StatAllocator::update_peaks
+	void StatAllocator::update_peaks( Statistics & io_stats )
+	{
+		io_stats.m_allocation_count_peak = std::max( io_stats.m_allocation_count_peak, io_stats.m_allocation_count );
+		io_stats.m_total_allocated_peak = std::max( io_stats.m_total_allocated_peak, io_stats.m_total_allocated );
+	}
+
+	// StatAllocator::aggregate_shards
+	void StatAllocator::aggregate_shards( Statistics & o_dest )
+	{
+		// m_mutex must be locked by the caller
 		o_dest = m_stats;
+		for( Shard * shard = m_first_shard; shard != nullptr; shard = shard->m_next_shard )
+		{
+			// the owning thread may be updating the shard, so the values may be slightly old
+			o_dest.m_allocation_count += memo_externals::atomic_load_size( &shard->m_allocation_count );
+			o_dest.m_total_allocated += memo_externals::atomic_load_size( &shard->m_total_allocated );
+			o_dest.m_min_address = std::min( o_dest.m_min_address, memo_externals::atomic_load_pointer( &shard->m_min_address ) );
+			o_dest.m_max_address = std::max( o_dest.m_max_address, memo_externals::atomic_load_pointer( &shard->m_max_address ) );
+		}
+
+		// the peaks are sampled here, if the statistics are sharded
+		update_peaks( o_dest );
+		m_stats.m_allocation_count_peak = o_dest.m_allocation_count_peak;
+		m_stats.m_total_allocated_peak = o_dest.m_total_allocated_peak;
 	}
 
-	
+	// StatAllocator::update_stats
+	void StatAllocator::update_stats( ptrdiff_t i_count_delta, ptrdiff_t i_size_delta, void * i_block, void * i_block_end )
+	{
+		if( m_peak_mode == eApproximatePeaks )
+		{
+			Shard * shard = get_shard();
+			if( shard != nullptr )
+			{
+				// only this thread writes the shard, so the counters are read with plain reads
+				memo_externals::atomic_store_size( &shard->m_allocation_count, shard->m_allocation_count + static_cast<size_t>( i_count_delta ) );
+				memo_externals::atomic_store_size( &shard->m_total_allocated, shard->m_total_allocated + static_cast<size_t>( i_size_delta ) );
+				if( i_block != nullptr )
+				{
+					if( i_block < shard->m_min_address )
+						memo_externals::atomic_store_pointer( &shard->m_min_address, i_block );
+					if( i_block_end > shard->m_max_address )
+						memo_externals::atomic_store_pointer( &shard->m_max_address, i_block_end );
+				}
+
+				if( ++shard->m_operation_count >= s_fold_period )
+					fold_shard( *shard );
+				return;
+			}
+
+			// threads without a ThreadRoot have no shard
+		}
+
+		MutexLock lock( m_mutex );
+		MEMO_ASSERT( m_peak_mode != eExactPeaks || i_count_delta >= 0 || m_stats.m_allocation_count >= static_cast<size_t>( -i_count_delta ) );
+		MEMO_ASSERT( m_peak_mode != eExactPeaks || i_size_delta >= 0 || m_stats.m_total_allocated >= static_cast<size_t>( -i_size_delta ) );
+		m_stats.m_allocation_count += static_cast<size_t>( i_count_delta );
+		m_stats.m_total_allocated += static_cast<size_t>( i_size_delta );
+		if( i_block != nullptr )
+		{
+			m_stats.m_min_address = std::min( m_stats.m_min_address, i_block );
+			m_stats.m_max_address = std::max( m_stats.m_max_address, i_block_end );
+		}
+		update_peaks( m_stats );
+	}
+
+	// StatAllocator::get_shard
+	StatAllocator::Shard * StatAllocator::get_shard()
+	{
+		ThreadRoot * thread_root = memo_externals::get_thread_root();
+		if( thread_root == nullptr )
+			return nullptr;
+
+		ThreadRoot::LocalObject * local_object = thread_root->find_local_object( this );
+		if( local_object != nullptr )
+			return static_cast<Shard *>( local_object );
+
+		Shard * shard = MEMO_NEW_ALLOC( safe_get_default_allocator(), Shard, *this, *thread_root );
+		if( shard == nullptr )
+			return nullptr;
+
+		{
+			MutexLock lock( m_mutex );
+			shard->m_next_shard = m_first_shard;
+			if( m_first_shard != nullptr )
+				m_first_shard->m_prev_shard = shard;
+			m_first_shard = shard;
+		}
+
+		thread_root->add_local_object( this, shard );
+
+		return shard;
+	}
+
+	/* StatAllocator::fold_shard - moves the counters of the shard to the statistics of the allocator. It must be called
+		by the owning thread of the shard, or when the owning thread can't use it anymore. */
+	void StatAllocator::fold_shard( Shard & i_shard )
+	{
+		MutexLock lock( m_mutex );
+
+		m_stats.m_allocation_count += i_shard.m_allocation_count;
+		m_stats.m_total_allocated += i_shard.m_total_allocated;
+		m_stats.m_min_address = std::min( m_stats.m_min_address, static_cast<void*>( i_shard.m_min_address ) );
+		m_stats.m_max_address = std::max( m_stats.m_max_address, static_cast<void*>( i_shard.m_max_address ) );
+		memo_externals::atomic_store_size( &i_shard.m_allocation_count, 0 );
+		memo_externals::atomic_store_size( &i_shard.m_total_allocated, 0 );
+		i_shard.m_operation_count = 0;
+
+		Statistics stats;
+		aggregate_shards( stats );
+	}
+
+	// StatAllocator::destroy_shard
+	void StatAllocator::destroy_shard( Shard * i_shard )
+	{
+		fold_shard( *i_shard );
+
+		{
+			MutexLock lock( m_mutex );
+			if( i_shard->m_prev_shard != nullptr )
+				i_shard->m_prev_shard->m_next_shard = i_shard->m_next_shard;
+			else
+				m_first_shard = i_shard->m_next_shard;
+			if( i_shard->m_next_shard != nullptr )
+				i_shard->m_next_shard->m_prev_shard = i_shard->m_prev_shard;
+		}
+
+		MEMO_DELETE_ALLOC( safe_get_default_allocator(), i_shard );
+	}
+
+	// StatAllocator::get_size
 	size_t StatAllocator::get_size( void * i_address )
 	{
 		Header * header = static_cast<Header*>( i_address ) - 1;
@@ -59,13 +253,7 @@ namespace memo
 		void * result = header + 1;
 
 		// update stats
-		MutexLock lock( m_mutex );
-		m_stats.m_allocation_count++;
-		m_stats.m_total_allocated += i_size;
-		m_stats.m_allocation_count_peak = std::max( m_stats.m_allocation_count_peak, m_stats.m_allocation_count );
-		m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
-		m_stats.m_min_address = std::min( m_stats.m_min_address, result );
-		m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( result, i_size ) );
+		update_stats( 1, i_size, result, address_add( result, i_size ) );
 
 		// done
 		return result;
@@ -87,34 +275,38 @@ namespace memo
 		void * new_user_block = new_header + 1;
 
 		// update stats
-		MutexLock lock( m_mutex );
-		MEMO_ASSERT( m_stats.m_total_allocated >= prev_size );
-		m_stats.m_total_allocated -= prev_size;
-		m_stats.m_total_allocated += i_new_size;
-		m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
-		m_stats.m_min_address = std::min( m_stats.m_min_address, new_user_block );
-		m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( new_user_block, i_new_size ) );
+		update_stats( 0, static_cast<ptrdiff_t>( i_new_size ) - static_cast<ptrdiff_t>( prev_size ), 
+			new_user_block, address_add( new_user_block, i_new_size ) );
 
 		return new_user_block;	
 	}
 
 	void StatAllocator::free( void * i_address )
 	{
-		if( i_address != nullptr )
-			return;
-
 		Header * const header = static_cast<Header*>( i_address ) - 1;
 		const size_t size = header->m_block_size;
 
 		IAllocator & dest_allocator = this->dest_allocator();
-		dest_allocator.free( header );
+		dest_allocator.free( header, size + sizeof( Header ) );
 
-		// update stats
-		MutexLock lock( m_mutex );
-		MEMO_ASSERT( m_stats.m_allocation_count > 0 );
-		MEMO_ASSERT( m_stats.m_total_allocated >= size );
-		m_stats.m_total_allocated -= size;
-		m_stats.m_allocation_count--;
+		on_free( size );
+	}
+
+	void StatAllocator::free( void * i_address, size_t i_size )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+		MEMO_ASSERT( header->m_block_size == i_size ); // wrong size
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		dest_allocator.free( header, i_size + sizeof( Header ) );
+
+		on_free( i_size );
+	}
+
+	// StatAllocator::on_free
+	void StatAllocator::on_free( size_t i_size )
+	{
+		update_stats( -1, -static_cast<ptrdiff_t>( i_size ), nullptr, nullptr );
 	}
 
 	void StatAllocator::dbg_check( void * i_address )
@@ -126,6 +318,32 @@ namespace memo
 		dest_allocator.dbg_check( header );
 	}
 
+	// StatAllocator::try_expand
+	bool StatAllocator::try_expand( void * i_address, size_t i_new_size )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+		const size_t prev_size = header->m_block_size;
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		if( !dest_allocator.try_expand( header, i_new_size + sizeof( Header ) ) )
+			return false;
+
+		header->m_block_size = i_new_size;
+		update_stats( 0, static_cast<ptrdiff_t>( i_new_size ) - static_cast<ptrdiff_t>( prev_size ), 
+			i_address, address_add( i_address, i_new_size ) );
+		return true;
+	}
+
+	// StatAllocator::usable_size
+	size_t StatAllocator::usable_size( void * i_address )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		const size_t size = dest_allocator.usable_size( header );
+		return size > sizeof( Header ) ? size - sizeof( Header ) : 0;
+	}
+
 	void * StatAllocator::unaligned_alloc( size_t i_size )
 	{
 		IAllocator & dest_allocator = this->dest_allocator();
@@ -140,13 +358,7 @@ namespace memo
 		void * result = header + 1;
 
 		// update stats
-		MutexLock lock( m_mutex );
-		m_stats.m_allocation_count++;
-		m_stats.m_total_allocated += i_size;
-		m_stats.m_allocation_count_peak = std::max( m_stats.m_allocation_count_peak, m_stats.m_allocation_count );
-		m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
-		m_stats.m_min_address = std::min( m_stats.m_min_address, result );
-		m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( result, i_size ) );
+		update_stats( 1, i_size, result, address_add( result, i_size ) );
 
 		// done
 		return result;
@@ -167,13 +379,8 @@ namespace memo
 		void * new_user_block = new_header + 1;
 
 		// update stats
-		MutexLock lock( m_mutex );
-		MEMO_ASSERT( m_stats.m_total_allocated >= prev_size );
-		m_stats.m_total_allocated -= prev_size;
-		m_stats.m_total_allocated += i_new_size;
-		m_stats.m_total_allocated_peak = std::max( m_stats.m_total_allocated_peak, m_stats.m_total_allocated );
-		m_stats.m_min_address = std::min( m_stats.m_min_address, new_user_block );
-		m_stats.m_max_address = std::max( m_stats.m_max_address, address_add( new_user_block, i_new_size ) );
+		update_stats( 0, static_cast<ptrdiff_t>( i_new_size ) - static_cast<ptrdiff_t>( prev_size ), 
+			new_user_block, address_add( new_user_block, i_new_size ) );
 
 		return new_user_block;
 	}
@@ -184,14 +391,20 @@ namespace memo
 		const size_t size = header->m_block_size;
 
 		IAllocator & dest_allocator = this->dest_allocator();
-		dest_allocator.unaligned_free( header );
+		dest_allocator.unaligned_free( header, size + sizeof( Header ) );
 
-		// update stats
-		MutexLock lock( m_mutex );
-		MEMO_ASSERT( m_stats.m_allocation_count > 0 );
-		MEMO_ASSERT( m_stats.m_total_allocated >= size );
-		m_stats.m_total_allocated -= size;
-		m_stats.m_allocation_count--;
+		on_free( size );
+	}
+
+	void StatAllocator::unaligned_free( void * i_address, size_t i_size )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+		MEMO_ASSERT( header->m_block_size == i_size ); // wrong size
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		dest_allocator.unaligned_free( header, i_size + sizeof( Header ) );
+
+		on_free( i_size );
 	}
 
 	void StatAllocator::unaligned_dbg_check( void * i_address )
@@ -203,6 +416,80 @@ namespace memo
 		dest_allocator.unaligned_dbg_check( header );
 	}
 
+	// StatAllocator::unaligned_try_expand
+	bool StatAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+		const size_t prev_size = header->m_block_size;
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		if( !dest_allocator.unaligned_try_expand( header, i_new_size + sizeof( Header ) ) )
+			return false;
+
+		header->m_block_size = i_new_size;
+		update_stats( 0, static_cast<ptrdiff_t>( i_new_size ) - static_cast<ptrdiff_t>( prev_size ), 
+			i_address, address_add( i_address, i_new_size ) );
+		return true;
+	}
+
+	// StatAllocator::unaligned_usable_size
+	size_t StatAllocator::unaligned_usable_size( void * i_address )
+	{
+		Header * const header = static_cast<Header*>( i_address ) - 1;
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		const size_t size = dest_allocator.unaligned_usable_size( header );
+		return size > sizeof( Header ) ? size - sizeof( Header ) : 0;
+	}
+
+	// StatAllocator::alloc_batch
+	size_t StatAllocator::alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+	{
+		IAllocator & dest_allocator = this->dest_allocator();
+
+		// alloc
+		const size_t count = dest_allocator.alloc_batch( i_count, i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ), o_blocks );
+		if( count == 0 )
+			return 0;
+
+		// setup headers
+		void * min_address = o_blocks[ 0 ], * max_address = o_blocks[ 0 ];
+		for( size_t index = 0; index < count; index++ )
+		{
+			Header * header = static_cast<Header *>( o_blocks[ index ] );
+			header->m_block_size = i_size;
+			void * result = header + 1;
+			o_blocks[ index ] = result;
+			min_address = std::min( min_address, result );
+			max_address = std::max( max_address, address_add( result, i_size ) );
+		}
+
+		// update stats
+		update_stats( static_cast<ptrdiff_t>( count ), static_cast<ptrdiff_t>( count * i_size ), min_address, max_address );
+
+		// done
+		return count;
+	}
+
+	// StatAllocator::free_batch
+	void StatAllocator::free_batch( void * * io_blocks, size_t i_count )
+	{
+		// replace the addresses of the blocks with the addresses of the headers
+		size_t total_size = 0;
+		for( size_t index = 0; index < i_count; index++ )
+		{
+			Header * const header = static_cast<Header*>( io_blocks[ index ] ) - 1;
+			total_size += header->m_block_size;
+			io_blocks[ index ] = header;
+		}
+
+		IAllocator & dest_allocator = this->dest_allocator();
+		dest_allocator.free_batch( io_blocks, i_count );
+
+		// update stats
+		update_stats( -static_cast<ptrdiff_t>( i_count ), -static_cast<ptrdiff_t>( total_size ), nullptr, nullptr );
+	}
+
 	// StatAllocator::dump_state
 	void StatAllocator::dump_state( StateWriter & i_state_writer )
 	{
@@ -210,6 +497,7 @@ namespace memo
 		get_stats( statistics );
 
 		i_state_writer.write( "type", "stats" );
+		i_state_writer.write( "peaks", m_peak_mode == eExactPeaks ? "exact" : "approximate" );
 		i_state_writer.write_uint( "allocation_count", statistics.m_allocation_count );
 		i_state_writer.write_mem_size( "total_allocated", statistics.m_total_allocated );
 		i_state_writer.write_uint( "allocation_count_peak", statistics.m_allocation_count_peak );
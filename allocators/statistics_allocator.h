@@ -8,8 +8,11 @@ namespace memo
 		The following parameters are supported in the configuration file:
 		- target: inherited from DecoratorAllocator, is the name of the type of target allocator (for example "default_allocator", 
 			"debug_allocator", "stat_allocator").
+		- peaks: "exact" or "approximate". See StatAllocator::PeakMode. The default is "exact".
 
-		\note This class uses a mutex to ensure thread-safeness.
+		\note This class uses a mutex to ensure thread-safeness. With approximate peaks, every thread with a ThreadRoot
+			updates its own shard of the statistics, so threads do not contend for the mutex of the allocator.
+			The allocator can be destroyed only when no other thread is using it.
 	*/
 	class StatAllocator : public DecoratorAllocator
 	{
@@ -19,6 +22,9 @@ namespace memo
 
 		/** default constructor. The dest allocator must be assigned before using the allocator (see DecoratorAllocator::set_dest_allocator) */
 		StatAllocator();
+
+		/** destroys the shards of the statistics, if any */
+		~StatAllocator();
 		
 
 							//// statistics ////
@@ -38,11 +44,29 @@ namespace memo
 			Statistics();
 		};
 
-		/** retrieves the current statistics of this allocator
+		/** Specifies how the statistics are collected, and the accuracy of the peaks */
+		enum PeakMode
+		{
+			eExactPeaks, /**< the statistics are updated under the mutex of the allocator on every operation, so the 
+							peaks are exact, but all the threads using the allocator are serialized */
+			eApproximatePeaks, /**< every thread updates its own shard of the statistics without locking. The 
+							shards are folded in the statistics of the allocator every s_fold_period operations and when 
+							the thread exits, and they are aggregated by get_stats.
+							The counters returned by get_stats are exact when the other threads are not using the 
+							allocator, but the peaks are evaluated only when the shards are aggregated or folded, so they may be lower than the actual ones. */
+		};
+
+		/** number of operations after which a shard is folded in the statistics of the allocator, with eApproximatePeaks */
+		static const size_t s_fold_period = 256;
+
+		/** retrieves the current statistics of this allocator. With eApproximatePeaks all the shards are aggregated.
 		  @param o_dest struct instance to be written
 		*/
 		void get_stats( Statistics & o_dest );
 
+		/** retrieves the peak mode of this allocator */
+		PeakMode peak_mode() const { return m_peak_mode; }
+
 
 		/** retrieves the size of a memory block allocated by alloc, realloc unaligned_alloc or unaligned_realloc.
 		  @param i_address address of the memory block. It can't be nullptr.
@@ -55,10 +79,21 @@ namespace memo
 
 		struct Config : public DecoratorAllocator::Config
 		{
+		public:
+
+			PeakMode m_peak_mode; /**< specifies how the statistics are collected. The default is eExactPeaks */
+
+			Config() : m_peak_mode( eExactPeaks ) { }
+
 		protected:
 
 			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
 			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			virtual bool try_recognize_property( serialization::IConfigReader & i_config_reader );
 		};
 
 
@@ -90,11 +125,33 @@ namespace memo
 		  */
 		void free( void * i_address );
 
+		/** \brief deallocates a memory block allocated by alloc or realloc, whose size is known. Implements IAllocator::free.
+			The size of the block is not read from the header, unless assertions are enabled.
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block
+		  */
+		void free( void * i_address, size_t i_size );
+
 		/** \brief Implements IAllocator::dbg_check. Some basic checks is performed on the memory block.
 		  @param i_address address of the memory block to check
 		*/
 		void dbg_check( void * i_address );
 
+		/** \brief tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			The dest allocator is used to perform the operation, and if it succeeds the statistics are updated.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise
+		*/
+		bool try_expand( void * i_address, size_t i_new_size );
+
+		/** \brief retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+			The dest allocator is used to perform the operation.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block, or 0 if the dest allocator does not know it
+		*/
+		size_t usable_size( void * i_address );
+
 
 
 
@@ -121,21 +178,75 @@ namespace memo
 		  */
 		void unaligned_free( void * i_address );
 
+		/** \brief deallocates a memory block allocated by unaligned_alloc or unaligned_realloc, whose size is known. 
+			Implements IAllocator::unaligned_free. The size of the block is not read from the header, unless assertions are enabled.
+		  @param i_address address of the memory block to free. It cannot be nullptr.
+		  @param i_size size of the block
+		  */
+		void unaligned_free( void * i_address, size_t i_size );
+
 		/** \brief This function performs no action. Implements IAllocator::unaligned_dbg_check.
 		  The dest allocator is used to perform the operation. See DecoratorAllocator.
 		  @param i_address address of the memory block to check
 		*/
 		void unaligned_dbg_check( void * i_address );
 
+		/** \brief tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it. 
+			Implements IAllocator::unaligned_try_expand. The dest allocator is used to perform the operation, and if it 
+			succeeds the statistics are updated.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise
+		*/
+		bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+		/** \brief retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc. 
+			Implements IAllocator::unaligned_usable_size. The dest allocator is used to perform the operation.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block, or 0 if the dest allocator does not know it
+		*/
+		size_t unaligned_usable_size( void * i_address );
+
+
+							///// batch allocations /////
+
+		/** \brief allocates many aligned memory blocks. Implements IAllocator::alloc_batch.
+		  The dest allocator is used to perform the operation, and the statistics are updated locking the mutex once.
+		  @param i_count number of blocks to allocate
+		  @param i_size size of every block in bytes
+		  @param i_alignment alignment requested for every block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of every block of the address that respects the alignment
+		  @param o_blocks array that receives the addresses of the blocks
+		  @return number of blocks allocated
+		*/
+		size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks );
+
+		/** \brief deallocates many memory blocks allocated by alloc, realloc or alloc_batch. Implements IAllocator::free_batch.
+		  The dest allocator is used to perform the operation, and the statistics are updated locking the mutex once.
+		  @param io_blocks array of the addresses of the blocks to free
+		  @param i_count number of blocks to free
+		*/
+		void free_batch( void * * io_blocks, size_t i_count );
+
 		/** Writes out in a human readable way the state of the allocator */
 		void dump_state( StateWriter & i_state_writer );
 
 	private: // data members
+		struct Shard;
 		Statistics m_stats;
 		memo_externals::Mutex m_mutex;
+		PeakMode m_peak_mode;
+		Shard * m_first_shard; /**< list of the shards, protected by m_mutex */
 
 	private: // internal services
 		struct Header;
+		void update_stats( ptrdiff_t i_count_delta, ptrdiff_t i_size_delta, void * i_block, void * i_block_end );
+		void on_free( size_t i_size );
+		Shard * get_shard();
+		void fold_shard( Shard & i_shard );
+		void destroy_shard( Shard * i_shard );
+		void aggregate_shards( Statistics & o_dest );
+		static void update_peaks( Statistics & io_stats );
 	};
 
 } // namespace memo
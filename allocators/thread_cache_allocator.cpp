@@ -0,0 +1,451 @@
+
+namespace memo
+{
+	struct ThreadCacheAllocator::Header
+	{
+		size_t m_size_class; /**< size class of the block, or s_not_cached if the block does not pass through the caches */
+
+		static const size_t s_not_cached = ~static_cast<size_t>( 0 );
+	};
+
+	/* Magazines of a thread. The block pointers of all the size classes are stored in a single buffer, allocated
+		with the default allocator (the allocator itself can't be used, as it may be the current allocator of the thread). */
+	struct ThreadCacheAllocator::ThreadCache : public ThreadRoot::LocalObject
+	{
+		ThreadCacheAllocator * m_allocator;
+		ThreadRoot * m_thread_root;
+		ThreadCache * m_prev_cache; /**< previous cache of the same allocator, protected by the mutex of the allocator */
+		ThreadCache * m_next_cache; /**< next cache of the same allocator, protected by the mutex of the allocator */
+		volatile size_t * m_block_counts; /**< number of blocks in every magazine. Only the owning thread writes them, with atomic_store_size, as dump_state reads them */
+		void * * m_blocks; /**< m_magazine_size pointers for every size class */
+
+		ThreadCache( ThreadCacheAllocator & i_allocator, ThreadRoot & i_thread_root )
+			: m_allocator( &i_allocator ), m_thread_root( &i_thread_root ),
+			  m_prev_cache( nullptr ), m_next_cache( nullptr ), m_block_counts( nullptr ), m_blocks( nullptr ) { }
+
+		void * * magazine( size_t i_size_class )
+			{ return m_blocks + i_size_class * m_allocator->m_magazine_size; }
+
+		virtual void on_thread_exit()
+			{ m_allocator->destroy_thread_cache( this ); }
+	};
+
+	// ThreadCacheAllocator::Config::configure_allocator
+	IAllocator * ThreadCacheAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+	{
+		ThreadCacheAllocator * allocator;
+		if( i_new_allocator != nullptr )
+			allocator = static_cast< ThreadCacheAllocator * >( i_new_allocator );
+		else
+			allocator = MEMO_NEW( ThreadCacheAllocator, *this );
+
+		DecoratorAllocator::Config::configure_allocator( allocator );
+
+		return allocator;
+	}
+
+	// ThreadCacheAllocator::Config::try_recognize_property
+	bool ThreadCacheAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( DecoratorAllocator::Config::try_recognize_property( i_config_reader ) )
+		{
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "max_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "magazine_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_magazine_size ) || m_magazine_size < 2 )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// ThreadCacheAllocator::constructor
+	ThreadCacheAllocator::ThreadCacheAllocator( const Config & i_config )
+		: m_first_thread_cache( nullptr )
+	{
+		m_class_count = ( std::max<size_t>( i_config.m_max_size, 1 ) + s_size_class_granularity - 1 ) / s_size_class_granularity;
+		m_max_size = m_class_count * s_size_class_granularity;
+		m_magazine_size = std::max<size_t>( i_config.m_magazine_size, 2 );
+	}
+
+	// ThreadCacheAllocator::destructor
+	ThreadCacheAllocator::~ThreadCacheAllocator()
+	{
+		while( m_first_thread_cache != nullptr )
+		{
+			ThreadCache * thread_cache = m_first_thread_cache;
+			thread_cache->m_thread_root->remove_local_object( thread_cache );
+			destroy_thread_cache( thread_cache );
+		}
+	}
+
+	// ThreadCacheAllocator::flush_thread_cache
+	void ThreadCacheAllocator::flush_thread_cache()
+	{
+		ThreadRoot * thread_root = memo_externals::get_thread_root();
+		if( thread_root != nullptr )
+		{
+			ThreadCache * thread_cache = static_cast<ThreadCache *>( thread_root->find_local_object( this ) );
+			if( thread_cache != nullptr )
+			{
+				for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+					drain( *thread_cache, size_class, thread_cache->m_block_counts[ size_class ] );
+			}
+		}
+	}
+
+	// ThreadCacheAllocator::get_thread_cache
+	ThreadCacheAllocator::ThreadCache * ThreadCacheAllocator::get_thread_cache()
+	{
+		ThreadRoot * thread_root = memo_externals::get_thread_root();
+		if( thread_root == nullptr )
+			return nullptr;
+
+		ThreadRoot::LocalObject * local_object = thread_root->find_local_object( this );
+		if( local_object != nullptr )
+			return static_cast<ThreadCache *>( local_object );
+
+		return create_thread_cache( *thread_root );
+	}
+
+	// ThreadCacheAllocator::create_thread_cache
+	ThreadCacheAllocator::ThreadCache * ThreadCacheAllocator::create_thread_cache( ThreadRoot & i_thread_root )
+	{
+		DefaultAllocator & default_allocator = safe_get_default_allocator();
+
+		const size_t buffer_size = m_class_count * ( sizeof( size_t ) + m_magazine_size * sizeof( void * ) );
+		void * buffer = default_allocator.unaligned_alloc( buffer_size );
+		if( buffer == nullptr )
+			return nullptr;
+
+		ThreadCache * thread_cache = MEMO_NEW_ALLOC( default_allocator, ThreadCache, *this, i_thread_root );
+		thread_cache->m_block_counts = static_cast<volatile size_t *>( buffer );
+		thread_cache->m_blocks = static_cast<void * *>( address_add( buffer, m_class_count * sizeof( size_t ) ) );
+		for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+			thread_cache->m_block_counts[ size_class ] = 0;
+
+		{
+			MutexLock lock( m_mutex );
+			thread_cache->m_next_cache = m_first_thread_cache;
+			if( m_first_thread_cache != nullptr )
+				m_first_thread_cache->m_prev_cache = thread_cache;
+			m_first_thread_cache = thread_cache;
+		}
+
+		i_thread_root.add_local_object( this, thread_cache );
+
+		return thread_cache;
+	}
+
+	// ThreadCacheAllocator::destroy_thread_cache
+	void ThreadCacheAllocator::destroy_thread_cache( ThreadCache * i_thread_cache )
+	{
+		for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+			drain( *i_thread_cache, size_class, i_thread_cache->m_block_counts[ size_class ] );
+
+		{
+			MutexLock lock( m_mutex );
+			if( i_thread_cache->m_prev_cache != nullptr )
+				i_thread_cache->m_prev_cache->m_next_cache = i_thread_cache->m_next_cache;
+			else
+				m_first_thread_cache = i_thread_cache->m_next_cache;
+			if( i_thread_cache->m_next_cache != nullptr )
+				i_thread_cache->m_next_cache->m_prev_cache = i_thread_cache->m_prev_cache;
+		}
+
+		DefaultAllocator & default_allocator = safe_get_default_allocator();
+		default_allocator.unaligned_free( const_cast<size_t *>( i_thread_cache->m_block_counts ) );
+		MEMO_DELETE_ALLOC( default_allocator, i_thread_cache );
+	}
+
+	// ThreadCacheAllocator::refill
+	void ThreadCacheAllocator::refill( ThreadCache & i_thread_cache, size_t i_size_class )
+	{
+		void * * magazine = i_thread_cache.magazine( i_size_class );
+		const size_t block_count = i_thread_cache.m_block_counts[ i_size_class ];
+		const size_t block_size = size_of_class( i_size_class ) + sizeof( Header );
+		const size_t target_count = m_magazine_size / 2;
+
+		if( block_count >= target_count )
+			return;
+
+		void * * new_blocks = magazine + block_count;
+		size_t new_block_count;
+		{
+			MutexLock lock( m_mutex );
+			new_block_count = dest_allocator().alloc_batch( target_count - block_count, block_size, MEMO_MIN_ALIGNMENT, sizeof( Header ), new_blocks );
+		}
+
+		for( size_t index = 0; index < new_block_count; index++ )
+		{
+			Header * header = static_cast<Header *>( new_blocks[ index ] );
+			header->m_size_class = i_size_class;
+			new_blocks[ index ] = header + 1;
+		}
+		memo_externals::atomic_store_size( &i_thread_cache.m_block_counts[ i_size_class ], block_count + new_block_count );
+	}
+
+	// ThreadCacheAllocator::drain
+	void ThreadCacheAllocator::drain( ThreadCache & i_thread_cache, size_t i_size_class, size_t i_block_count )
+	{
+		void * * magazine = i_thread_cache.magazine( i_size_class );
+		MEMO_ASSERT( i_block_count <= i_thread_cache.m_block_counts[ i_size_class ] );
+
+		const size_t block_count = i_thread_cache.m_block_counts[ i_size_class ] - i_block_count;
+		memo_externals::atomic_store_size( &i_thread_cache.m_block_counts[ i_size_class ], block_count );
+		void * * blocks = magazine + block_count;
+		for( size_t index = 0; index < i_block_count; index++ )
+			blocks[ index ] = static_cast<Header *>( blocks[ index ] ) - 1;
+
+		MutexLock lock( m_mutex );
+		dest_allocator().free_batch( blocks, i_block_count );
+	}
+
+	// ThreadCacheAllocator::cached_alloc
+	void * ThreadCacheAllocator::cached_alloc( size_t i_size )
+	{
+		const size_t size_class = size_class_of( i_size );
+
+		ThreadCache * thread_cache = get_thread_cache();
+		if( thread_cache == nullptr )
+		{
+			// no cache for this thread, allocate directly a block of the size class
+			Header * header;
+			{
+				MutexLock lock( m_mutex );
+				header = static_cast<Header *>( dest_allocator().alloc( size_of_class( size_class ) + sizeof( Header ), MEMO_MIN_ALIGNMENT, sizeof( Header ) ) );
+			}
+			if( header == nullptr )
+				return nullptr;
+			header->m_size_class = size_class;
+			return header + 1;
+		}
+
+		size_t block_count = thread_cache->m_block_counts[ size_class ];
+		if( block_count == 0 )
+		{
+			refill( *thread_cache, size_class );
+			block_count = thread_cache->m_block_counts[ size_class ];
+			if( block_count == 0 )
+				return nullptr;
+		}
+
+		memo_externals::atomic_store_size( &thread_cache->m_block_counts[ size_class ], --block_count );
+		return thread_cache->magazine( size_class )[ block_count ];
+	}
+
+	// ThreadCacheAllocator::cached_free
+	void ThreadCacheAllocator::cached_free( Header * i_header )
+	{
+		const size_t size_class = i_header->m_size_class;
+		MEMO_ASSERT( size_class < m_class_count );
+
+		ThreadCache * thread_cache = get_thread_cache();
+		if( thread_cache == nullptr )
+		{
+			MutexLock lock( m_mutex );
+			dest_allocator().free( i_header );
+			return;
+		}
+
+		if( thread_cache->m_block_counts[ size_class ] == m_magazine_size )
+			drain( *thread_cache, size_class, m_magazine_size / 2 );
+
+		const size_t block_count = thread_cache->m_block_counts[ size_class ];
+		thread_cache->magazine( size_class )[ block_count ] = i_header + 1;
+		memo_externals::atomic_store_size( &thread_cache->m_block_counts[ size_class ], block_count + 1 );
+	}
+
+	// ThreadCacheAllocator::cached_realloc
+	void * ThreadCacheAllocator::cached_realloc( Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+	{
+		const size_t prev_size = size_of_class( i_header->m_size_class );
+		void * prev_block = i_header + 1;
+
+		// the block is not moved if it's big enough and it respects the requested alignment
+		if( i_new_size <= prev_size && ( !i_aligned || is_aligned( address_add( prev_block, i_alignment_offset ), i_alignment ) ) )
+			return prev_block;
+
+		void * new_block = i_aligned ? alloc( i_new_size, i_alignment, i_alignment_offset ) : unaligned_alloc( i_new_size );
+		if( new_block == nullptr )
+			return nullptr;
+
+		memcpy( new_block, prev_block, std::min( prev_size, i_new_size ) );
+		cached_free( i_header );
+		return new_block;
+	}
+
+	// ThreadCacheAllocator::alloc
+	void * ThreadCacheAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		if( is_cacheable( i_size, i_alignment, i_alignment_offset ) )
+			return cached_alloc( i_size );
+
+		Header * header;
+		{
+			MutexLock lock( m_mutex );
+			header = static_cast<Header *>( dest_allocator().alloc( i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+		}
+		if( header == nullptr )
+			return nullptr;
+
+		header->m_size_class = Header::s_not_cached;
+		return header + 1;
+	}
+
+	// ThreadCacheAllocator::realloc
+	void * ThreadCacheAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_cached )
+			return cached_realloc( header, i_new_size, i_alignment, i_alignment_offset, true );
+
+		Header * new_header;
+		{
+			MutexLock lock( m_mutex );
+			new_header = static_cast<Header *>( dest_allocator().realloc( header, i_new_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+		}
+		if( new_header == nullptr )
+			return nullptr;
+
+		return new_header + 1;
+	}
+
+	// ThreadCacheAllocator::free
+	void ThreadCacheAllocator::free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_cached )
+		{
+			cached_free( header );
+		}
+		else
+		{
+			MutexLock lock( m_mutex );
+			dest_allocator().free( header );
+		}
+	}
+
+	// ThreadCacheAllocator::dbg_check
+	void ThreadCacheAllocator::dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		MEMO_ASSERT( header->m_size_class == Header::s_not_cached || header->m_size_class < m_class_count );
+
+		MutexLock lock( m_mutex );
+		dest_allocator().dbg_check( header );
+	}
+
+	// ThreadCacheAllocator::unaligned_alloc
+	void * ThreadCacheAllocator::unaligned_alloc( size_t i_size )
+	{
+		if( i_size <= m_max_size )
+			return cached_alloc( i_size );
+
+		Header * header;
+		{
+			MutexLock lock( m_mutex );
+			header = static_cast<Header *>( dest_allocator().unaligned_alloc( i_size + sizeof( Header ) ) );
+		}
+		if( header == nullptr )
+			return nullptr;
+
+		header->m_size_class = Header::s_not_cached;
+		return header + 1;
+	}
+
+	// ThreadCacheAllocator::unaligned_realloc
+	void * ThreadCacheAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_cached )
+			return cached_realloc( header, i_new_size, 0, 0, false );
+
+		Header * new_header;
+		{
+			MutexLock lock( m_mutex );
+			new_header = static_cast<Header *>( dest_allocator().unaligned_realloc( header, i_new_size + sizeof( Header ) ) );
+		}
+		if( new_header == nullptr )
+			return nullptr;
+
+		return new_header + 1;
+	}
+
+	// ThreadCacheAllocator::unaligned_free
+	void ThreadCacheAllocator::unaligned_free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_cached )
+		{
+			// cached blocks are always allocated with the aligned functions of the dest allocator
+			cached_free( header );
+		}
+		else
+		{
+			MutexLock lock( m_mutex );
+			dest_allocator().unaligned_free( header );
+		}
+	}
+
+	// ThreadCacheAllocator::unaligned_dbg_check
+	void ThreadCacheAllocator::unaligned_dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+
+		MutexLock lock( m_mutex );
+		if( header->m_size_class != Header::s_not_cached )
+		{
+			MEMO_ASSERT( header->m_size_class < m_class_count );
+			dest_allocator().dbg_check( header );
+		}
+		else
+			dest_allocator().unaligned_dbg_check( header );
+	}
+
+	// ThreadCacheAllocator::dump_state
+	void ThreadCacheAllocator::dump_state( StateWriter & i_state_writer )
+	{
+		size_t thread_cache_count = 0, cached_memory = 0;
+		{
+			MutexLock lock( m_mutex );
+			for( ThreadCache * thread_cache = m_first_thread_cache; thread_cache != nullptr; thread_cache = thread_cache->m_next_cache )
+			{
+				thread_cache_count++;
+				for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+					cached_memory += memo_externals::atomic_load_size( &thread_cache->m_block_counts[ size_class ] ) * size_of_class( size_class ); // approximate, the counts are owned by the threads
+			}
+		}
+
+		i_state_writer.write( "type", "thread_cache" );
+		i_state_writer.write_mem_size( "max_size", m_max_size );
+		i_state_writer.write_uint( "magazine_size", m_magazine_size );
+		i_state_writer.write_uint( "thread_cache_count", thread_cache_count );
+		i_state_writer.write_mem_size( "cached_memory", cached_memory );
+
+		DecoratorAllocator::dump_state( i_state_writer );
+	}
+
+} // namespace memo
@@ -0,0 +1,158 @@
+
+namespace memo
+{
+	/**	\class ThreadCacheAllocator
+		Decorator allocator that keeps, for every thread, a cache of free memory blocks split in size classes (magazines).
+		Small allocations and deallocations are served by the magazines of the calling thread, without any lock or
+		atomic operation. When a magazine is empty it is refilled with a batch of blocks allocated by the target
+		allocator, and when it is full half of it is drained back to the target. The target allocator is always accessed
+		under a mutex, so it does not need to be thread-safe.
+		Blocks bigger than the maximum cached size, or requiring an alignment bigger than MEMO_MIN_ALIGNMENT, are
+		allocated directly by the target. A size_t is added as overhead to every memory block, to store its size class.
+		The caches are linked to the ThreadRoot of every thread, and are drained when the thread exits. Threads without
+		a ThreadRoot bypass the cache.
+		A block can be freed by any thread: in this case it goes in the cache of the thread that frees it.
+
+		The following parameters are supported in the configuration file:
+		- target: inherited from DecoratorAllocator, is the name of the type of target allocator (for example "default_allocator",
+			"tlsf_allocator").
+		- max_size: maximum size of the blocks served by the thread caches. The default is 256.
+		- magazine_size: maximum number of blocks cached by every thread for every size class. Magazines are refilled and
+			drained by half of this count. The default is 64.
+
+		\note The allocator can be destroyed only when no other thread is using it. */
+	class ThreadCacheAllocator : public DecoratorAllocator
+	{
+	public:
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name() { return "thread_cache_allocator"; }
+
+
+								///// configuration /////
+
+		/** Config structure for ThreadCacheAllocator */
+		struct Config : public DecoratorAllocator::Config
+		{
+		public:
+
+			size_t m_max_size; /**< maximum size of the blocks served by the thread caches */
+			size_t m_magazine_size; /**< maximum number of blocks cached by every thread for every size class */
+
+			Config()
+				: m_max_size( 256 ), m_magazine_size( 64 ) { }
+
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+		};
+
+		/** Constructs the allocator. The dest allocator is created by the config structure (see DecoratorAllocator::Config) */
+		ThreadCacheAllocator( const Config & i_config );
+
+		/** Drains all the thread caches, and destroys the allocator */
+		~ThreadCacheAllocator();
+
+		/** Gives back to the dest allocator all the blocks cached by the calling thread */
+		void flush_thread_cache();
+
+
+								///// aligned allocations /////
+
+		/** allocates an aligned memory block. Implements IAllocator::alloc.
+			Small blocks are taken from the cache of the calling thread, the others are allocated by the dest allocator.
+		  @param i_size size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from the address that respects the alignment
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+			Small blocks are put in the cache of the calling thread.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void free( void * i_address );
+
+		/** Implements IAllocator::dbg_check. The check is performed by the dest allocator.
+		  @param i_address address of the memory block to check */
+		void dbg_check( void * i_address );
+
+
+							///// unaligned allocations /////
+
+		/** allocates a new memory block. Implements IAllocator::unaligned_alloc.
+			Small blocks are taken from the cache of the calling thread, the others are allocated by the dest allocator.
+		  @param i_size size of the block in bytes
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * unaligned_alloc( size_t i_size );
+
+		/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+		/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+			Small blocks are put in the cache of the calling thread.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void unaligned_free( void * i_address );
+
+		/** Implements IAllocator::unaligned_dbg_check. The check is performed by the dest allocator.
+		  @param i_address address of the memory block to check */
+		void unaligned_dbg_check( void * i_address );
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer );
+
+	private:
+		ThreadCacheAllocator( const ThreadCacheAllocator & ); // not implemented
+		ThreadCacheAllocator & operator = ( const ThreadCacheAllocator & ); // not implemented
+
+		struct Header;
+		struct ThreadCache;
+
+		static const size_t s_size_class_granularity = 16;
+
+		static size_t size_class_of( size_t i_size )
+			{ return i_size > 0 ? ( i_size - 1 ) / s_size_class_granularity : 0; }
+
+		static size_t size_of_class( size_t i_size_class )
+			{ return ( i_size_class + 1 ) * s_size_class_granularity; }
+
+		bool is_cacheable( size_t i_size, size_t i_alignment, size_t i_alignment_offset ) const
+			{ return i_size <= m_max_size && i_alignment <= MEMO_MIN_ALIGNMENT && ( i_alignment_offset & ( i_alignment - 1 ) ) == 0; }
+
+		ThreadCache * get_thread_cache();
+		ThreadCache * create_thread_cache( ThreadRoot & i_thread_root );
+		void destroy_thread_cache( ThreadCache * i_thread_cache );
+
+		void * cached_alloc( size_t i_size );
+		void cached_free( Header * i_header );
+		void * cached_realloc( Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+
+		void refill( ThreadCache & i_thread_cache, size_t i_size_class );
+		void drain( ThreadCache & i_thread_cache, size_t i_size_class, size_t i_block_count );
+
+	private: // data members
+		size_t m_max_size;
+		size_t m_class_count;
+		size_t m_magazine_size;
+		memo_externals::Mutex m_mutex; /**< protects the dest allocator and the list of thread caches */
+		ThreadCache * m_first_thread_cache;
+	};
+
+} // namespace memo
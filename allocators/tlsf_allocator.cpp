@@ -23,10 +23,63 @@
 			return allocator;
 		}
 
+		// TlsfAllocator::Config::try_recognize_property
+		bool TlsfAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+		{
+			if( RegionAllocator::Config::try_recognize_property( i_config_reader ) )
+			{
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "growth" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_growth_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "max_size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				else if( i_config_reader.try_recognize_property( "discard_threshold" ) )
+				{
+					if( !i_config_reader.curr_property_vakue_as_uint( &m_discard_threshold ) )
+						i_config_reader.output_message( serialization::eWrongContent );
+
+					return true;
+				}
+			#endif
+			else if( i_config_reader.try_recognize_property( "release_free_regions" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strcmp( value, "true" ) == 0 )
+					m_release_free_regions = true;
+				else if( strcmp( value, "false" ) == 0 )
+					m_release_free_regions = false;
+				else
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+
+			return false;
+		}
+
 		// TlsfAllocator::constructor
 		TlsfAllocator::TlsfAllocator( const TlsfAllocator::Config & i_config )
-			: RegionAllocator( i_config, tlsf_overhead() ), m_tlsf( nullptr )
+			: RegionAllocator( i_config, tlsf_overhead() ), m_tlsf( nullptr ), m_first_extra_region( nullptr ),
+			  m_growth_size( i_config.m_growth_size ), m_max_size( i_config.m_max_size ), m_total_size( buffer_size() ),
+			  m_release_free_regions( i_config.m_release_free_regions )
 		{
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				// the pages can be discarded only if they have been reserved from the virtual memory
+				m_discard_threshold = uses_virtual_memory() ? i_config.m_discard_threshold : 0;
+			#endif
+
 			void * region_buffer = buffer();
 			if( region_buffer != nullptr )
 				m_tlsf = tlsf_create( region_buffer, buffer_size() );
@@ -35,31 +88,281 @@
 		// TlsfAllocator::destructor
 		TlsfAllocator::~TlsfAllocator()
 		{
+			while( m_first_extra_region != nullptr )
+				release_extra_region( m_first_extra_region );
+
 			if( m_tlsf != nullptr )
 				tlsf_destroy( m_tlsf );
 		}
 
+		// TlsfAllocator::region_count
+		size_t TlsfAllocator::region_count() const
+		{
+			size_t count = 1;
+			for( ExtraRegion * region = m_first_extra_region; region != nullptr; region = region->m_next )
+				count++;
+			return count;
+		}
+
+		// TlsfAllocator::find_extra_region
+		TlsfAllocator::ExtraRegion * TlsfAllocator::find_extra_region( const void * i_address ) const
+		{
+			for( ExtraRegion * region = m_first_extra_region; region != nullptr; region = region->m_next )
+			{
+				if( reinterpret_cast<uintptr_t>( i_address ) - reinterpret_cast<uintptr_t>( region ) < region->m_size )
+					return region;
+			}
+			MEMO_ASSERT( false ); // the block does not belong to this allocator
+			return nullptr;
+		}
+
+		// TlsfAllocator::add_extra_region
+		TlsfAllocator::ExtraRegion * TlsfAllocator::add_extra_region( size_t i_min_size )
+		{
+			// the size of the region is a multiple of the growth size
+			const size_t size = round_region_size( ( ( i_min_size + m_growth_size - 1 ) / m_growth_size ) * m_growth_size );
+			if( m_max_size != 0 && ( size > m_max_size || m_total_size > m_max_size - size ) )
+				return nullptr;
+
+			ExtraRegion * region = static_cast<ExtraRegion*>( alloc_region_buffer( size ) );
+			if( region == nullptr )
+				return nullptr;
+
+			region->m_tlsf = tlsf_create( region + 1, size - sizeof( ExtraRegion ) );
+			bool succeeded = region->m_tlsf != nullptr;
+			#if MEMO_ENABLE_PAGE_MAP
+				if( succeeded && is_page_mapped() )
+					succeeded = PageMap::register_range( region, size, *this );
+			#endif
+			if( !succeeded )
+			{
+				if( region->m_tlsf != nullptr )
+					tlsf_destroy( region->m_tlsf );
+				free_region_buffer( region, size );
+				return nullptr;
+			}
+
+			region->m_size = size;
+			region->m_living_blocks = 0;
+			region->m_prev = nullptr;
+			region->m_next = m_first_extra_region;
+			if( m_first_extra_region != nullptr )
+				m_first_extra_region->m_prev = region;
+			m_first_extra_region = region;
+			m_total_size += size;
+			return region;
+		}
+
+		// TlsfAllocator::release_extra_region
+		void TlsfAllocator::release_extra_region( ExtraRegion * i_region )
+		{
+			if( i_region->m_prev != nullptr )
+				i_region->m_prev->m_next = i_region->m_next;
+			else
+				m_first_extra_region = i_region->m_next;
+			if( i_region->m_next != nullptr )
+				i_region->m_next->m_prev = i_region->m_prev;
+			m_total_size -= i_region->m_size;
+
+			tlsf_destroy( i_region->m_tlsf );
+			#if MEMO_ENABLE_PAGE_MAP
+				if( is_page_mapped() )
+					PageMap::unregister_range( i_region, i_region->m_size );
+			#endif
+			free_region_buffer( i_region, i_region->m_size );
+		}
+
+		/* TlsfAllocator::discard_pages - called before freeing a block. If the block is big enough, the pages inside it
+			are discarded, so that the free block does not hold physical memory. */
+		void TlsfAllocator::discard_pages( void * i_address, bool i_aligned )
+		{
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				if( m_discard_threshold == 0 )
+					return;
+
+				void * block = i_aligned ? tlsf_aligned_block( i_address ) : i_address;
+				const size_t block_size = tlsf_block_size( block );
+				if( block_size < m_discard_threshold )
+					return;
+
+				/* while a block is free, tlsf uses its first two words (the links of the free list) and its last word (the
+					link to the previous physical block, in the header of the next block). The alignment header, that precedes
+					i_address, is still needed to free the block. */
+				const size_t page_size = memo_externals::virtual_page_size();
+				void * first_page = upper_align( std::max( address_add( block, 2 * sizeof( void * ) ), i_address ), page_size );
+				void * end_page = lower_align( address_add( block, block_size - sizeof( void * ) ), page_size );
+				if( first_page < end_page )
+					memo_externals::virtual_discard( first_page, address_diff( end_page, first_page ) );
+			#else
+				MEMO_UNUSED( i_address );
+				MEMO_UNUSED( i_aligned );
+			#endif
+		}
+
+		// TlsfAllocator::extra_alloc - allocates in the extra regions, eventually adding a new one
+		void * TlsfAllocator::extra_alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			if( m_growth_size == 0 || i_size >= tlsf_block_size_max() )
+				return nullptr;
+
+			ExtraRegion * region = m_first_extra_region;
+			for( ;; )
+			{
+				const bool new_region = region == nullptr;
+				if( new_region )
+				{
+					/* tlsf searches a free block in the next size class, that may be up to 1/32 bigger than the requested
+						size, so the region is made big enough to contain a block of that size. */
+					const size_t actual_size = i_size + ( i_aligned ? std::max( i_alignment, sizeof( AlignmentHeader ) ) : 0 );
+					const size_t min_region_size = sizeof( ExtraRegion ) + tlsf_overhead() + actual_size + actual_size / 16 + 64;
+					region = add_extra_region( min_region_size );
+					if( region == nullptr )
+						return nullptr;
+				}
+
+				void * result = i_aligned ? tlsf_aligned_alloc( region->m_tlsf, i_size, i_alignment, i_alignment_offset )
+					: tlsf_malloc( region->m_tlsf, i_size );
+				if( result != nullptr )
+				{
+					region->m_living_blocks++;
+					return result;
+				}
+
+				if( new_region )
+				{
+					MEMO_ASSERT( false ); // the new region should always be big enough
+					return nullptr;
+				}
+				region = region->m_next;
+			}
+		}
+
+		// TlsfAllocator::extra_free
+		void TlsfAllocator::extra_free( void * i_address, bool i_aligned )
+		{
+			ExtraRegion * region = find_extra_region( i_address );
+			MEMO_ASSERT( region->m_living_blocks > 0 );
+
+			discard_pages( i_address, i_aligned );
+			if( i_aligned )
+				tlsf_aligned_free( region->m_tlsf, i_address );
+			else
+				tlsf_free( region->m_tlsf, i_address );
+
+			region->m_living_blocks--;
+			if( region->m_living_blocks == 0 && m_release_free_regions )
+			{
+				// release the region only if there is another free extra region
+				for( ExtraRegion * other = m_first_extra_region; other != nullptr; other = other->m_next )
+				{
+					if( other != region && other->m_living_blocks == 0 )
+					{
+						release_extra_region( region );
+						break;
+					}
+				}
+			}
+		}
+
+		/* TlsfAllocator::move_block - reallocates a block in any region, copying the content. Used when a block can't be 
+			resized in its region. */
+		void * TlsfAllocator::move_block( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			void * new_block;
+			size_t old_size;
+			if( i_aligned )
+			{
+				new_block = tlsf_aligned_alloc( m_tlsf, i_new_size, i_alignment, i_alignment_offset );
+				if( new_block == nullptr )
+					new_block = extra_alloc( i_new_size, i_alignment, i_alignment_offset, true );
+				old_size = tlsf_aligned_usable_size( i_address );
+			}
+			else
+			{
+				new_block = tlsf_malloc( m_tlsf, i_new_size );
+				if( new_block == nullptr )
+					new_block = extra_alloc( i_new_size, 0, 0, false );
+				old_size = tlsf_block_size( i_address );
+			}
+			if( new_block == nullptr )
+				return nullptr;
+
+			memcpy( new_block, i_address, std::min( old_size, i_new_size ) );
+
+			if( is_in_first_region( i_address ) )
+			{
+				discard_pages( i_address, i_aligned );
+				if( i_aligned )
+					tlsf_aligned_free( m_tlsf, i_address );
+				else
+					tlsf_free( m_tlsf, i_address );
+			}
+			else
+				extra_free( i_address, i_aligned );
+
+			return new_block;
+		}
+
+		#if MEMO_ENABLE_PAGE_MAP
+
+			// TlsfAllocator::register_in_page_map
+			bool TlsfAllocator::register_in_page_map()
+			{
+				if( is_page_mapped() )
+					return true;
+
+				for( ExtraRegion * region = m_first_extra_region; region != nullptr; region = region->m_next )
+				{
+					if( !PageMap::register_range( region, region->m_size, *this ) )
+					{
+						for( ExtraRegion * registered = m_first_extra_region; registered != region; registered = registered->m_next )
+							PageMap::unregister_range( registered, registered->m_size );
+						return false;
+					}
+				}
+
+				if( !RegionAllocator::register_in_page_map() )
+				{
+					for( ExtraRegion * region = m_first_extra_region; region != nullptr; region = region->m_next )
+						PageMap::unregister_range( region, region->m_size );
+					return false;
+				}
+				return true;
+			}
+
+		#endif
+
 		// TlsfAllocator::alloc
 		void * TlsfAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
 		{
 			void * result = tlsf_aligned_alloc( m_tlsf, i_size, i_alignment, i_alignment_offset );
-			//if( result != nullptr )
+			if( result != nullptr )
 				return result;
 
-			//return extern_allocator().alloc( i_size, i_alignment, i_alignment_offset );
+			return extra_alloc( i_size, i_alignment, i_alignment_offset, true );
 		}
 
 		// TlsfAllocator::realloc
 		void * TlsfAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
 		{
-			void * result = tlsf_aligned_realloc( m_tlsf, i_address, i_new_size, i_alignment, i_alignment_offset );
-			return result;
+			void * region_tlsf = is_in_first_region( i_address ) ? m_tlsf : find_extra_region( i_address )->m_tlsf;
+			void * result = tlsf_aligned_realloc( region_tlsf, i_address, i_new_size, i_alignment, i_alignment_offset );
+			if( result != nullptr || m_growth_size == 0 )
+				return result;
+
+			return move_block( i_address, i_new_size, i_alignment, i_alignment_offset, true );
 		}
 
 		// TlsfAllocator::free
 		void TlsfAllocator::free( void * i_address )
 		{
-			tlsf_aligned_free( m_tlsf, i_address );
+			if( is_in_first_region( i_address ) )
+			{
+				discard_pages( i_address, true );
+				tlsf_aligned_free( m_tlsf, i_address );
+			}
+			else
+				extra_free( i_address, true );
 		}
 
 		// TlsfAllocator::dbg_check
@@ -69,13 +372,28 @@
 			MEMO_UNUSED( i_address );
 		}
 
+		// TlsfAllocator::try_expand
+		bool TlsfAllocator::try_expand( void * i_address, size_t i_new_size )
+		{
+			void * region_tlsf = is_in_first_region( i_address ) ? m_tlsf : find_extra_region( i_address )->m_tlsf;
+			return tlsf_aligned_try_expand( region_tlsf, i_address, i_new_size );
+		}
+
+		// TlsfAllocator::usable_size
+		size_t TlsfAllocator::usable_size( void * i_address )
+		{
+			return tlsf_aligned_usable_size( i_address );
+		}
+
 		// TlsfAllocator::unaligned_alloc
 		void * TlsfAllocator::unaligned_alloc( size_t i_size )
 		{
-			void * result = tlsf_malloc( m_tlsf, i_size );
-			//if( result != nullptr )
+			const size_t size = std::max<size_t>( i_size, 1 ); // tlsf_malloc fails with zero size
+			void * result = tlsf_malloc( m_tlsf, size );
+			if( result != nullptr )
 				return result;
-			//return extern_allocator().unaligned_alloc( i_size );
+
+			return extra_alloc( size, 0, 0, false );
 		}
 	
 		// TlsfAllocator::unaligned_realloc
@@ -83,8 +401,12 @@
 		{
 			MEMO_ASSERT( i_address != nullptr );
 
-			void * result = tlsf_realloc( m_tlsf, i_address, std::max<size_t>( i_new_size, 1 ) );
-			return result;
+			void * region_tlsf = is_in_first_region( i_address ) ? m_tlsf : find_extra_region( i_address )->m_tlsf;
+			void * result = tlsf_realloc( region_tlsf, i_address, std::max<size_t>( i_new_size, 1 ) );
+			if( result != nullptr || m_growth_size == 0 )
+				return result;
+
+			return move_block( i_address, std::max<size_t>( i_new_size, 1 ), 0, 0, false );
 		}
 
 		// TlsfAllocator::unaligned_free
@@ -92,7 +414,13 @@
 		{
 			MEMO_ASSERT( i_address != nullptr );
 
-			tlsf_free( m_tlsf, i_address );
+			if( is_in_first_region( i_address ) )
+			{
+				discard_pages( i_address, false );
+				tlsf_free( m_tlsf, i_address );
+			}
+			else
+				extra_free( i_address, false );
 		}
 	
 		// TlsfAllocator::unaligned_dbg_check
@@ -103,12 +431,73 @@
 			MEMO_UNUSED( i_address );
 		}
 
+		// TlsfAllocator::unaligned_try_expand
+		bool TlsfAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			void * region_tlsf = is_in_first_region( i_address ) ? m_tlsf : find_extra_region( i_address )->m_tlsf;
+			return tlsf_try_expand( region_tlsf, i_address, i_new_size ) != 0;
+		}
+
+		// TlsfAllocator::unaligned_usable_size
+		size_t TlsfAllocator::unaligned_usable_size( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			return tlsf_block_size( i_address );
+		}
+
+		// TlsfAllocator::alloc_batch
+		size_t TlsfAllocator::alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+			{
+				o_blocks[ index ] = tlsf_aligned_alloc( m_tlsf, i_size, i_alignment, i_alignment_offset );
+				if( o_blocks[ index ] == nullptr )
+				{
+					o_blocks[ index ] = extra_alloc( i_size, i_alignment, i_alignment_offset, true );
+					if( o_blocks[ index ] == nullptr )
+						return index;
+				}
+			}
+			return i_count;
+		}
+
+		// TlsfAllocator::free_batch
+		void TlsfAllocator::free_batch( void * * io_blocks, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+			{
+				if( is_in_first_region( io_blocks[ index ] ) )
+				{
+					discard_pages( io_blocks[ index ], true );
+					tlsf_aligned_free( m_tlsf, io_blocks[ index ] );
+				}
+				else
+					extra_free( io_blocks[ index ], true );
+			}
+		}
+
 		// TlsfAllocator::dump_state
 		void TlsfAllocator::dump_state( StateWriter & i_state_writer )
 		{
 			i_state_writer.write( "type", "tlsf" );
 
 			RegionAllocator::dump_state( i_state_writer );
+
+			if( m_growth_size != 0 )
+			{
+				i_state_writer.write_mem_size( "growth", m_growth_size );
+				if( m_max_size != 0 )
+					i_state_writer.write_mem_size( "max_size", m_max_size );
+				i_state_writer.write_uint( "regions", region_count() );
+				i_state_writer.write_mem_size( "total_size", m_total_size );
+			}
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				if( m_discard_threshold != 0 )
+					i_state_writer.write_mem_size( "discard_threshold", m_discard_threshold );
+			#endif
 		}
 
 	
@@ -4,7 +4,26 @@ namespace memo
 	#if MEMO_ENABLE_TLSF
 
 		/**	\class TlsfAllocator
-			This class wraps the tlsf allocator implemented by Matthew Conte (http://tlsf.baisoku.org) */
+			This class wraps the tlsf allocator implemented by Matthew Conte (http://tlsf.baisoku.org).
+			The allocator starts with the region allocated by RegionAllocator. If a growth size is specified, when an 
+			allocation can't be performed in the existing regions, an extra region is allocated with the extern allocator,
+			and a new tlsf pool is created in it. Every allocation is performed in a single region, and the region owning a 
+			block is found by address when the block is freed, so the cost of a deallocation grows with the number of extra
+			regions. Extra regions that become completely free may be released to the extern allocator. Anyway one free 
+			extra region is kept, so that an allocator working at the boundary of a region does not allocate and release a 
+			region repeatedly.
+			The regions and the blocks must be smaller than 1 << MEMO_TLSF_FL_INDEX_MAX bytes.
+
+			The following parameters are supported in the configuration file:
+			- size: inherited from RegionAllocator, is the size of the first region.
+			- growth: size of the extra regions. An extra region is bigger only if required by an allocation. The default 
+				is zero, that means that the allocator never grows.
+			- max_size: maximum total size of the regions, including the first one. The default is zero, that means no limit.
+			- release_free_regions: "true" or "false". If true, the extra regions that become free are released to the
+				extern allocator. The default is false.
+			- discard_threshold: if the regions are reserved from the virtual memory (see RegionAllocator), when a block 
+				at least this big is freed, the system is told that the pages inside the block are not needed, so that the
+				free space does not hold physical memory. The default is zero, that means that pages are never discarded. */
 		class TlsfAllocator : public RegionAllocator
 		{
 		public:
@@ -19,10 +38,32 @@ namespace memo
 			/** Config structure for TlsfAllocator */
 			struct Config : public RegionAllocator::Config
 			{
+			public:
+
+				size_t m_growth_size; /**< size of the extra regions, or zero if the allocator can't grow */
+				size_t m_max_size; /**< maximum total size of the regions, or zero if there is no limit */
+				bool m_release_free_regions; /**< whether extra regions that become free are released */
+
+				#if MEMO_ENABLE_VIRTUAL_MEMORY
+					size_t m_discard_threshold; /**< minimum size of a freed block whose pages are discarded, or zero */
+				#endif
+
+				Config()
+					: m_growth_size( 0 ), m_max_size( 0 ), m_release_free_regions( false )
+					#if MEMO_ENABLE_VIRTUAL_MEMORY
+						, m_discard_threshold( 0 )
+					#endif
+						{ }
+
 			protected:
 
 				/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
 				virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+				/** Tries to recognize the current property from the stream, and eventually reads its value.
+				  @param i_config_reader the source stream
+				  @return true if the property has been recognized, false otherwise */
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader );
 			};
 
 
@@ -58,6 +99,18 @@ namespace memo
 			  @param i_address address of the memory block to check */
 			void dbg_check( void * i_address );
 
+			/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+				The block can grow only if it is followed by a free block big enough.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t usable_size( void * i_address );
+
 
 
 
@@ -86,6 +139,37 @@ namespace memo
 			  @param i_address address of the memory block to check */
 			void unaligned_dbg_check( void * i_address );
 
+			/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it. 
+				Implements IAllocator::unaligned_try_expand. The block can grow only if it is followed by a free block big enough.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc. 
+				Implements IAllocator::unaligned_usable_size.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t unaligned_usable_size( void * i_address );
+
+
+									///// batch allocations /////
+
+			/** allocates many aligned memory blocks. Implements IAllocator::alloc_batch.
+				tlsf is called directly for every block, without any virtual call.
+			  @param i_count number of blocks to allocate
+			  @param i_size size of every block in bytes
+			  @param i_alignment alignment requested for every block. It must be an integer power of 2
+			  @param i_alignment_offset offset from beginning of every block of the address that respects the alignment
+			  @param o_blocks array that receives the addresses of the blocks
+			  @return number of blocks allocated */
+			size_t alloc_batch( size_t i_count, size_t i_size, size_t i_alignment, size_t i_alignment_offset, void * * o_blocks );
+
+			/** deallocates many memory blocks allocated by alloc, realloc or alloc_batch. Implements IAllocator::free_batch.
+			  @param io_blocks array of the addresses of the blocks to free
+			  @param i_count number of blocks to free */
+			void free_batch( void * * io_blocks, size_t i_count );
+
 			/** Constructs the flsf pool */
 			TlsfAllocator( const Config & i_config );
 
@@ -95,14 +179,58 @@ namespace memo
 			/** Writes out in a human readable way the state of the allocator */
 			void dump_state( StateWriter & i_state_writer );
 
+			/** Returns the number of regions, including the first one */
+			size_t region_count() const;
+
+			#if MEMO_ENABLE_PAGE_MAP
+
+				/** Registers the first region and the extra regions in the page map. Overrides RegionAllocator::register_in_page_map.
+				  @return true if the allocator is registered in the page map */
+				bool register_in_page_map();
+
+			#endif
+
 		private:
 			TlsfAllocator( const TlsfAllocator & ); // not implemented
 			TlsfAllocator & operator = ( const TlsfAllocator & ); // not implemented
 
 			struct AlignmentHeader;
 
+			/** Header of an extra region, placed at the beginning of its buffer */
+			struct ExtraRegion
+			{
+				ExtraRegion * m_next;
+				ExtraRegion * m_prev;
+				void * m_tlsf;
+				size_t m_size; /**< size of the buffer, including this header */
+				size_t m_living_blocks;
+			};
+
+			bool is_in_first_region( const void * i_address ) const
+				{ return reinterpret_cast<uintptr_t>( i_address ) - reinterpret_cast<uintptr_t>( buffer() ) < buffer_size(); }
+
+			ExtraRegion * find_extra_region( const void * i_address ) const;
+
+			ExtraRegion * add_extra_region( size_t i_min_size );
+
+			void release_extra_region( ExtraRegion * i_region );
+
+			void * extra_alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+
+			void extra_free( void * i_address, bool i_aligned );
+
+			void * move_block( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+
+			void discard_pages( void * i_address, bool i_aligned );
+
 		private:
 			void * m_tlsf;
+			ExtraRegion * m_first_extra_region;
+			size_t m_growth_size, m_max_size, m_total_size;
+			bool m_release_free_regions;
+			#if MEMO_ENABLE_VIRTUAL_MEMORY
+				size_t m_discard_threshold;
+			#endif
 		};
 
 	#endif // #if MEMO_ENABLE_TLSF
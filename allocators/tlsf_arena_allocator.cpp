@@ -0,0 +1,492 @@
+
+#if MEMO_ENABLE_TLSF
+
+	namespace memo
+	{
+		/* Header preceding every block. When the block is in a remote-free list, the header is the node of the list:
+			m_next_remote_free is the address of the next node, with the lowest bit set if the block was allocated
+			with the aligned functions. */
+		struct TlsfArenaAllocator::Header
+		{
+			union
+			{
+				Arena * m_arena;
+				uintptr_t m_next_remote_free;
+			};
+			size_t m_size; /**< size requested for the block. Unlike the tlsf header, it is not changed by the owner of the arena */
+		};
+
+		/* Arena of a thread. Arenas are allocated with the default allocator, and are linked to the ThreadRoot
+			of the owning thread. */
+		struct TlsfArenaAllocator::Arena : public ThreadRoot::LocalObject
+		{
+			TlsfArenaAllocator * m_allocator;
+			ThreadRoot * m_thread_root; /**< owning thread, or nullptr if the arena is abandoned or shared */
+			Arena * m_prev_arena; /**< previous arena of the same allocator, protected by the mutex of the allocator */
+			Arena * m_next_arena; /**< next arena of the same allocator, protected by the mutex of the allocator */
+			void * volatile m_remote_frees; /**< lock-free list of the blocks freed by other threads */
+			volatile size_t m_remote_free_count; /**< number of blocks taken from the remote-free list, written only by the owner with atomic_store_size */
+			TlsfAllocator m_tlsf;
+
+			Arena( TlsfArenaAllocator & i_allocator, const TlsfAllocator::Config & i_config )
+				: m_allocator( &i_allocator ), m_thread_root( nullptr ), m_prev_arena( nullptr ), m_next_arena( nullptr ),
+				  m_remote_frees( nullptr ), m_remote_free_count( 0 ), m_tlsf( i_config ) { }
+
+			virtual void on_thread_exit()
+				{ m_allocator->abandon_arena( this ); }
+		};
+
+		// TlsfArenaAllocator::Config::configure_allocator
+		IAllocator * TlsfArenaAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+		{
+			TlsfArenaAllocator * allocator;
+			if( i_new_allocator != nullptr )
+				allocator = static_cast< TlsfArenaAllocator * >( i_new_allocator );
+			else
+				allocator = MEMO_NEW( TlsfArenaAllocator, *this );
+
+			IAllocator::Config::configure_allocator( allocator );
+
+			return allocator;
+		}
+
+		// TlsfArenaAllocator::Config::try_recognize_property
+		bool TlsfArenaAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+		{
+			if( i_config_reader.try_recognize_property( "arena_size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_arena_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "growth" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_growth_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "max_size" ) )
+			{
+				if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+			else if( i_config_reader.try_recognize_property( "release_free_regions" ) )
+			{
+				const char * value = i_config_reader.curr_property_vakue_as_string();
+				if( strcmp( value, "true" ) == 0 )
+					m_release_free_regions = true;
+				else if( strcmp( value, "false" ) == 0 )
+					m_release_free_regions = false;
+				else
+					i_config_reader.output_message( serialization::eWrongContent );
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// TlsfArenaAllocator::constructor
+		TlsfArenaAllocator::TlsfArenaAllocator( const Config & i_config )
+			: m_first_arena( nullptr ), m_shared_arena( nullptr )
+		{
+			m_arena_config.m_buffer_size = i_config.m_arena_size;
+			m_arena_config.m_growth_size = i_config.m_growth_size;
+			m_arena_config.m_max_size = i_config.m_max_size;
+			m_arena_config.m_release_free_regions = i_config.m_release_free_regions;
+		}
+
+		// TlsfArenaAllocator::destructor
+		TlsfArenaAllocator::~TlsfArenaAllocator()
+		{
+			while( m_first_arena != nullptr )
+			{
+				Arena * arena = m_first_arena;
+				if( arena->m_thread_root != nullptr )
+					arena->m_thread_root->remove_local_object( arena );
+				destroy_arena( arena );
+			}
+		}
+
+		// TlsfArenaAllocator::find_arena - returns the arena owned by the calling thread, or nullptr
+		TlsfArenaAllocator::Arena * TlsfArenaAllocator::find_arena() const
+		{
+			ThreadRoot * thread_root = memo_externals::get_thread_root();
+			if( thread_root == nullptr )
+				return nullptr;
+
+			return static_cast<Arena *>( thread_root->find_local_object( this ) );
+		}
+
+		/* TlsfArenaAllocator::get_arena - returns the arena owned by the calling thread, eventually assigning one to it.
+			Returns nullptr if the thread has no ThreadRoot. */
+		TlsfArenaAllocator::Arena * TlsfArenaAllocator::get_arena()
+		{
+			ThreadRoot * thread_root = memo_externals::get_thread_root();
+			if( thread_root == nullptr )
+				return nullptr;
+
+			ThreadRoot::LocalObject * local_object = thread_root->find_local_object( this );
+			if( local_object != nullptr )
+				return static_cast<Arena *>( local_object );
+
+			return create_arena( *thread_root );
+		}
+
+		// TlsfArenaAllocator::create_arena - adopts an abandoned arena, or creates a new one
+		TlsfArenaAllocator::Arena * TlsfArenaAllocator::create_arena( ThreadRoot & i_thread_root )
+		{
+			Arena * arena = nullptr;
+			{
+				MutexLock lock( m_mutex );
+				for( Arena * abandoned = m_first_arena; abandoned != nullptr; abandoned = abandoned->m_next_arena )
+				{
+					if( abandoned->m_thread_root == nullptr && abandoned != m_shared_arena )
+					{
+						arena = abandoned;
+						arena->m_thread_root = &i_thread_root;
+						break;
+					}
+				}
+			}
+
+			if( arena == nullptr )
+			{
+				arena = MEMO_NEW_ALLOC( safe_get_default_allocator(), Arena, *this, m_arena_config );
+				arena->m_thread_root = &i_thread_root;
+
+				MutexLock lock( m_mutex );
+				arena->m_next_arena = m_first_arena;
+				if( m_first_arena != nullptr )
+					m_first_arena->m_prev_arena = arena;
+				m_first_arena = arena;
+			}
+
+			i_thread_root.add_local_object( this, arena );
+
+			return arena;
+		}
+
+		/* TlsfArenaAllocator::get_shared_arena - returns the arena used by threads without a ThreadRoot, eventually
+			creating it. The mutex must be locked by the caller. */
+		TlsfArenaAllocator::Arena & TlsfArenaAllocator::get_shared_arena()
+		{
+			if( m_shared_arena == nullptr )
+			{
+				m_shared_arena = MEMO_NEW_ALLOC( safe_get_default_allocator(), Arena, *this, m_arena_config );
+				m_shared_arena->m_next_arena = m_first_arena;
+				if( m_first_arena != nullptr )
+					m_first_arena->m_prev_arena = m_shared_arena;
+				m_first_arena = m_shared_arena;
+			}
+			return *m_shared_arena;
+		}
+
+		/* TlsfArenaAllocator::abandon_arena - called when the owning thread exits. The arena is kept, since other threads
+			may still own blocks allocated in it, and it is adopted by the next thread that needs an arena. */
+		void TlsfArenaAllocator::abandon_arena( Arena * i_arena )
+		{
+			drain_remote_frees( *i_arena );
+
+			MutexLock lock( m_mutex );
+			i_arena->m_thread_root = nullptr;
+		}
+
+		// TlsfArenaAllocator::destroy_arena
+		void TlsfArenaAllocator::destroy_arena( Arena * i_arena )
+		{
+			drain_remote_frees( *i_arena );
+
+			{
+				MutexLock lock( m_mutex );
+				if( i_arena->m_prev_arena != nullptr )
+					i_arena->m_prev_arena->m_next_arena = i_arena->m_next_arena;
+				else
+					m_first_arena = i_arena->m_next_arena;
+				if( i_arena->m_next_arena != nullptr )
+					i_arena->m_next_arena->m_prev_arena = i_arena->m_prev_arena;
+				if( m_shared_arena == i_arena )
+					m_shared_arena = nullptr;
+			}
+
+			MEMO_DELETE_ALLOC( safe_get_default_allocator(), i_arena );
+		}
+
+		/* TlsfArenaAllocator::remote_free - pushes a block in the remote-free list of its arena. Any thread can call
+			this function, and no lock is taken. */
+		void TlsfArenaAllocator::remote_free( Arena & i_arena, Header * i_header, bool i_aligned )
+		{
+			void * head = memo_externals::atomic_load_pointer( &i_arena.m_remote_frees );
+			for( ;; )
+			{
+				i_header->m_next_remote_free = reinterpret_cast<uintptr_t>( head ) | ( i_aligned ? 1 : 0 );
+				void * prev_head = memo_externals::atomic_compare_exchange_pointer( &i_arena.m_remote_frees, i_header, head );
+				if( prev_head == head )
+					break;
+				head = prev_head;
+			}
+		}
+
+		/* TlsfArenaAllocator::drain_remote_frees - gives back to tlsf all the blocks in the remote-free list of an arena.
+			It can be called only by the owner of the arena (or under the mutex for the shared arena). The whole list
+			is detached with a single exchange, so the pushes of other threads never conflict with it. */
+		void TlsfArenaAllocator::drain_remote_frees( Arena & i_arena )
+		{
+			// the exchange is skipped if the list is empty. A block pushed after the check is freed by the next drain
+			if( memo_externals::atomic_load_pointer( &i_arena.m_remote_frees ) == nullptr )
+				return;
+
+			Header * header = static_cast<Header *>( memo_externals::atomic_exchange_pointer( &i_arena.m_remote_frees, nullptr ) );
+			while( header != nullptr )
+			{
+				const uintptr_t link = header->m_next_remote_free;
+				if( ( link & 1 ) != 0 )
+					i_arena.m_tlsf.free( header );
+				else
+					i_arena.m_tlsf.unaligned_free( header );
+				memo_externals::atomic_store_size( &i_arena.m_remote_free_count, i_arena.m_remote_free_count + 1 );
+				header = reinterpret_cast<Header *>( link & ~static_cast<uintptr_t>( 1 ) );
+			}
+		}
+
+		// TlsfArenaAllocator::arena_alloc
+		void * TlsfArenaAllocator::arena_alloc( Arena & i_arena, size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			drain_remote_frees( i_arena );
+
+			Header * header = static_cast<Header *>( i_aligned
+				? i_arena.m_tlsf.alloc( i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) )
+				: i_arena.m_tlsf.unaligned_alloc( i_size + sizeof( Header ) ) );
+			if( header == nullptr )
+				return nullptr;
+
+			header->m_arena = &i_arena;
+			header->m_size = i_size;
+			return header + 1;
+		}
+
+		// TlsfArenaAllocator::arena_free - frees a block of the arena owned by the calling thread
+		void TlsfArenaAllocator::arena_free( Arena & i_arena, Header * i_header, bool i_aligned )
+		{
+			MEMO_ASSERT( i_header->m_arena == &i_arena );
+
+			if( i_aligned )
+				i_arena.m_tlsf.free( i_header );
+			else
+				i_arena.m_tlsf.unaligned_free( i_header );
+		}
+
+		/* TlsfArenaAllocator::arena_realloc - reallocates a block of the arena owned by the calling thread. The header
+			is moved by tlsf along with the content, so it still refers to the same arena. */
+		void * TlsfArenaAllocator::arena_realloc( Arena & i_arena, Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+		{
+			MEMO_ASSERT( i_header->m_arena == &i_arena );
+
+			drain_remote_frees( i_arena );
+
+			Header * new_header = static_cast<Header *>( i_aligned
+				? i_arena.m_tlsf.realloc( i_header, i_new_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) )
+				: i_arena.m_tlsf.unaligned_realloc( i_header, i_new_size + sizeof( Header ) ) );
+			if( new_header == nullptr )
+				return nullptr;
+
+			new_header->m_size = i_new_size;
+			return new_header + 1;
+		}
+
+		/* TlsfArenaAllocator::block_usable_size - the tlsf header of a block is rewritten without locks by the owner
+			of the arena when it allocates or frees the neighbour blocks, so it is read only by the owner, or under 
+			the mutex for the shared arena. The other threads get the size requested for the block. */
+		size_t TlsfArenaAllocator::block_usable_size( void * i_address, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena * arena = header->m_arena;
+			if( arena == find_arena() )
+				return ( i_aligned ? arena->m_tlsf.usable_size( header ) : arena->m_tlsf.unaligned_usable_size( header ) ) - sizeof( Header );
+
+			MutexLock lock( m_mutex );
+			if( arena == m_shared_arena )
+				return ( i_aligned ? arena->m_tlsf.usable_size( header ) : arena->m_tlsf.unaligned_usable_size( header ) ) - sizeof( Header );
+			return header->m_size;
+		}
+
+		// TlsfArenaAllocator::free_block
+		void TlsfArenaAllocator::free_block( void * i_address, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena * arena = header->m_arena;
+			if( arena == find_arena() )
+				arena_free( *arena, header, i_aligned );
+			else
+				remote_free( *arena, header, i_aligned );
+		}
+
+		// TlsfArenaAllocator::try_expand_block
+		bool TlsfArenaAllocator::try_expand_block( void * i_address, size_t i_new_size, bool i_aligned )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena * arena = header->m_arena;
+			if( arena != find_arena() )
+				return false; // only the owner can modify its arena
+
+			const bool expanded = i_aligned ? arena->m_tlsf.try_expand( header, i_new_size + sizeof( Header ) )
+				: arena->m_tlsf.unaligned_try_expand( header, i_new_size + sizeof( Header ) );
+			if( expanded )
+				header->m_size = i_new_size;
+			return expanded;
+		}
+
+		// TlsfArenaAllocator::alloc
+		void * TlsfArenaAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			Arena * arena = get_arena();
+			if( arena != nullptr )
+				return arena_alloc( *arena, i_size, i_alignment, i_alignment_offset, true );
+
+			MutexLock lock( m_mutex );
+			return arena_alloc( get_shared_arena(), i_size, i_alignment, i_alignment_offset, true );
+		}
+
+		// TlsfArenaAllocator::realloc
+		void * TlsfArenaAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena * arena = header->m_arena;
+			if( arena == find_arena() )
+				return arena_realloc( *arena, header, i_new_size, i_alignment, i_alignment_offset, true );
+
+			// the block belongs to another thread: it is moved in the arena of the calling thread
+			void * new_block = alloc( i_new_size, i_alignment, i_alignment_offset );
+			if( new_block == nullptr )
+				return nullptr;
+
+			// the tlsf header of the block can't be read, as the owner may be changing the neighbour blocks
+			memcpy( new_block, i_address, std::min( header->m_size, i_new_size ) );
+			remote_free( *arena, header, true );
+			return new_block;
+		}
+
+		// TlsfArenaAllocator::free
+		void TlsfArenaAllocator::free( void * i_address )
+		{
+			free_block( i_address, true );
+		}
+
+		// TlsfArenaAllocator::dbg_check
+		void TlsfArenaAllocator::dbg_check( void * i_address )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			MEMO_ASSERT( header->m_arena != nullptr && header->m_arena->m_allocator == this );
+			MEMO_UNUSED( header );
+		}
+
+		// TlsfArenaAllocator::try_expand
+		bool TlsfArenaAllocator::try_expand( void * i_address, size_t i_new_size )
+		{
+			return try_expand_block( i_address, i_new_size, true );
+		}
+
+		// TlsfArenaAllocator::usable_size
+		size_t TlsfArenaAllocator::usable_size( void * i_address )
+		{
+			return block_usable_size( i_address, true );
+		}
+
+		// TlsfArenaAllocator::unaligned_alloc
+		void * TlsfArenaAllocator::unaligned_alloc( size_t i_size )
+		{
+			Arena * arena = get_arena();
+			if( arena != nullptr )
+				return arena_alloc( *arena, i_size, 0, 0, false );
+
+			MutexLock lock( m_mutex );
+			return arena_alloc( get_shared_arena(), i_size, 0, 0, false );
+		}
+
+		// TlsfArenaAllocator::unaligned_realloc
+		void * TlsfArenaAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+		{
+			MEMO_ASSERT( i_address != nullptr );
+
+			Header * header = static_cast<Header *>( i_address ) - 1;
+			Arena * arena = header->m_arena;
+			if( arena == find_arena() )
+				return arena_realloc( *arena, header, i_new_size, 0, 0, false );
+
+			// the block belongs to another thread: it is moved in the arena of the calling thread
+			void * new_block = unaligned_alloc( i_new_size );
+			if( new_block == nullptr )
+				return nullptr;
+
+			memcpy( new_block, i_address, std::min( header->m_size, i_new_size ) );
+			remote_free( *arena, header, false );
+			return new_block;
+		}
+
+		// TlsfArenaAllocator::unaligned_free
+		void TlsfArenaAllocator::unaligned_free( void * i_address )
+		{
+			free_block( i_address, false );
+		}
+
+		// TlsfArenaAllocator::unaligned_dbg_check
+		void TlsfArenaAllocator::unaligned_dbg_check( void * i_address )
+		{
+			dbg_check( i_address );
+		}
+
+		// TlsfArenaAllocator::unaligned_try_expand
+		bool TlsfArenaAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+		{
+			return try_expand_block( i_address, i_new_size, false );
+		}
+
+		// TlsfArenaAllocator::unaligned_usable_size
+		size_t TlsfArenaAllocator::unaligned_usable_size( void * i_address )
+		{
+			return block_usable_size( i_address, false );
+		}
+
+		// TlsfArenaAllocator::dump_state
+		void TlsfArenaAllocator::dump_state( StateWriter & i_state_writer )
+		{
+			size_t arena_count = 0, abandoned_count = 0, remote_free_count = 0;
+			{
+				MutexLock lock( m_mutex );
+				for( Arena * arena = m_first_arena; arena != nullptr; arena = arena->m_next_arena )
+				{
+					arena_count++;
+					if( arena->m_thread_root == nullptr && arena != m_shared_arena )
+						abandoned_count++;
+					remote_free_count += memo_externals::atomic_load_size( &arena->m_remote_free_count ); // approximate, the counters are owned by the threads
+				}
+			}
+
+			i_state_writer.write( "type", "tlsf_arena" );
+			i_state_writer.write_mem_size( "arena_size", m_arena_config.m_buffer_size );
+			if( m_arena_config.m_growth_size != 0 )
+				i_state_writer.write_mem_size( "growth", m_arena_config.m_growth_size );
+			if( m_arena_config.m_max_size != 0 )
+				i_state_writer.write_mem_size( "max_size", m_arena_config.m_max_size );
+			i_state_writer.write_uint( "arena_count", arena_count );
+			i_state_writer.write_uint( "abandoned_arenas", abandoned_count );
+			i_state_writer.write_uint( "remote_frees", remote_free_count );
+		}
+
+	} // namespace memo
+
+#endif
@@ -0,0 +1,178 @@
+
+namespace memo
+{
+	#if MEMO_ENABLE_TLSF
+
+		/**	\class TlsfArenaAllocator
+			Allocator that gives to every thread its own tlsf arena (a TlsfAllocator), so that allocations and deallocations
+			performed by the owning thread need no lock. The arena of the calling thread is found through its ThreadRoot.
+			Every block has a header storing its arena. A block freed by a thread that is not the owner of its arena is pushed
+			in a lock-free list of the arena (remote-free list), and is given back to tlsf by the owning thread the next time
+			it allocates.
+			When a thread exits, its arena is abandoned, and it is adopted by the next thread that needs an arena. Threads
+			without a ThreadRoot use a shared arena, protected by a mutex.
+			A pointer and a size_t are added as overhead to every memory block.
+
+			The following parameters are supported in the configuration file:
+			- arena_size: size of the first region of every arena. The default is 1 MB.
+			- growth: size of the extra regions of the arenas (see TlsfAllocator). The default is 1 MB.
+			- max_size: maximum size of every arena (see TlsfAllocator). The default is zero, that means no limit.
+			- release_free_regions: "true" or "false", see TlsfAllocator. The default is true.
+
+			\note The allocator can be destroyed only when no other thread is using it. */
+		class TlsfArenaAllocator : public IAllocator
+		{
+		public:
+
+			/** Static function returning the name of the allocator class, used to register the type.
+			   This name can be used to instantiate this allocator in the configuration file. */
+			static const char * type_name() { return "tlsf_arena_allocator"; }
+
+
+									///// configuration /////
+
+			/** Config structure for TlsfArenaAllocator */
+			struct Config : public IAllocator::Config
+			{
+			public:
+
+				size_t m_arena_size; /**< size of the first region of every arena */
+				size_t m_growth_size; /**< size of the extra regions of the arenas */
+				size_t m_max_size; /**< maximum size of every arena, or zero if there is no limit */
+				bool m_release_free_regions; /**< whether extra regions that become free are released */
+
+				Config()
+					: m_arena_size( 1024 * 1024 ), m_growth_size( 1024 * 1024 ), m_max_size( 0 ), m_release_free_regions( true ) { }
+
+			protected:
+
+				/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+				virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+				/** Tries to recognize the current property from the stream, and eventually reads its value.
+				  @param i_config_reader the source stream
+				  @return true if the property has been recognized, false otherwise */
+				bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+			};
+
+			/** Constructs the allocator. Arenas are created when threads allocate. */
+			TlsfArenaAllocator( const Config & i_config );
+
+			/** Destroys all the arenas */
+			~TlsfArenaAllocator();
+
+
+									///// aligned allocations /////
+
+			/** allocates an aligned memory block in the arena of the calling thread. Implements IAllocator::alloc.
+			  @param i_size size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+				If the block belongs to the arena of another thread, it is moved in the arena of the calling thread.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @param i_alignment alignment requested for the block. It must be an integer power of 2
+			  @param i_alignment_offset offset from the address that respects the alignment
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+			/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+				If the block belongs to the arena of another thread, it is pushed in the remote-free list of the arena.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void free( void * i_address );
+
+			/** Implements IAllocator::dbg_check.
+			  @param i_address address of the memory block to check */
+			void dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+				Only blocks of the arena of the calling thread can be resized.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+				If the block belongs to the arena of another thread, the size requested for the block is returned.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t usable_size( void * i_address );
+
+
+								///// unaligned allocations /////
+
+			/** allocates a new memory block in the arena of the calling thread. Implements IAllocator::unaligned_alloc.
+			  @param i_size size of the block in bytes
+			  @return the address of the first byte in the block, or nullptr if the allocation fails */
+			void * unaligned_alloc( size_t i_size );
+
+			/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+				If the block belongs to the arena of another thread, it is moved in the arena of the calling thread.
+			  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+			void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+			/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+				If the block belongs to the arena of another thread, it is pushed in the remote-free list of the arena.
+			  @param i_address address of the memory block to free. It cannot be nullptr. */
+			void unaligned_free( void * i_address );
+
+			/** Implements IAllocator::unaligned_dbg_check.
+			  @param i_address address of the memory block to check */
+			void unaligned_dbg_check( void * i_address );
+
+			/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+				Implements IAllocator::unaligned_try_expand. Only blocks of the arena of the calling thread can be resized.
+			  @param i_address address of the memory block to resize. It cannot be nullptr.
+			  @param i_new_size new size of the block in bytes
+			  @return true if the block has been resized, false otherwise */
+			bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+			/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+				Implements IAllocator::unaligned_usable_size. If the block belongs to the arena of another thread, the size
+				requested for the block is returned.
+			  @param i_address address of the memory block. It cannot be nullptr.
+			  @return the usable size of the block */
+			size_t unaligned_usable_size( void * i_address );
+
+			/** Writes out in a human readable way the state of the allocator */
+			void dump_state( StateWriter & i_state_writer );
+
+		private:
+			TlsfArenaAllocator( const TlsfArenaAllocator & ); // not implemented
+			TlsfArenaAllocator & operator = ( const TlsfArenaAllocator & ); // not implemented
+
+			struct Header;
+			struct Arena;
+
+			Arena * get_arena();
+			Arena * find_arena() const;
+			Arena * create_arena( ThreadRoot & i_thread_root );
+			Arena & get_shared_arena();
+			void abandon_arena( Arena * i_arena );
+			void destroy_arena( Arena * i_arena );
+
+			void * arena_alloc( Arena & i_arena, size_t i_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+			void arena_free( Arena & i_arena, Header * i_header, bool i_aligned );
+			void * arena_realloc( Arena & i_arena, Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+			void free_block( void * i_address, bool i_aligned );
+			bool try_expand_block( void * i_address, size_t i_new_size, bool i_aligned );
+			size_t block_usable_size( void * i_address, bool i_aligned );
+			static void remote_free( Arena & i_arena, Header * i_header, bool i_aligned );
+			static void drain_remote_frees( Arena & i_arena );
+
+		private: // data members
+			TlsfAllocator::Config m_arena_config;
+			memo_externals::Mutex m_mutex; /**< protects the list of arenas, and the shared arena */
+			Arena * m_first_arena;
+			Arena * m_shared_arena; /**< arena used by threads without a ThreadRoot, created on demand */
+		};
+
+	#endif // #if MEMO_ENABLE_TLSF
+
+} // namespace memo
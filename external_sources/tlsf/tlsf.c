@@ -12,6 +12,14 @@
 ** Constants.
 */
 
+#if !defined (TLSF_FL_INDEX_MAX)
+#if defined (TLSF_64BIT)
+#define TLSF_FL_INDEX_MAX 32
+#else
+#define TLSF_FL_INDEX_MAX 30
+#endif
+#endif
+
 /* Public constants: may be modified. */
 enum tlsf_public
 {
@@ -42,15 +50,13 @@ enum tlsf_private
 	** blocks below that size into the 0th first-level list.
 	*/
 
-#if defined (TLSF_64BIT)
 	/*
-	** TODO: We can increase this to support larger sizes, at the expense
-	** of more overhead in the TLSF structure.
+	** FL_INDEX_MAX can be set by the user defining TLSF_FL_INDEX_MAX.
+	** Every unit adds SL_INDEX_COUNT free list heads to the pool. The
+	** first-level bitmap has 32 bits, so on 64-bit architectures the
+	** maximum is 39 (blocks and pools smaller than 512 GB).
 	*/
-	FL_INDEX_MAX = 32,
-#else
-	FL_INDEX_MAX = 30,
-#endif
+	FL_INDEX_MAX = TLSF_FL_INDEX_MAX,
 	SL_INDEX_COUNT = (1 << SL_INDEX_COUNT_LOG2),
 	FL_INDEX_SHIFT = (SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2),
 	FL_INDEX_COUNT = (FL_INDEX_MAX - FL_INDEX_SHIFT + 1),
@@ -90,6 +96,12 @@ tlsf_static_assert(sizeof(size_t) * CHAR_BIT <= 64);
 /* SL_INDEX_COUNT must be <= number of bits in sl_bitmap's storage type. */
 tlsf_static_assert(sizeof(unsigned int) * CHAR_BIT >= SL_INDEX_COUNT);
 
+/* FL_INDEX_COUNT must be <= number of bits in fl_bitmap's storage type. */
+tlsf_static_assert(sizeof(unsigned int) * CHAR_BIT >= FL_INDEX_COUNT);
+
+/* Block sizes up to (1 << FL_INDEX_MAX) must be representable. */
+tlsf_static_assert(sizeof(size_t) * CHAR_BIT > FL_INDEX_MAX);
+
 /* Ensure we've properly tuned our sizes. */
 tlsf_static_assert(ALIGN_SIZE == SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
 
@@ -336,7 +348,7 @@ static void mapping_search(size_t size, int* fli, int* sli)
 {
 	if (size >= (1 << SL_INDEX_COUNT_LOG2))
 	{
-		const size_t round = (1 << (tlsf_fls_sizet(size) - SL_INDEX_COUNT_LOG2)) - 1;
+		const size_t round = (tlsf_cast(size_t, 1) << (tlsf_fls_sizet(size) - SL_INDEX_COUNT_LOG2)) - 1;
 		size += round;
 	}
 	mapping_insert(size, fli, sli);
@@ -351,11 +363,12 @@ static block_header_t* search_suitable_block(pool_t* pool, int* fli, int* sli)
 	** First, search for a block in the list associated with the given
 	** fl/sl index.
 	*/
-	unsigned int sl_map = pool->sl_bitmap[fl] & (~0 << sl);
+	unsigned int sl_map = pool->sl_bitmap[fl] & (~0U << sl);
 	if (!sl_map)
 	{
 		/* No block exists. Search in the next largest first-level list. */
-		const unsigned int fl_map = pool->fl_bitmap & (~0 << (fl + 1));
+		/* fl + 1 may be 32, so the bit of fl is cleared instead of shifting by fl + 1. */
+		const unsigned int fl_map = pool->fl_bitmap & (~0U << fl) & ~(1U << fl);
 		if (!fl_map)
 		{
 			/* No free blocks available, memory has been exhausted. */
@@ -392,12 +405,12 @@ static void remove_free_block(pool_t* pool, block_header_t* block, int fl, int s
 		/* If the new head is null, clear the bitmap. */
 		if (next == &pool->block_null)
 		{
-			pool->sl_bitmap[fl] &= ~(1 << sl);
+			pool->sl_bitmap[fl] &= ~(1U << sl);
 
 			/* If the second bitmap is now empty, clear the fl bitmap. */
 			if (!pool->sl_bitmap[fl])
 			{
-				pool->fl_bitmap &= ~(1 << fl);
+				pool->fl_bitmap &= ~(1U << fl);
 			}
 		}
 	}
@@ -420,8 +433,8 @@ static void insert_free_block(pool_t* pool, block_header_t* block, int fl, int s
 	** and second-level bitmaps appropriately.
 	*/
 	pool->blocks[fl][sl] = block;
-	pool->fl_bitmap |= (1 << fl);
-	pool->sl_bitmap[fl] |= (1 << sl);
+	pool->fl_bitmap |= (1U << fl);
+	pool->sl_bitmap[fl] |= (1U << sl);
 }
 
 /* Remove a given block from the free list. */
@@ -560,7 +573,15 @@ static block_header_t* block_locate_free(pool_t* pool, size_t size)
 	if (size)
 	{
 		mapping_search(size, &fl, &sl);
-		block = search_suitable_block(pool, &fl, &sl);
+
+		/*
+		** mapping_search rounds up the size, so a request close to
+		** block_size_max may map past the last first-level list.
+		*/
+		if (fl < FL_INDEX_COUNT)
+		{
+			block = search_suitable_block(pool, &fl, &sl);
+		}
 	}
 
 	if (block)
@@ -735,6 +756,11 @@ size_t tlsf_overhead()
 	return pool_overhead;
 }
 
+size_t tlsf_block_size_max()
+{
+	return block_size_max;
+}
+
 /*
 ** TLSF main interface. Right out of the white paper.
 */
@@ -774,14 +800,9 @@ tlsf_pool tlsf_create(void* mem, size_t bytes)
 
 	if (pool_bytes < block_size_min || pool_bytes > block_size_max)
 	{
-#if defined (TLSF_64BIT)
-		printf("tlsf_create: Pool size must be at least %d bytes.\n",
-			(unsigned int)(pool_overhead + block_size_min));
-#else
-		printf("tlsf_create: Pool size must be between %u and %u bytes.\n", 
-			(unsigned int)(pool_overhead + block_size_min),
-			(unsigned int)(pool_overhead + block_size_max));
-#endif
+		printf("tlsf_create: Pool size must be between %llu and %llu bytes.\n", 
+			(unsigned long long)(pool_overhead + block_size_min),
+			(unsigned long long)(pool_overhead + block_size_max));
 		return 0;
 	}
 
@@ -959,3 +980,38 @@ void* tlsf_realloc(tlsf_pool tlsf, void* ptr, size_t size)
 
 	return p;
 }
+
+/*
+** Resizes a block without moving it. If the block must grow, the next
+** physical block is absorbed, provided that it is free and big enough.
+*/
+int tlsf_try_expand(tlsf_pool tlsf, void* ptr, size_t size)
+{
+	pool_t* pool = tlsf_cast(pool_t*, tlsf);
+	block_header_t* block = block_from_ptr(ptr);
+	block_header_t* next = block_next(block);
+
+	const size_t cursize = block_size(block);
+	const size_t adjust = adjust_request_size(tlsf_max(size, 1), ALIGN_SIZE);
+
+	/* The request is too big. */
+	if (!adjust)
+	{
+		return 0;
+	}
+
+	if (adjust > cursize)
+	{
+		const size_t combined = cursize + block_size(next) + block_header_overhead;
+		if (!block_is_free(next) || adjust > combined)
+		{
+			return 0;
+		}
+
+		block_merge_next(pool, block);
+		block_mark_as_used(block);
+	}
+
+	block_trim_used(pool, block, adjust);
+	return 1;
+}
@@ -32,6 +32,8 @@ void* tlsf_malloc(tlsf_pool pool, size_t bytes);
 void* tlsf_memalign(tlsf_pool pool, size_t align, size_t bytes);
 void* tlsf_realloc(tlsf_pool pool, void* ptr, size_t size);
 void tlsf_free(tlsf_pool pool, void* ptr);
+/* Resizes a block without moving it. Returns nonzero on success. */
+int tlsf_try_expand(tlsf_pool pool, void* ptr, size_t size);
 
 /* Debugging. */
 typedef void (*tlsf_walker)(void* ptr, size_t size, int used, void* user);
@@ -45,6 +47,9 @@ size_t tlsf_block_size(void* ptr);
 /* Overhead of per-pool internal structures. */
 size_t tlsf_overhead();
 
+/* Size limit of the blocks and of the pools (1 << FL_INDEX_MAX). */
+size_t tlsf_block_size_max();
+
 #if defined(__cplusplus)
 };
 #endif
@@ -52,8 +52,8 @@ tlsf_decl int tlsf_fls(unsigned int word)
 	return bit - 1;
 }
 
-#elif defined (_MSC_VER) && defined (_M_IX86) && (_MSC_VER >= 1400)
-/* Microsoft Visual C++ 2005 support on x86 architectures. */
+#elif defined (_MSC_VER) && (defined (_M_IX86) || defined (_M_X64) || defined (_M_ARM) || defined (_M_ARM64)) && (_MSC_VER >= 1400)
+/* Microsoft Visual C++ 2005 support on x86, x64 and ARM architectures. */
 
 #include <intrin.h>
 
@@ -155,7 +155,26 @@ tlsf_decl int tlsf_fls(unsigned int word)
 #endif
 
 /* Possibly 64-bit version of tlsf_fls. */
-#if defined (TLSF_64BIT)
+#if defined (TLSF_64BIT) && defined (__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)) \
+	&& defined (__GNUC_PATCHLEVEL__)
+
+tlsf_decl int tlsf_fls_sizet(size_t size)
+{
+	const int bit = size ? 64 - __builtin_clzll(size) : 0;
+	return bit - 1;
+}
+
+#elif defined (TLSF_64BIT) && defined (_MSC_VER) && (defined (_M_X64) || defined (_M_ARM64))
+
+#pragma intrinsic(_BitScanReverse64)
+
+tlsf_decl int tlsf_fls_sizet(size_t size)
+{
+	unsigned long index;
+	return _BitScanReverse64(&index, size) ? index : -1;
+}
+
+#elif defined (TLSF_64BIT)
 tlsf_decl int tlsf_fls_sizet(size_t size)
 {
 	int high = (int)(size >> 32);
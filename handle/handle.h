@@ -0,0 +1,2 @@
+
+#include "handle_allocator.h"
@@ -0,0 +1,210 @@
+
+namespace memo
+{
+	/* Header preceding every block in the buffer, including the holes */
+	struct HandleAllocator::BlockHeader
+	{
+		size_t m_size; /**< size of the block, including the header. It's a multiple of sizeof( BlockHeader ) */
+		size_t m_entry; /**< index of the entry of the block, or s_free_block for holes */
+	};
+
+	/* Entry of the table of the handles */
+	struct HandleAllocator::Entry
+	{
+		size_t m_offset; /**< offset of the header of the block, or index of the next unused entry */
+		size_t m_size; /**< size of the block, as requested to alloc */
+		uint32_t m_generation; /**< incremented every time the block is freed, to detect handles to freed blocks */
+		uint32_t m_pin_count;
+	};
+
+	// HandleAllocator::constructor
+	HandleAllocator::HandleAllocator( size_t i_buffer_size, size_t i_max_handles )
+		: m_buffer( nullptr ), m_buffer_size( 0 ), m_end_offset( 0 ), m_compact_offset( 0 ), m_used_size( 0 ),
+		  m_block_count( 0 ), m_entries( nullptr ), m_max_handles( 0 ), m_first_free_entry( 0 )
+	{
+		MEMO_ASSERT( i_max_handles <= 0xFFFFFFFF );
+
+		DefaultAllocator & default_allocator = safe_get_default_allocator();
+		const size_t buffer_size = i_buffer_size & ~( sizeof( BlockHeader ) - 1 );
+		m_buffer = default_allocator.alloc( buffer_size, sizeof( BlockHeader ), 0 );
+		m_entries = static_cast<Entry *>( default_allocator.unaligned_alloc( i_max_handles * sizeof( Entry ) ) );
+		if( m_buffer == nullptr || m_entries == nullptr )
+		{
+			memo_externals::output_message( "HandleAllocator: allocation of the buffer failed\n" );
+			memo_externals::debug_break();
+			return;
+		}
+
+		m_buffer_size = buffer_size;
+		m_max_handles = i_max_handles;
+		for( size_t index = 0; index < m_max_handles; index++ )
+		{
+			m_entries[ index ].m_offset = index + 1;
+			m_entries[ index ].m_size = 0;
+			m_entries[ index ].m_generation = 1;
+			m_entries[ index ].m_pin_count = 0;
+		}
+	}
+
+	// HandleAllocator::destructor
+	HandleAllocator::~HandleAllocator()
+	{
+		DefaultAllocator & default_allocator = safe_get_default_allocator();
+		if( m_buffer != nullptr )
+			default_allocator.free( m_buffer );
+		if( m_entries != nullptr )
+			default_allocator.unaligned_free( m_entries );
+	}
+
+	// HandleAllocator::get_entry
+	HandleAllocator::Entry & HandleAllocator::get_entry( Handle i_handle ) const
+	{
+		MEMO_ASSERT( is_valid( i_handle ) );
+		return m_entries[ i_handle.m_index ];
+	}
+
+	// HandleAllocator::make_hole - writes the header of a hole
+	void HandleAllocator::make_hole( size_t i_offset, size_t i_size )
+	{
+		BlockHeader * header = header_at( i_offset );
+		header->m_size = i_size;
+		header->m_entry = s_free_block;
+	}
+
+	// HandleAllocator::alloc
+	Handle HandleAllocator::alloc( size_t i_size )
+	{
+		const size_t full_size = ( i_size + 2 * sizeof( BlockHeader ) - 1 ) & ~( sizeof( BlockHeader ) - 1 );
+		if( full_size < i_size || m_first_free_entry >= m_max_handles )
+			return Handle();
+
+		if( full_size > m_buffer_size - m_end_offset )
+		{
+			// complete compaction, from the beginning of the buffer
+			m_compact_offset = 0;
+			compact( ~static_cast<size_t>( 0 ) );
+			if( full_size > m_buffer_size - m_end_offset )
+				return Handle();
+		}
+
+		const size_t index = m_first_free_entry;
+		Entry & entry = m_entries[ index ];
+		m_first_free_entry = entry.m_offset;
+		entry.m_offset = m_end_offset;
+		entry.m_size = i_size;
+
+		BlockHeader * header = header_at( m_end_offset );
+		header->m_size = full_size;
+		header->m_entry = index;
+		m_end_offset += full_size;
+		m_used_size += full_size;
+		m_block_count++;
+
+		return Handle( static_cast<uint32_t>( index ), entry.m_generation );
+	}
+
+	// HandleAllocator::free
+	void HandleAllocator::free( Handle i_handle )
+	{
+		Entry & entry = get_entry( i_handle );
+		MEMO_ASSERT( entry.m_pin_count == 0 ); // freeing a pinned block
+
+		BlockHeader * header = header_at( entry.m_offset );
+		const size_t full_size = header->m_size;
+		if( entry.m_offset + full_size == m_end_offset )
+		{
+			// the last block is given back to the free space at the end
+			m_end_offset = entry.m_offset;
+			m_compact_offset = std::min( m_compact_offset, m_end_offset );
+		}
+		else
+			header->m_entry = s_free_block;
+		m_used_size -= full_size;
+		m_block_count--;
+
+		entry.m_generation++;
+		if( entry.m_generation == 0 )
+			entry.m_generation = 1;
+		entry.m_offset = m_first_free_entry;
+		m_first_free_entry = i_handle.m_index;
+	}
+
+	// HandleAllocator::pin
+	void * HandleAllocator::pin( Handle i_handle )
+	{
+		Entry & entry = get_entry( i_handle );
+		entry.m_pin_count++;
+		return header_at( entry.m_offset ) + 1;
+	}
+
+	// HandleAllocator::unpin
+	void HandleAllocator::unpin( Handle i_handle )
+	{
+		Entry & entry = get_entry( i_handle );
+		MEMO_ASSERT( entry.m_pin_count > 0 ); // the block is not pinned
+		entry.m_pin_count--;
+	}
+
+	// HandleAllocator::is_valid
+	bool HandleAllocator::is_valid( Handle i_handle ) const
+	{
+		return !i_handle.is_null() && i_handle.m_index < m_max_handles && m_entries[ i_handle.m_index ].m_generation == i_handle.m_generation;
+	}
+
+	// HandleAllocator::block_size
+	size_t HandleAllocator::block_size( Handle i_handle ) const
+	{
+		return get_entry( i_handle ).m_size;
+	}
+
+	// HandleAllocator::compact
+	bool HandleAllocator::compact( size_t i_max_move_size )
+	{
+		/* The blocks between m_compact_offset and the end are walked. dest is the offset where the next unpinned
+			block is moved. At least a block is moved by every call, so that the compaction always progresses. */
+		size_t source = m_compact_offset, dest = m_compact_offset, moved_size = 0;
+		while( source < m_end_offset )
+		{
+			BlockHeader * header = header_at( source );
+			const size_t full_size = header->m_size;
+
+			if( header->m_entry == s_free_block )
+			{
+				source += full_size;
+				continue;
+			}
+
+			Entry & entry = m_entries[ header->m_entry ];
+			if( entry.m_pin_count > 0 )
+			{
+				// the hole before a pinned block remains
+				if( dest < source )
+					make_hole( dest, source - dest );
+				source += full_size;
+				dest = source;
+				continue;
+			}
+
+			if( dest < source )
+			{
+				if( moved_size > 0 && moved_size + full_size > i_max_move_size )
+				{
+					make_hole( dest, source - dest );
+					m_compact_offset = dest;
+					return false;
+				}
+
+				memmove( header_at( dest ), header, full_size );
+				entry.m_offset = dest;
+				moved_size += full_size;
+			}
+			source += full_size;
+			dest += full_size;
+		}
+
+		m_end_offset = dest;
+		m_compact_offset = 0;
+		return true;
+	}
+
+} // namespace memo
@@ -0,0 +1,172 @@
+
+namespace memo
+{
+	/** \class Handle
+		Compact reference to a memory block allocated by a HandleAllocator. Unlike a pointer, a handle remains valid
+		when the allocator moves the block. A handle is made of the index of an entry of the allocator, and of a
+		generation, so that handles to freed blocks are detected. A default constructed handle is null. */
+	class Handle
+	{
+	public:
+
+		/** Constructs a null handle */
+		Handle()
+			: m_index( 0 ), m_generation( 0 ) { }
+
+		/** Returns true if the handle does not refer to any block */
+		bool is_null() const							{ return m_generation == 0; }
+
+		bool operator == ( const Handle & i_other ) const
+			{ return m_index == i_other.m_index && m_generation == i_other.m_generation; }
+
+		bool operator != ( const Handle & i_other ) const
+			{ return !( *this == i_other ); }
+
+	private:
+		friend class HandleAllocator;
+
+		Handle( uint32_t i_index, uint32_t i_generation )
+			: m_index( i_index ), m_generation( i_generation ) { }
+
+	private: // data members
+		uint32_t m_index;
+		uint32_t m_generation;
+	};
+
+	/**	\class HandleAllocator
+		Allocator whose blocks are referenced by handles (see memo::Handle) instead of pointers, so that it can move
+		them to compact its buffer. To access a block, the user pins it with pin, that returns its current address, and
+		unpins it with unpin when the access is over. The address of a block is valid only while the block is pinned,
+		and pinned blocks are never moved.
+		The blocks are laid in the buffer in address order, every one preceded by a small header. New blocks are taken
+		from the free space at the end of the buffer, while freed blocks leave holes. Compaction slides the unpinned
+		blocks toward the beginning of the buffer, filling the holes, and gives the space back to the free space at the
+		end. Holes in front of pinned blocks remain until the blocks are unpinned.
+		Compaction is incremental: compact moves about the given number of bytes, and the next call resumes from the
+		point reached, so it can be performed a little at a time (for example once per frame or per request). When an
+		allocation does not fit in the free space at the end, a complete compaction is performed.
+		All the blocks are aligned to MEMO_MIN_ALIGNMENT. A header of two size_t is added as overhead to every block.
+		This class is not thread safe. */
+	class HandleAllocator
+	{
+	public:
+
+		/** Constructs the allocator, allocating the buffer and the table of the handles with the default allocator.
+			@param i_buffer_size size of the buffer in which the blocks are allocated
+			@param i_max_handles maximum number of blocks allocated at the same time */
+		HandleAllocator( size_t i_buffer_size, size_t i_max_handles );
+
+		/** Destroys the allocator. All the blocks are freed, so no block should be pinned. */
+		~HandleAllocator();
+
+
+							/// allocation services ///
+
+		/** Allocates a new memory block. The block is not pinned. If the free space at the end of the buffer is not
+			enough, the buffer is compacted before failing.
+			@param i_size size of the block in bytes
+			@return the handle of the block, or a null handle if the allocation fails */
+		Handle alloc( size_t i_size );
+
+		/** Deallocates a memory block. The block must not be pinned.
+			@param i_handle handle of the block. It must be a valid handle. */
+		void free( Handle i_handle );
+
+		/** Pins a memory block, so that it is not moved until it is unpinned, and returns its address. Pins are
+			counted, so a block can be pinned more times, and must be unpinned as many times.
+			@param i_handle handle of the block. It must be a valid handle.
+			@return the address of the first byte of the block */
+		void * pin( Handle i_handle );
+
+		/** Unpins a memory block pinned with pin. If this is the last pin, the address of the block must not be used anymore.
+			@param i_handle handle of the block. It must be a valid handle. */
+		void unpin( Handle i_handle );
+
+		/** Returns whether the handle refers to a block allocated by this allocator */
+		bool is_valid( Handle i_handle ) const;
+
+		/** Returns the size of a memory block, as requested to alloc
+			@param i_handle handle of the block. It must be a valid handle. */
+		size_t block_size( Handle i_handle ) const;
+
+		/** Moves the unpinned blocks toward the beginning of the buffer, filling the holes left by freed blocks.
+			@param i_max_move_size maximum number of bytes to move. The compaction stops before exceeding this limit, and
+				the next call resumes from the point reached. Anyway at least a block is moved, so that the compaction
+				always progresses.
+			@return true if the compaction has reached the end of the buffer, false if it stopped because of the limit */
+		bool compact( size_t i_max_move_size );
+
+
+							/// getters ///
+
+		/** Returns the size of the buffer */
+		size_t buffer_size() const						{ return m_buffer_size; }
+
+		/** Returns the number of bytes used by the allocated blocks, including the headers */
+		size_t used_size() const						{ return m_used_size; }
+
+		/** Returns the number of bytes available at the end of the buffer for new blocks */
+		size_t free_size_at_end() const					{ return m_buffer_size - m_end_offset; }
+
+		/** Returns the number of bytes held by the holes left by freed blocks, that can be recovered by compaction */
+		size_t fragmented_size() const					{ return m_end_offset - m_used_size; }
+
+		/** Returns the number of allocated blocks */
+		size_t block_count() const						{ return m_block_count; }
+
+
+							/// pin scope ///
+
+		/** Pins a block for the lifetime of the object */
+		class PinScope
+		{
+		public:
+
+			/** Pins the block */
+			PinScope( HandleAllocator & i_allocator, Handle i_handle )
+				: m_allocator( i_allocator ), m_handle( i_handle ), m_address( i_allocator.pin( i_handle ) ) { }
+
+			/** Unpins the block */
+			~PinScope()									{ m_allocator.unpin( m_handle ); }
+
+			/** Returns the address of the block */
+			void * address() const						{ return m_address; }
+
+		private:
+			PinScope( const PinScope & ); // not implemented
+			PinScope & operator = ( const PinScope & ); // not implemented
+
+		private: // data members
+			HandleAllocator & m_allocator;
+			Handle m_handle;
+			void * m_address;
+		};
+
+	private:
+		HandleAllocator( const HandleAllocator & ); // not implemented
+		HandleAllocator & operator = ( const HandleAllocator & ); // not implemented
+
+		struct BlockHeader;
+		struct Entry;
+
+		static const size_t s_free_block = ~static_cast<size_t>( 0 ); /**< entry index of the headers of holes */
+
+		BlockHeader * header_at( size_t i_offset ) const
+			{ return static_cast<BlockHeader *>( address_add( m_buffer, i_offset ) ); }
+
+		Entry & get_entry( Handle i_handle ) const;
+		void make_hole( size_t i_offset, size_t i_size );
+
+	private: // data members
+		void * m_buffer;
+		size_t m_buffer_size;
+		size_t m_end_offset; /**< offset of the free space at the end of the buffer */
+		size_t m_compact_offset; /**< offset from which the next compaction resumes */
+		size_t m_used_size; /**< size of the allocated blocks, including the headers */
+		size_t m_block_count;
+		Entry * m_entries;
+		size_t m_max_handles;
+		size_t m_first_free_entry; /**< index of the first unused entry, or m_max_handles */
+	};
+
+} // namespace memo
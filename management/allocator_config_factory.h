@@ -31,7 +31,7 @@ namespace memo
 
 		template < typename ALLOCATOR >
 			static IAllocator::Config * _default_allocator_config_creater()
-				{ return MEMO_NEW( ALLOCATOR::Config ); }
+				{ return MEMO_NEW( typename ALLOCATOR::Config ); }
 
 		/** Prototype of the function that creates the config structure */
 		typedef IAllocator::Config * (*CreaterConfigFunction)();
@@ -21,12 +21,30 @@ namespace memo
 
 	// MemoryManager::constructor
 	MemoryManager::MemoryManager()
+		: m_first_pool( nullptr )
 	{
 		m_allocator_config_factory.register_allocator<DefaultAllocator>();
 		m_allocator_config_factory.register_allocator<DebugAllocator>();
 		m_allocator_config_factory.register_allocator<StatAllocator>();
+		m_allocator_config_factory.register_allocator<ThreadCacheAllocator>();
+		m_allocator_config_factory.register_allocator<PoolAllocator>();
+		m_allocator_config_factory.register_allocator<LinearAllocator>();
+		m_allocator_config_factory.register_allocator<SlabAllocator>();
+		m_allocator_config_factory.register_allocator<BuddyAllocator>();
+		#if MEMO_ENABLE_SHARED_MEMORY
+			m_allocator_config_factory.register_allocator<SharedRegionAllocator>();
+		#endif
+		m_allocator_config_factory.register_allocator< Static<StatPolicy, DefaultBackend> >();
+		m_allocator_config_factory.register_allocator< Static<DebugPolicy, DefaultBackend> >();
+		m_allocator_config_factory.register_allocator< Static<StatPolicy, DebugPolicy, DefaultBackend> >();
 		#if MEMO_ENABLE_TLSF
 			m_allocator_config_factory.register_allocator<TlsfAllocator>();
+			m_allocator_config_factory.register_allocator<TlsfArenaAllocator>();
+			#if MEMO_ENABLE_NUMA
+				m_allocator_config_factory.register_allocator<NodeArenaAllocator>();
+			#endif
+			m_allocator_config_factory.register_allocator< Static<StatPolicy, TlsfBackend> >();
+			m_allocator_config_factory.register_allocator< Static<StatPolicy, DebugPolicy, TlsfBackend> >();
 			#if defined( _WIN32 )
 				m_allocator_config_factory.register_allocator<CorruptionDetectorAllocator>();
 			#endif
@@ -55,6 +73,10 @@ namespace memo
 		if( i_context.allocator_config() != nullptr )
 		{			
 			allocator = i_context.allocator_config()->create_allocator();
+			#if MEMO_ENABLE_PAGE_MAP
+				// the allocators of the contexts are not targets of other allocators, so they can be dispatched by address
+				allocator->register_in_page_map();
+			#endif
 		}
 		entry.m_allocator = allocator;
 
@@ -81,6 +103,16 @@ namespace memo
 
 	// MemoryManager::dump_contexts
 	bool MemoryManager::dump_contexts( const NamePath & i_path, IAllocator::StateWriter & i_state_writer ) const
+	{
+		if( !_dump_context( i_path, i_state_writer ) )
+			return false;
+
+		_dump_pools( i_state_writer );
+		return true;
+	}
+
+	// MemoryManager::_dump_context - dumps a context and its sub-contexts
+	bool MemoryManager::_dump_context( const NamePath & i_path, IAllocator::StateWriter & i_state_writer ) const
 	{
 		ContextMap::const_iterator it = m_contexts_map.find( i_path );
 		if( it == m_contexts_map.end() )
@@ -91,7 +123,8 @@ namespace memo
 		i_state_writer.tab( "context" );
 		i_state_writer.write( "name", entry.m_config->name().name() );
 
-		entry.m_allocator->dump_state( i_state_writer );
+		if( entry.m_allocator != nullptr ) // a context may have no allocator
+			entry.m_allocator->dump_state( i_state_writer );
 
 		const ContextConfig::ContextVector & inner_contexts = entry.m_config->inner_contexts();
 		const size_t context_count = inner_contexts.size();
@@ -102,7 +135,7 @@ namespace memo
 			NamePath path( i_path );
 			path.append_context( inner_context->name() );
 
-			bool result = dump_contexts( path, i_state_writer );
+			bool result = _dump_context( path, i_state_writer );
 			MEMO_ASSERT( result );
 			#if !MEMO_ENABLE_ASSERT
 				MEMO_UNUSED(result);
@@ -113,6 +146,54 @@ namespace memo
 		return true;
 	}
 
+	// MemoryManager::_dump_pools
+	void MemoryManager::_dump_pools( IAllocator::StateWriter & i_state_writer ) const
+	{
+		MutexLock lock( m_pools_mutex );
+		for( RegisteredPool * pool = m_first_pool; pool != nullptr; pool = pool->m_next_pool )
+		{
+			i_state_writer.tab( "pool" );
+			i_state_writer.write( "type", pool->type_name() );
+			pool->dump_state( i_state_writer );
+			i_state_writer.untab();
+		}
+	}
+
+	// MemoryManager::register_pool
+	void MemoryManager::register_pool( RegisteredPool & i_pool )
+	{
+		MutexLock lock( m_pools_mutex );
+		MEMO_ASSERT( i_pool.m_next_pool == nullptr );
+		i_pool.m_next_pool = m_first_pool;
+		m_first_pool = &i_pool;
+	}
+
+	// MemoryManager::unregister_pool
+	void MemoryManager::unregister_pool( RegisteredPool & i_pool )
+	{
+		MutexLock lock( m_pools_mutex );
+		RegisteredPool * * prev_link = &m_first_pool;
+		while( *prev_link != &i_pool )
+		{
+			MEMO_ASSERT( *prev_link != nullptr ); // the pool is not registered
+			prev_link = &(*prev_link)->m_next_pool;
+		}
+		*prev_link = i_pool.m_next_pool;
+		i_pool.m_next_pool = nullptr;
+	}
+
+	// RegisteredPool::register_pool
+	void RegisteredPool::register_pool()
+	{
+		MemoryManager::get_instance().register_pool( *this );
+	}
+
+	// RegisteredPool::unregister_pool
+	void RegisteredPool::unregister_pool()
+	{
+		MemoryManager::get_instance().unregister_pool( *this );
+	}
+
 	void MemoryManager::Config::load( serialization::IConfigReader & i_config_reader )
 	{
 		while( i_config_reader.read_next_property() )
@@ -47,12 +47,20 @@ namespace memo
 		AllocatorConfigFactory & allocator_config_factor()					{ return m_allocator_config_factory; }
 		const AllocatorConfigFactory & allocator_config_factor() const		{ return m_allocator_config_factory; }
 
-		/** Dumps the state of the allocators associated to a context and all its sub-contexts.
+		/** Dumps the state of the allocators associated to a context and all its sub-contexts, and then the state of
+			the registered pools (see MemoryManager::register_pool).
 				@param i_path path of the context to dump
 				@param i_state_writer state-writer object to receive the state of the allocators.
 			@return true if the context was found, false	otherwise */
 		bool dump_contexts( const NamePath & i_path, IAllocator::StateWriter & i_state_writer ) const;
 
+		/** Adds a pool to the list dumped by dump_contexts (see RegisteredPool). The pool must be unregistered before
+			being destroyed. This method is thread safe. */
+		void register_pool( RegisteredPool & i_pool );
+
+		/** Removes a pool from the list dumped by dump_contexts. This method is thread safe. */
+		void unregister_pool( RegisteredPool & i_pool );
+
 		/** Retrieve the capacity of the pool to use for the specified type, if specified in the
 			memory configuration file. */
 		bool get_pool_object_count( const char * i_type_name, size_t * o_result ) const;
@@ -65,6 +73,8 @@ namespace memo
 		MemoryManager & operator = ( const MemoryManager & ); // not implemented
 
 		void _build_context_maps( const ContextConfig & i_context, const NamePath & i_context_path );
+		bool _dump_context( const NamePath & i_path, IAllocator::StateWriter & i_state_writer ) const;
+		void _dump_pools( IAllocator::StateWriter & i_state_writer ) const;
 		
 	private: // data members
 
@@ -82,6 +92,10 @@ namespace memo
 
 		// config factory
 		AllocatorConfigFactory m_allocator_config_factory;
+
+		// registered pools
+		mutable memo_externals::Mutex m_pools_mutex; /**< protects the list of the registered pools */
+		RegisteredPool * m_first_pool;
 	};
 
 
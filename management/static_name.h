@@ -26,7 +26,7 @@ namespace memo
 
 		/** Initializes the name to a string literal */
 		template < size_t NAME_LENGTH > StaticName( const char (&i_name)[ NAME_LENGTH ] )		
-			: m_hash( compute_hash( i_name, LENGTH ) ), m_name( i_name ) { }
+			: m_hash( compute_hash( i_name, NAME_LENGTH - 1 ) ), m_name( i_name ) { }
 
 		/** Returns the hash of the string */
 		ContextHash hash() const			{ return m_hash; }
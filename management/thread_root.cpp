@@ -45,6 +45,7 @@ namespace memo
 
 	// ThreadRoot::constructor
 	ThreadRoot::ThreadRoot( const char * i_thread_name )
+		: m_first_local_object( nullptr )
 	{
 		MemoryManager::get_instance();
 
@@ -69,7 +70,64 @@ namespace memo
 			MEMO_ASSERT( thread_context == this );
 		#endif
 
+		// the objects are unlinked before being notified, as they may destroy themselves
+		while( m_first_local_object != nullptr )
+		{
+			LocalObject * object = m_first_local_object;
+			m_first_local_object = object->m_next;
+			object->m_next = nullptr;
+			object->on_thread_exit();
+		}
+
 		memo_externals::set_thread_root( nullptr );
 	}
 
+	// ThreadRoot::add_local_object
+	void ThreadRoot::add_local_object( const void * i_key, LocalObject * i_object )
+	{
+		MEMO_ASSERT( i_object != nullptr && i_object->m_next == nullptr );
+		MEMO_ASSERT( _find_local_object( i_key ) == nullptr );
+
+		i_object->m_key = i_key;
+		i_object->m_next = m_first_local_object;
+		m_first_local_object = i_object;
+	}
+
+	// ThreadRoot::remove_local_object
+	bool ThreadRoot::remove_local_object( LocalObject * i_object )
+	{
+		for( LocalObject * * link = &m_first_local_object; *link != nullptr; link = &(*link)->m_next )
+		{
+			if( *link == i_object )
+			{
+				*link = i_object->m_next;
+				i_object->m_next = nullptr;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// ThreadRoot::_find_local_object
+	ThreadRoot::LocalObject * ThreadRoot::_find_local_object( const void * i_key )
+	{
+		LocalObject * prev = nullptr;
+		for( LocalObject * object = m_first_local_object; object != nullptr; object = object->m_next )
+		{
+			if( object->m_key == i_key )
+			{
+				if( prev != nullptr )
+				{
+					// move to front
+					prev->m_next = object->m_next;
+					object->m_next = m_first_local_object;
+					m_first_local_object = object;
+				}
+				return object;
+			}
+			prev = object;
+		}
+		return nullptr;
+	}
+
 } // namespace memo
\ No newline at end of file
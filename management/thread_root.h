@@ -44,14 +44,61 @@ namespace memo
 
 		ObjectStack & lifo_allocator()			{ return m_lifo_allocator; }
 
+
+					//// thread local objects ////
+
+		/** Base class for objects that an allocator keeps for every thread (for example a cache). Every object is
+			linked to the ThreadRoot of its thread, and is identified by a key, usually the address of its owner.
+			When the ThreadRoot is destroyed, on_thread_exit is called for every object still linked to it. */
+		class LocalObject
+		{
+		public:
+
+			LocalObject() : m_key( nullptr ), m_next( nullptr ) { }
+
+			/** Called when the thread exits. The object has already been unlinked from the ThreadRoot, and it 
+				should release its resources and destroy itself. */
+			virtual void on_thread_exit() = 0;
+
+		protected:
+
+			virtual ~LocalObject() { }
+
+		private:
+			friend class ThreadRoot;
+			const void * m_key;
+			LocalObject * m_next;
+		};
+
+		/** Finds the object associated to the given key, and moves it to the front of the list, so that
+			the lookup of the most recently used object costs a single comparison.
+			@return the object associated to the key, or nullptr if no object is associated to it */
+		LocalObject * find_local_object( const void * i_key )
+		{
+			LocalObject * first = m_first_local_object;
+			if( first != nullptr && first->m_key == i_key )
+				return first;
+			return _find_local_object( i_key );
+		}
+
+		/** Links an object to this ThreadRoot. The key must not be already associated to another object. */
+		void add_local_object( const void * i_key, LocalObject * i_object );
+
+		/** Unlinks an object from this ThreadRoot. on_thread_exit is not called.
+			@return true if the object was found, false otherwise */
+		bool remove_local_object( LocalObject * i_object );
+
 	private: // internal services
 		struct DefaultAllocSetter
 			{ DefaultAllocSetter(); };
 
+		LocalObject * _find_local_object( const void * i_key );
+
 	private: // data members
 		DefaultAllocSetter m_default_alloc_setter;
 		ContextStack m_context_stack;
 		ObjectStack m_lifo_allocator;
+		LocalObject * m_first_local_object;
 	};
 
 } // namespace memo
@@ -161,11 +161,12 @@ namespace memo
 
 #include "allocation_functions.cpp"
 #include "address_functions.cpp"
-#include "allocators\allocators.cpp"
-#include "lifo\lifo.cpp"
-#include "fifo\fifo.cpp"
-#include "pool\pool.cpp"
-#include "management\management.cpp"
+#include "allocators/allocators.cpp"
+#include "lifo/lifo.cpp"
+#include "fifo/fifo.cpp"
+#include "pool/pool.cpp"
+#include "handle/handle.cpp"
+#include "management/management.cpp"
 #if MEMO_ENABLE_TEST
 	#include "memo_test.cpp"
 #endif
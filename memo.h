@@ -4,11 +4,20 @@
 #define MEMO_INCLUDED
 
 #include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <limits>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
 #include <deque>
 #include <queue>
 #include <memory>
+#include <type_traits>
 
 #ifdef _MSC_VER
 	#pragma warning( push )
@@ -23,8 +32,17 @@ namespace memo // classes' forward declarations
 		class DecoratorAllocator; /** abstract base for classes that add functionality to other allocators */
 			class DebugAllocator; /** adds debug functionalities to another allocator */
 			class StatAllocator; /** collects statistics about the usage of another allocator */
+			class ThreadCacheAllocator; /** keeps per-thread caches of small blocks in front of another allocator */
+			class PoolAllocator; /** serves small blocks from an UntypedPool for every size class, in front of another allocator */
 		class RegionAllocator;
+			class LinearAllocator; /** bump-pointer allocator whose blocks are freed all at once by reset or rewind_to */
+			class SlabAllocator; /** serves small blocks from slabs dedicated to size classes */
+			class BuddyAllocator; /** binary buddy system for big blocks whose size is a power of 2 */
 			class TlsfAllocator;
+		class TlsfArenaAllocator; /** gives to every thread its own tlsf arena, with lock-free remote frees */
+		class NodeArenaAllocator; /** gives to every NUMA node its own tlsf arena, bound to the memory of the node */
+		class SharedRegionAllocator; /** tlsf heap in a shared memory object, usable by more processes */
+	class PageMap; /** maps the address space to the allocators owning it */
 
 	template <typename TYPE> class StdAllocator; /** implements a standard library allocator wrapping 
 														memo allocation functions. */
@@ -38,6 +56,10 @@ namespace memo // classes' forward declarations
 	class ObjectStack;
 	class LifoObjectAllocator;
 
+	// handles
+	class Handle; /** compact reference to a block of a HandleAllocator */
+	class HandleAllocator; /** allocator whose blocks are referenced by handles, and can be moved to compact the buffer */
+
 	typedef void (*DeallocationCallback)( void * i_memory_block );
 
 	template <typename TYPE> 
@@ -85,18 +107,25 @@ namespace memo
 		memo_externals::Mutex & m_mutex;
 	};
 
-} // namespace memo
+	#if MEMO_ENABLE_SHARED_MEMORY
 
-#include "allocation_functions.h"
-#include "allocation_dispatcher.h"
-#include "address_functions.h"
-#include "std_allocator.h"
-#include "std_containers.h"
-#include "allocators\allocators.h"
-#include "lifo\lifo.h"
-#include "fifo\fifo.h"
-#include "pool\pool.h"
-#include "management\management.h"
+		class SharedMutexLock
+		{
+		public:
+			SharedMutexLock( memo_externals::SharedMutex & i_mutex ) : m_mutex( i_mutex ) { m_mutex.lock(); }
+			~SharedMutexLock() { m_mutex.unlock(); }
+
+		private:
+			SharedMutexLock( const SharedMutexLock & ); // unimplemented
+			SharedMutexLock & operator = ( const SharedMutexLock & ); // unimplemented
+
+		private:
+			memo_externals::SharedMutex & m_mutex;
+		};
+
+	#endif
+
+} // namespace memo
 
 namespace memo
 {
@@ -134,6 +163,18 @@ namespace memo
 
 } // namespace memo
 
+#include "allocation_functions.h"
+#include "allocation_dispatcher.h"
+#include "address_functions.h"
+#include "std_allocator.h"
+#include "std_containers.h"
+#include "allocators/allocators.h"
+#include "lifo/lifo.h"
+#include "fifo/fifo.h"
+#include "pool/pool.h"
+#include "handle/handle.h"
+#include "management/management.h"
+
 #include "allocation_functions.inl" // this source contains function templates, so it must be included anyway
 
 /* if MEMO_ENABLE_INLINE is true then .inl files are included in memo.h, otherwise 
@@ -170,7 +211,15 @@ Here is some common allocators:
 -	memo::DefaultAllocator, which wraps the system malloc/free
 -	memo::DebugAllocator, which decorates another allocator and adds no man's land around memory blocks and initializes memory to help to catch uninitialized variables and dangling pointers
 -	memo::StatAllocator, which decorates another allocator to keep tracks of: total memory allocated, total block count, and allocation peaks
+-	memo::ThreadCacheAllocator, which decorates another allocator with per-thread caches of small blocks, so that most allocations do not need any lock
+-	memo::PoolAllocator, which decorates another allocator with an UntypedPool for every size class from 8 bytes to a maximum size
 -	memo::TlsfAllocator, which wraps the two level segregate allocator written by Matthew Conte (http://tlsf.baisoku.org)
+-	memo::LinearAllocator, which allocates incrementing a pointer in a buffer, and frees all the blocks at once with reset
+-	memo::SlabAllocator, which serves small blocks from slabs dedicated to size classes, without a header per block
+-	memo::BuddyAllocator, which splits and merges blocks whose size is a power of 2, aligned to their size
+-	memo::TlsfArenaAllocator, which gives to every thread its own TlsfAllocator, and sends the blocks freed by other threads to a lock-free list
+-	memo::NodeArenaAllocator, which gives to every NUMA node its own TlsfAllocator, whose regions are bound to the memory of the node
+-	memo::SharedRegionAllocator, which manages a heap in a named shared memory object, so that more processes can exchange blocks as offsets without copying them
 
 ![Allocator Hierarchy](classmemo_1_1_i_allocator__inherit__graph.png)
 
@@ -237,14 +286,17 @@ Anyway, you may want to use memo just to analyze the memory usage in the debug b
 
 \section pool Pools
 Memo supports efficient fixed-size allocations with pools (memo::TypedPool amd memo::UntypedPool). The pool is initialized with a capacity,
-and can allocate objects up to its capacity. When the pool is full, it uses the default allocator, but this mechanism
-is transparent for the user. The pool has no space overhead, and does not fragment the memory.
+and can allocate objects up to its capacity. When the pool is full, it uses the default allocator, or, if it has been
+initialized with a growth factor, it adds a chunk of slots. This mechanism is transparent for the user. The pool has no space overhead, and does not fragment the memory.
 You can use the pool directly, or you can enable automatic pooling for type by using the macro MEMO_ENABLE_POOL:
 \code{.cpp}
 MEMO_ENABLE_POOL( MyClass, 2000 );
 \endcode
 This declarations tells memo to redirect every MEMO_NEW and MEMO_DELETE of MyClass to pool whose capacity is by default 2000. You can override
-this capacity in the memory configuration file.
+this capacity in the memory configuration file. When the capacity is over the pool grows by chunks, each with twice the capacity of the previous one.
+MEMO_ENABLE_POOL protects the pool with a mutex. For types created and destroyed by many threads at the same time you can use
+MEMO_ENABLE_CONCURRENT_POOL instead, which uses a memo::ConcurrentPool: every thread allocates from its own cache of free slots,
+and the caches exchange batches of slots with a lock-free stack.
 
 \section lifoallocator Data Stack and lifo allocations
 Memo allows to use a thread specific data stack, to perform efficient lifo (last-in, first-out) allocations. The lifo constraint is suited to:
@@ -277,6 +329,20 @@ As example of this scenario consider a command queue of a thread, with every com
 A second and similar use case may be a command buffer for a graphic renderer.
 See memo::FifoAllocator and memo::Queue for details.
 
+\section handleallocator Handles and compaction
+In long-running programs the free space of an allocator may become fragmented, so that big allocations fail even if the
+total free space is enough. memo::HandleAllocator references its blocks with handles (memo::Handle) instead of pointers, so
+it can move them to compact its buffer. A block must be pinned to be accessed, and pinned blocks are never moved:
+\code{.cpp}
+memo::Handle handle = handle_allocator.alloc( sizeof( MyData ) );
+{
+	memo::HandleAllocator::PinScope pin( handle_allocator, handle );
+	MyData * data = static_cast< MyData * >( pin.address() );
+	// ... use data
+}
+handle_allocator.compact( 64 * 1024 ); // moves at most about 64 KB of blocks
+\endcode
+
 \section corruptiondetector Detecting memory corruption
 Memo includes a special allocator to help to find bugs in the code that causes wrong memory access and memory corruption. CorruptionDetectorAllocator can detect:
 - read accesses to memory that was allocated but never written (i.e. uninitialized memory usage)
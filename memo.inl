@@ -1,6 +1,7 @@
 
-#include "allocators\default_allocator.inl"
-#include "lifo\lifo.inl"
-#include "fifo\fifo.inl"
-#include "pool\pool.inl"
+#include "allocation_functions_inline.inl"
+#include "allocators/default_allocator.inl"
+#include "lifo/lifo.inl"
+#include "fifo/fifo.inl"
+#include "pool/pool.inl"
 	
@@ -0,0 +1,499 @@
+#include "../memo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+/* memo_bench - measures the throughput and the latency of the allocators of memo.
+	Every subject (an allocator, a pool, an ObjectStack or a Queue) runs the same fixed workloads, with a fixed random seed,
+	with 1, 2, 4... threads up to the maximum thread count. Subjects that are not thread-safe run only with one thread.
+	Every run is executed twice: the first pass measures the throughput (operations per second, where an operation is an
+	allocation or a deallocation), the second pass measures the latency of every single operation, and reports the
+	percentiles 50, 99 and 99.9 of allocations and deallocations. The overhead of the clock is measured at startup and
+	subtracted from every sample.
+	Usage: memo_bench [operations per thread] [max thread count] */
+
+namespace memo_bench
+{
+	typedef std::chrono::steady_clock Clock;
+
+	/** Distribution of the sizes and alignment of the blocks allocated by a workload */
+	struct Workload
+	{
+		const char * m_name;
+		size_t m_min_size; /**< minimum size of the common blocks */
+		size_t m_max_size; /**< maximum size of the common blocks */
+		size_t m_large_min_size; /**< minimum size of the occasional large blocks */
+		size_t m_large_max_size; /**< maximum size of the occasional large blocks */
+		uint32_t m_large_per_thousand; /**< number of large blocks every thousand allocations */
+		size_t m_alignment;
+		size_t m_alignment_offset;
+
+		size_t max_size() const { return m_large_per_thousand > 0 ? m_large_max_size : m_max_size; }
+
+		size_t generate_size( uint32_t & io_rand_seed ) const
+		{
+			const uint32_t rand = memo::generate_rand_32( io_rand_seed );
+			if( m_large_per_thousand > 0 && ( rand >> 16 ) % 1000 < m_large_per_thousand )
+				return m_large_min_size + memo::generate_rand_32( io_rand_seed ) % ( m_large_max_size - m_large_min_size + 1 );
+			else
+				return m_min_size + rand % ( m_max_size - m_min_size + 1 );
+		}
+	};
+
+	static const Workload g_workloads[] =
+	{
+		{ "small",		8, 128,			0, 0,				0,		MEMO_MIN_ALIGNMENT, 0 },
+		{ "medium",		128, 4096,		0, 0,				0,		MEMO_MIN_ALIGNMENT, 0 },
+		{ "large",		4096, 65536,	0, 0,				0,		MEMO_MIN_ALIGNMENT, 0 },
+		{ "mixed",		8, 256,			4096, 65536,		10,		MEMO_MIN_ALIGNMENT, 0 },
+		{ "small/64",	8, 128,			0, 0,				0,		64, 0 },
+		{ "small/64+8",	8, 128,			0, 0,				0,		64, 8 },
+		{ "mixed/64+16",8, 256,			4096, 65536,		10,		64, 16 },
+	};
+
+	/** Order in which the blocks are freed */
+	enum Pattern
+	{
+		eRandomOrder, /**< any living block can be freed */
+		eLifoOrder, /**< only the last allocated block can be freed */
+		eFifoOrder, /**< only the first allocated block can be freed */
+	};
+
+	/** Something that can be benchmarked. The operations are called through a virtual function, so every
+		subject pays the same overhead. */
+	class Subject
+	{
+	public:
+
+		virtual ~Subject() { }
+
+		virtual const char * name() const = 0;
+
+		virtual bool is_thread_safe() const { return true; }
+
+		virtual Pattern pattern() const { return eRandomOrder; }
+
+		virtual bool supports( const Workload & /*i_workload*/ ) const { return true; }
+
+		virtual void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset ) = 0;
+
+		virtual void free( void * i_address, size_t i_size ) = 0;
+	};
+
+	/** Subject that uses an IAllocator */
+	class AllocatorSubject : public Subject
+	{
+	public:
+
+		AllocatorSubject( const char * i_name, memo::IAllocator * i_allocator, bool i_owns_allocator, bool i_thread_safe )
+			: m_name( i_name ), m_allocator( i_allocator ), m_owns_allocator( i_owns_allocator ), m_thread_safe( i_thread_safe ) { }
+
+		~AllocatorSubject()
+		{
+			if( m_owns_allocator )
+				MEMO_DELETE( m_allocator );
+		}
+
+		const char * name() const { return m_name; }
+
+		bool is_thread_safe() const { return m_thread_safe; }
+
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return m_allocator->alloc( i_size, i_alignment, i_alignment_offset );
+		}
+
+		void free( void * i_address, size_t i_size )
+		{
+			m_allocator->free( i_address, i_size );
+		}
+
+	private:
+		const char * m_name;
+		memo::IAllocator * m_allocator;
+		bool m_owns_allocator, m_thread_safe;
+	};
+
+	/** Subject that uses an UntypedPool. Only workloads whose blocks fit in an element are supported. */
+	class PoolSubject : public Subject
+	{
+	public:
+
+		static const size_t s_element_size = 256;
+		static const size_t s_element_alignment = 64;
+
+		PoolSubject( size_t i_element_count )
+		{
+			m_pool.init( memo::UntypedPool::Config( s_element_size, s_element_alignment, i_element_count ) );
+		}
+
+		const char * name() const { return "UntypedPool"; }
+
+		bool is_thread_safe() const { return false; }
+
+		bool supports( const Workload & i_workload ) const
+		{
+			return i_workload.max_size() <= s_element_size && i_workload.m_alignment <= s_element_alignment
+				&& i_workload.m_alignment_offset == 0;
+		}
+
+		void * alloc( size_t /*i_size*/, size_t /*i_alignment*/, size_t /*i_alignment_offset*/ )
+		{
+			return m_pool.alloc();
+		}
+
+		void free( void * i_address, size_t /*i_size*/ )
+		{
+			m_pool.free( i_address );
+		}
+
+	private:
+		memo::UntypedPool m_pool;
+	};
+
+	/** Subject that uses an ObjectStack */
+	class ObjectStackSubject : public Subject
+	{
+	public:
+
+		ObjectStackSubject()
+		{
+			m_stack.init( memo::safe_get_default_allocator(), 1024 * 1024, 1024 * 1024 );
+		}
+
+		const char * name() const { return "ObjectStack"; }
+
+		bool is_thread_safe() const { return false; }
+
+		Pattern pattern() const { return eLifoOrder; }
+
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return m_stack.alloc( i_size, i_alignment, i_alignment_offset, nullptr );
+		}
+
+		void free( void * i_address, size_t /*i_size*/ )
+		{
+			m_stack.free( i_address );
+		}
+
+	private:
+		memo::ObjectStack m_stack;
+	};
+
+	/** Subject that uses a Queue */
+	class QueueSubject : public Subject
+	{
+	public:
+
+		QueueSubject()
+		{
+			m_queue.init( memo::safe_get_default_allocator(), 1024 * 1024, 1024 * 1024 );
+		}
+
+		const char * name() const { return "Queue"; }
+
+		bool is_thread_safe() const { return false; }
+
+		Pattern pattern() const { return eFifoOrder; }
+
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+		{
+			return m_queue.alloc( i_size, i_alignment, i_alignment_offset );
+		}
+
+		void free( void * i_address, size_t /*i_size*/ )
+		{
+			m_queue.free_first( i_address );
+		}
+
+	private:
+		memo::Queue m_queue;
+	};
+
+	/** Result of the run of a thread */
+	struct ThreadResult
+	{
+		size_t m_operations;
+		std::vector<uint32_t> m_alloc_latencies; /**< nanoseconds, filled only by the latency pass */
+		std::vector<uint32_t> m_free_latencies; /**< nanoseconds, filled only by the latency pass */
+		bool m_failed;
+
+		ThreadResult() : m_operations( 0 ), m_failed( false ) { }
+	};
+
+	static const size_t g_max_living_blocks = 512;
+	static uint32_t g_clock_overhead = 0;
+
+	// to_nanoseconds
+	static uint32_t to_nanoseconds( Clock::time_point i_start, Clock::time_point i_end )
+	{
+		const long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>( i_end - i_start ).count();
+		if( nanoseconds <= static_cast<long long>( g_clock_overhead ) )
+			return 0;
+		return nanoseconds - g_clock_overhead < 0xFFFFFFFF ? static_cast<uint32_t>( nanoseconds - g_clock_overhead ) : 0xFFFFFFFF;
+	}
+
+	// measure_clock_overhead - returns the median of the time measured by two consecutive readings of the clock
+	static uint32_t measure_clock_overhead()
+	{
+		std::vector<uint32_t> samples( 10000 );
+		for( size_t index = 0; index < samples.size(); index++ )
+		{
+			const Clock::time_point start = Clock::now();
+			const Clock::time_point end = Clock::now();
+			samples[ index ] = static_cast<uint32_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() );
+		}
+		std::nth_element( samples.begin(), samples.begin() + samples.size() / 2, samples.end() );
+		return samples[ samples.size() / 2 ];
+	}
+
+	/** Runs a workload on a subject. Up to g_max_living_blocks are alive at the same time: every step allocates a block if
+		there is no living block, frees one if the limit is reached, and otherwise does one of the two randomly. The block to
+		free is chosen according to the pattern of the subject. If MEASURE_LATENCY is true every operation is timed. */
+	template < bool MEASURE_LATENCY >
+		static void run_thread( Subject & i_subject, const Workload & i_workload, size_t i_operations, uint32_t i_rand_seed, ThreadResult & o_result )
+	{
+		struct Block
+		{
+			void * m_address;
+			size_t m_size;
+		};
+		Block blocks[ g_max_living_blocks ];
+		size_t first_block = 0, block_count = 0; // blocks is used as a circular buffer for the fifo order
+
+		uint32_t rand_seed = i_rand_seed;
+		const Pattern pattern = i_subject.pattern();
+		if( MEASURE_LATENCY )
+		{
+			o_result.m_alloc_latencies.reserve( i_operations / 2 + g_max_living_blocks );
+			o_result.m_free_latencies.reserve( i_operations / 2 + g_max_living_blocks );
+		}
+
+		for( size_t operation = 0; operation < i_operations + block_count; operation++ )
+		{
+			const bool do_alloc = operation < i_operations && block_count < g_max_living_blocks &&
+				( block_count == 0 || ( memo::generate_rand_32( rand_seed ) & 1 ) != 0 );
+			if( do_alloc )
+			{
+				const size_t size = i_workload.generate_size( rand_seed );
+				Clock::time_point start;
+				if( MEASURE_LATENCY )
+					start = Clock::now();
+				void * address = i_subject.alloc( size, i_workload.m_alignment, i_workload.m_alignment_offset );
+				if( MEASURE_LATENCY )
+					o_result.m_alloc_latencies.push_back( to_nanoseconds( start, Clock::now() ) );
+				if( address == nullptr )
+				{
+					o_result.m_failed = true;
+					break;
+				}
+				*static_cast<char*>( address ) = 0; // touch the block
+				Block & block = blocks[ ( first_block + block_count ) % g_max_living_blocks ];
+				block.m_address = address;
+				block.m_size = size;
+				block_count++;
+			}
+			else
+			{
+				size_t index;
+				switch( pattern )
+				{
+					default:
+					case eRandomOrder:
+						index = ( first_block + memo::generate_rand_32( rand_seed ) % block_count ) % g_max_living_blocks;
+						break;
+					case eLifoOrder:
+						index = ( first_block + block_count - 1 ) % g_max_living_blocks;
+						break;
+					case eFifoOrder:
+						index = first_block;
+						break;
+				}
+				const Block block = blocks[ index ];
+				Clock::time_point start;
+				if( MEASURE_LATENCY )
+					start = Clock::now();
+				i_subject.free( block.m_address, block.m_size );
+				if( MEASURE_LATENCY )
+					o_result.m_free_latencies.push_back( to_nanoseconds( start, Clock::now() ) );
+				if( pattern == eFifoOrder )
+					first_block = ( first_block + 1 ) % g_max_living_blocks;
+				else
+					blocks[ index ] = blocks[ ( first_block + block_count - 1 ) % g_max_living_blocks ];
+				block_count--;
+			}
+			o_result.m_operations++;
+		}
+
+		// if an allocation has failed, free the living blocks
+		while( block_count > 0 )
+		{
+			const size_t index = pattern == eFifoOrder ? first_block : ( first_block + block_count - 1 ) % g_max_living_blocks;
+			i_subject.free( blocks[ index ].m_address, blocks[ index ].m_size );
+			if( pattern == eFifoOrder )
+				first_block = ( first_block + 1 ) % g_max_living_blocks;
+			block_count--;
+		}
+	}
+
+	// thread_procedure
+	template < bool MEASURE_LATENCY >
+		static void thread_procedure( Subject * i_subject, const Workload * i_workload, size_t i_operations, uint32_t i_rand_seed, ThreadResult * o_result )
+	{
+		memo::ThreadRoot thread_root( "memo_bench" );
+		run_thread<MEASURE_LATENCY>( *i_subject, *i_workload, i_operations, i_rand_seed, *o_result );
+	}
+
+	/** Runs a workload on the specified number of threads, and returns the elapsed time in seconds */
+	template < bool MEASURE_LATENCY >
+		static double run( Subject & i_subject, const Workload & i_workload, size_t i_operations, size_t i_thread_count, std::vector<ThreadResult> & o_results )
+	{
+		o_results.clear();
+		o_results.resize( i_thread_count );
+		const Clock::time_point start = Clock::now();
+		if( i_thread_count == 1 )
+		{
+			run_thread<MEASURE_LATENCY>( i_subject, i_workload, i_operations, 0x1234567, o_results[ 0 ] );
+		}
+		else
+		{
+			std::vector<std::thread> threads;
+			for( size_t index = 0; index < i_thread_count; index++ )
+			{
+				threads.push_back( std::thread( &thread_procedure<MEASURE_LATENCY>, &i_subject, &i_workload, i_operations,
+					static_cast<uint32_t>( 0x1234567 + index * 0x9E3779B9 ), &o_results[ index ] ) );
+			}
+			for( size_t index = 0; index < i_thread_count; index++ )
+				threads[ index ].join();
+		}
+		return std::chrono::duration<double>( Clock::now() - start ).count();
+	}
+
+	// percentile - i_samples is partially sorted
+	static uint32_t percentile( std::vector<uint32_t> & i_samples, size_t i_per_thousand )
+	{
+		if( i_samples.empty() )
+			return 0;
+		const size_t index = std::min( i_samples.size() * i_per_thousand / 1000, i_samples.size() - 1 );
+		std::nth_element( i_samples.begin(), i_samples.begin() + index, i_samples.end() );
+		return i_samples[ index ];
+	}
+
+	// benchmark - runs all the supported workloads on a subject, and prints the results
+	static void benchmark( Subject & i_subject, size_t i_operations, size_t i_max_thread_count )
+	{
+		const size_t workload_count = sizeof( g_workloads ) / sizeof( g_workloads[ 0 ] );
+		for( size_t workload_index = 0; workload_index < workload_count; workload_index++ )
+		{
+			const Workload & workload = g_workloads[ workload_index ];
+			if( !i_subject.supports( workload ) )
+				continue;
+
+			const size_t max_thread_count = i_subject.is_thread_safe() ? i_max_thread_count : 1;
+			for( size_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2 )
+			{
+				std::vector<ThreadResult> results;
+
+				// throughput pass
+				const double seconds = run<false>( i_subject, workload, i_operations, thread_count, results );
+				size_t operations = 0;
+				bool failed = false;
+				for( size_t index = 0; index < results.size(); index++ )
+				{
+					operations += results[ index ].m_operations;
+					failed = failed || results[ index ].m_failed;
+				}
+
+				// latency pass
+				run<true>( i_subject, workload, i_operations, thread_count, results );
+				std::vector<uint32_t> alloc_latencies, free_latencies;
+				for( size_t index = 0; index < results.size(); index++ )
+				{
+					alloc_latencies.insert( alloc_latencies.end(), results[ index ].m_alloc_latencies.begin(), results[ index ].m_alloc_latencies.end() );
+					free_latencies.insert( free_latencies.end(), results[ index ].m_free_latencies.begin(), results[ index ].m_free_latencies.end() );
+					failed = failed || results[ index ].m_failed;
+				}
+
+				printf( "%-36s %-12s %3u %12.0f %7u %7u %7u %7u %7u %7u%s\n", i_subject.name(), workload.m_name,
+					static_cast<unsigned>( thread_count ), operations / seconds,
+					percentile( alloc_latencies, 500 ), percentile( alloc_latencies, 990 ), percentile( alloc_latencies, 999 ),
+					percentile( free_latencies, 500 ), percentile( free_latencies, 990 ), percentile( free_latencies, 999 ),
+					failed ? " (allocation failed)" : "" );
+				fflush( stdout );
+			}
+		}
+	}
+
+} // namespace memo_bench
+
+int main( int i_argc, char * i_argv[] )
+{
+	using namespace memo_bench;
+
+	memo::ThreadRoot root( "main" );
+
+	const size_t operations = i_argc > 1 ? static_cast<size_t>( atol( i_argv[ 1 ] ) ) : 200000;
+	const unsigned hardware_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	const size_t max_thread_count = i_argc > 2 ? static_cast<size_t>( atol( i_argv[ 2 ] ) ) : hardware_threads;
+
+	g_clock_overhead = measure_clock_overhead();
+	printf( "memo_bench: %u operations per thread, up to %u threads, clock overhead %u ns\n",
+		static_cast<unsigned>( operations ), static_cast<unsigned>( max_thread_count ), g_clock_overhead );
+	printf( "%-36s %-12s %3s %12s %7s %7s %7s %7s %7s %7s\n", "subject", "workload", "thr", "ops/sec",
+		"a.p50", "a.p99", "a.p999", "f.p50", "f.p99", "f.p999" );
+
+	std::vector<Subject*> subjects;
+
+	subjects.push_back( new AllocatorSubject( "DefaultAllocator", &memo::safe_get_default_allocator(), false, true ) );
+
+	{
+		memo::DebugAllocator::Config config;
+		config.m_target = MEMO_NEW( memo::DefaultAllocator::Config );
+		subjects.push_back( new AllocatorSubject( "DebugAllocator->DefaultAllocator", config.create_allocator(), true, false ) );
+	}
+
+	{
+		memo::StatAllocator::Config config;
+		config.m_target = MEMO_NEW( memo::DefaultAllocator::Config );
+		subjects.push_back( new AllocatorSubject( "StatAllocator->DefaultAllocator", config.create_allocator(), true, true ) );
+	}
+
+	{
+		memo::StatAllocator::Config config;
+		config.m_target = MEMO_NEW( memo::DefaultAllocator::Config );
+		config.m_peak_mode = memo::StatAllocator::eApproximatePeaks;
+		subjects.push_back( new AllocatorSubject( "StatAllocator(approx)->Default", config.create_allocator(), true, true ) );
+	}
+
+	#if MEMO_ENABLE_TLSF
+	{
+		const size_t tlsf_buffer_size = 1024 * 1024 * 128;
+
+		memo::TlsfAllocator::Config config;
+		config.m_buffer_size = tlsf_buffer_size;
+		subjects.push_back( new AllocatorSubject( "TlsfAllocator", config.create_allocator(), true, false ) );
+
+		memo::TlsfAllocator::Config * tlsf_config = MEMO_NEW( memo::TlsfAllocator::Config );
+		tlsf_config->m_buffer_size = tlsf_buffer_size;
+		memo::ThreadCacheAllocator::Config thread_cache_config;
+		thread_cache_config.m_target = tlsf_config;
+		subjects.push_back( new AllocatorSubject( "ThreadCacheAllocator->TlsfAllocator", thread_cache_config.create_allocator(), true, true ) );
+	}
+	#endif
+
+	subjects.push_back( new PoolSubject( g_max_living_blocks ) );
+	subjects.push_back( new ObjectStackSubject );
+	subjects.push_back( new QueueSubject );
+
+	for( size_t index = 0; index < subjects.size(); index++ )
+	{
+		benchmark( *subjects[ index ], operations, max_thread_count );
+		delete subjects[ index ];
+	}
+
+	return 0;
+}
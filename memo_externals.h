@@ -9,6 +9,10 @@
 	may be added to implement the required functions.
 */
 
+#ifdef _MSC_VER
+	#include <intrin.h> // needed by the atomic functions
+#endif
+
 /** \def MEMO_ENABLE_ASSERT
 	If this macro evaluates to non-zero, MEMO_ASSERT will check the parameter and break execution if it is false.
 	Otherwise MEMO_ASSERT will expand to a null statement. */
@@ -67,7 +71,7 @@
 	Currently only the macro MEMO_NEW_ARRAY_SRC exploits r-value references. */
 #define MEMO_ENABLE_RVALUE_REFERENCES	1
 
-#if defined( _MSC_VER ) && _MSC_VER >= 1800
+#if ( defined( _MSC_VER ) && _MSC_VER >= 1800 ) || __cplusplus >= 201103L
 	#define MEMO_ENABLE_TEMPLATE_USING	1
 #else
 	#define MEMO_ENABLE_TEMPLATE_USING	0
@@ -84,6 +88,57 @@
 	If this macro evaluates to non-zero, tlsf.c is included in the build, and TlsfAllocator is defined and implemented. */
 #define MEMO_ENABLE_TLSF			(1)
 
+/** \def MEMO_TLSF_FL_INDEX_MAX
+	log2 of the size limit of the blocks and of the regions of TlsfAllocator (the first level index of tlsf). Every unit
+	adds 32 free list heads to every tlsf pool, and the maximum on 64-bit platforms is 39. The default on 64-bit 
+	platforms allows regions up to 256 GB. */
+#if defined( _WIN64 ) || defined( __LP64__ )
+	#define MEMO_TLSF_FL_INDEX_MAX		(38)
+#else
+	#define MEMO_TLSF_FL_INDEX_MAX		(30)
+#endif
+
+/** \def MEMO_ENABLE_PAGE_MAP
+	If this macro evaluates to non-zero, the allocators that own their memory (like region allocators) used by the contexts
+	are registered in a global page map (see PageMap). memo::free and memo::realloc look up the owner of a block by its address,
+	and the blocks allocated by these allocators through memo::alloc have no allocation header. */
+#define MEMO_ENABLE_PAGE_MAP		(0)
+
+/** \def MEMO_ENABLE_VIRTUAL_MEMORY
+	If this macro evaluates to non-zero, region allocators can take their buffers directly from the virtual memory of the
+	system (see RegionAllocator::Config::m_virtual_memory), and the platform must implement memo_externals::virtual_alloc,
+	virtual_free, virtual_discard and virtual_page_size. */
+#define MEMO_ENABLE_VIRTUAL_MEMORY	(1)
+
+/** \def MEMO_ENABLE_NUMA
+	If this macro evaluates to non-zero, region allocators can bind their buffers to a NUMA node (see 
+	RegionAllocator::Config::m_numa_node), NodeArenaAllocator is available, and the platform must implement 
+	memo_externals::numa_node_count, numa_current_node and virtual_bind. The buffers bound to a node are reserved from 
+	the virtual memory, so this feature requires MEMO_ENABLE_VIRTUAL_MEMORY. */
+#define MEMO_ENABLE_NUMA			(MEMO_ENABLE_VIRTUAL_MEMORY)
+
+/** \def MEMO_ENABLE_SHARED_MEMORY
+	If this macro evaluates to non-zero, SharedRegionAllocator is available, and the platform must implement 
+	memo_externals::shared_memory_open, shared_memory_close, shared_memory_remove and SharedMutex. */
+#define MEMO_ENABLE_SHARED_MEMORY	(1)
+
+/** \def MEMO_ENABLE_MUTEX_STATS
+	If this macro evaluates to non-zero, memo_externals::Mutex counts its acquisitions, the contended ones, and the time
+	spent waiting for it (see memo_externals::Mutex::get_stats). */
+#define MEMO_ENABLE_MUTEX_STATS		(1)
+
+/** \def MEMO_ENABLE_INLINE_TLS
+	If this macro evaluates to non-zero, the current allocator and the ThreadRoot of the calling thread are thread-local
+	variables declared in this header, and their accessors are defined inline. Otherwise the accessors are implemented 
+	out of line by the platform. On Linux the variables use the initial-exec tls model, so that reading them does not 
+	require a call to __tls_get_addr. A shared library using initial-exec tls should not be loaded with dlopen after 
+	the startup, as the static tls space may be exhausted. */
+#if defined( __GNUC__ ) && defined( __linux__ )
+	#define MEMO_ENABLE_INLINE_TLS		(1)
+#else
+	#define MEMO_ENABLE_INLINE_TLS		(0)
+#endif
+
 namespace memo_externals
 {
 	/** Name of the memory configuration file. 
@@ -105,11 +160,24 @@ namespace memo_externals
 	/**  This function is called when a debug error occurs. */
 	void debug_break();
 
-	// Mutex - non re-entrant mutex
+	/* Mutex - non re-entrant mutex. lock and unlock are implemented by the platform: test/memo_externals.cpp
+		implements them for Windows, and test/memo_externals_linux.cpp for Linux, where a waiting thread spins 
+		for a bounded time and then sleeps on a futex. */
 	class Mutex
 	{
 	public:
 
+		/** Counters of a mutex. They are updated by the thread that has just acquired the mutex, so another 
+			thread reading them may get values slightly out of date. */
+		struct Stats
+		{
+			uint64_t m_acquisitions; /**< number of times the mutex has been locked */
+			uint64_t m_contended_acquisitions; /**< number of times lock has found the mutex already locked */
+			uint64_t m_wait_nanoseconds; /**< total time spent waiting by contended acquisitions */
+
+			Stats() : m_acquisitions( 0 ), m_contended_acquisitions( 0 ), m_wait_nanoseconds( 0 ) { }
+		};
+
 		Mutex() : m_lock(0) {}
 
 		~Mutex() { }
@@ -118,17 +186,261 @@ namespace memo_externals
 
 		void unlock();
 
+		/** Retrieves the counters of the mutex. If MEMO_ENABLE_MUTEX_STATS is zero, all the counters are zero. */
+		void get_stats( Stats & o_stats ) const
+		{
+			#if MEMO_ENABLE_MUTEX_STATS
+				o_stats = m_stats;
+			#else
+				o_stats = Stats();
+			#endif
+		}
+
 	private:
 		volatile uint32_t m_lock;
+		#if MEMO_ENABLE_MUTEX_STATS
+			Stats m_stats;
+		#endif
 	};
 
-	memo::IAllocator * get_current_thread_allocator();
+	/** Atomically compares *io_dest with i_expected_value, and if they are equal replaces it with i_new_value.
+		The operation is a full memory barrier.
+		@return the value of *io_dest before the operation */
+	inline void * atomic_compare_exchange_pointer( void * volatile * io_dest, void * i_new_value, void * i_expected_value )
+	{
+		#ifdef _MSC_VER
+			return _InterlockedCompareExchangePointer( io_dest, i_new_value, i_expected_value );
+		#else
+			__atomic_compare_exchange_n( io_dest, &i_expected_value, i_new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+			return i_expected_value;
+		#endif
+	}
+
+	/** Atomically replaces *io_dest with i_new_value. The operation is a full memory barrier.
+		@return the value of *io_dest before the operation */
+	inline void * atomic_exchange_pointer( void * volatile * io_dest, void * i_new_value )
+	{
+		#ifdef _MSC_VER
+			return _InterlockedExchangePointer( io_dest, i_new_value );
+		#else
+			return __atomic_exchange_n( io_dest, i_new_value, __ATOMIC_SEQ_CST );
+		#endif
+	}
+
+	/** Atomically compares *io_dest with i_expected_value, and if they are equal replaces it with i_new_value. The
+		operation is a full memory barrier, and it is available on 32 bit platforms too.
+		@return the value of *io_dest before the operation */
+	inline uint64_t atomic_compare_exchange_uint64( volatile uint64_t * io_dest, uint64_t i_new_value, uint64_t i_expected_value )
+	{
+		#ifdef _MSC_VER
+			return static_cast<uint64_t>( _InterlockedCompareExchange64( reinterpret_cast<volatile __int64 *>( io_dest ),
+				static_cast<__int64>( i_new_value ), static_cast<__int64>( i_expected_value ) ) );
+		#else
+			__atomic_compare_exchange_n( io_dest, &i_expected_value, i_new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+			return i_expected_value;
+		#endif
+	}
+
+	/** Atomically reads *i_source. The operation is an acquire barrier.
+		@return the value of *i_source */
+	inline uint64_t atomic_load_uint64( const volatile uint64_t * i_source )
+	{
+		#ifdef _MSC_VER
+			// on 32 bit platforms a plain read may be torn, so the value is read with a compare-exchange that never writes
+			return static_cast<uint64_t>( _InterlockedCompareExchange64( reinterpret_cast<volatile __int64 *>(
+				const_cast<volatile uint64_t *>( i_source ) ), 0, 0 ) );
+		#else
+			return __atomic_load_n( i_source, __ATOMIC_ACQUIRE );
+		#endif
+	}
+
+	/** Atomically reads *i_source. The operation is not a memory barrier: it only guarantees that the read is not torn.
+		@return the value of *i_source */
+	inline size_t atomic_load_size( const volatile size_t * i_source )
+	{
+		#ifdef _MSC_VER
+			return *i_source; // aligned reads of a machine word are atomic
+		#else
+			return __atomic_load_n( i_source, __ATOMIC_RELAXED );
+		#endif
+	}
+
+	/** Atomically writes i_value in *io_dest. The operation is not a memory barrier: it only guarantees that the write is not torn. */
+	inline void atomic_store_size( volatile size_t * io_dest, size_t i_value )
+	{
+		#ifdef _MSC_VER
+			*io_dest = i_value; // aligned writes of a machine word are atomic
+		#else
+			__atomic_store_n( io_dest, i_value, __ATOMIC_RELAXED );
+		#endif
+	}
+
+	/** Atomically reads *i_source. The operation is not a memory barrier: it only guarantees that the read is not torn.
+		@return the value of *i_source */
+	inline void * atomic_load_pointer( void * const volatile * i_source )
+	{
+		#ifdef _MSC_VER
+			return *i_source; // aligned reads of a machine word are atomic
+		#else
+			return __atomic_load_n( i_source, __ATOMIC_RELAXED );
+		#endif
+	}
+
+	/** Atomically writes i_value in *io_dest. The operation is not a memory barrier: it only guarantees that the write is not torn. */
+	inline void atomic_store_pointer( void * volatile * io_dest, void * i_value )
+	{
+		#ifdef _MSC_VER
+			*io_dest = i_value; // aligned writes of a machine word are atomic
+		#else
+			__atomic_store_n( io_dest, i_value, __ATOMIC_RELAXED );
+		#endif
+	}
+
+	/** Atomically reads *i_source. The operation is an acquire barrier: the writes performed by another thread before
+		storing the value with atomic_store_pointer_release are visible after the read.
+		@return the value of *i_source */
+	inline void * atomic_load_pointer_acquire( void * const volatile * i_source )
+	{
+		#ifdef _MSC_VER
+			return *i_source; // with /volatile:ms (the default on x86 and x64) volatile reads have acquire semantics
+		#else
+			return __atomic_load_n( i_source, __ATOMIC_ACQUIRE );
+		#endif
+	}
+
+	/** Atomically writes i_value in *io_dest. The operation is a release barrier: the writes performed before it are
+		visible to the threads that read the value with atomic_load_pointer_acquire. */
+	inline void atomic_store_pointer_release( void * volatile * io_dest, void * i_value )
+	{
+		#ifdef _MSC_VER
+			*io_dest = i_value; // with /volatile:ms (the default on x86 and x64) volatile writes have release semantics
+		#else
+			__atomic_store_n( io_dest, i_value, __ATOMIC_RELEASE );
+		#endif
+	}
+
+	#if MEMO_ENABLE_VIRTUAL_MEMORY
+
+		/** Reserves a range of the address space. The range is readable and writable, but the system assigns physical
+			memory to its pages only when they are touched for the first time.
+			@param i_size size of the range. It must be a multiple of virtual_page_size()
+			@param i_alignment alignment of the range. It must be an integer power of 2
+			@param i_huge_pages if true, the system is asked to back the range with huge pages. If they are not available,
+				normal pages are used.
+			@return the address of the range, or nullptr in case of failure */
+		void * virtual_alloc( size_t i_size, size_t i_alignment, bool i_huge_pages );
+
+		/** Releases a range reserved with virtual_alloc. i_size must be the size passed to virtual_alloc. */
+		void virtual_free( void * i_address, size_t i_size );
+
+		/** Tells the system that the content of a part of a range reserved with virtual_alloc is no longer needed, so
+			that its physical memory can be reclaimed. The pages remain usable, but their content is undefined.
+			@param i_address address of the first page. It must be aligned to virtual_page_size()
+			@param i_size size of the part. It must be a multiple of virtual_page_size() */
+		void virtual_discard( void * i_address, size_t i_size );
+
+		/** Returns the size of a page of the virtual memory */
+		size_t virtual_page_size();
+
+	#endif
+
+	#if MEMO_ENABLE_NUMA
+
+		/** Returns the number of NUMA nodes of the system. On a system without NUMA returns 1. */
+		size_t numa_node_count();
+
+		/** Returns the index of the NUMA node of the processor that is running the calling thread. The result is
+			less than numa_node_count(), but it may be out of date as soon as the function returns, if the system 
+			moves the thread to another processor. */
+		size_t numa_current_node();
+
+		/** Asks the system to assign to the pages of a range reserved with virtual_alloc physical memory of a NUMA node.
+			Pages already touched may not be moved, so this function should be called just after virtual_alloc. When 
+			the node has no free memory, the system may use the memory of other nodes.
+			@param i_address address of the first page. It must be aligned to virtual_page_size()
+			@param i_size size of the range. It must be a multiple of virtual_page_size()
+			@param i_node index of the node, less than numa_node_count() */
+		void virtual_bind( void * i_address, size_t i_size, size_t i_node );
+
+	#endif
+
+	#if MEMO_ENABLE_SHARED_MEMORY
+
+		/** Opens a named shared memory object, creating it if it does not exist, and maps it in the address space of
+			the calling process. Every process mapping the object may get a different address.
+			@param i_name name of the object. It should be a simple name, without slashes.
+			@param io_size on input, the size of the object to create. It should be a multiple of virtual_page_size().
+				On output, the size of the mapping: if the object already existed, this is its actual size, that may 
+				differ from the requested one.
+			@param o_created receives true if the object has been created by this call, in which case its content is 
+				zero, or false if the object already existed
+			@return the address of the mapping, or nullptr in case of failure */
+		void * shared_memory_open( const char * i_name, size_t * io_size, bool * o_created );
+
+		/** Unmaps a shared memory object mapped with shared_memory_open. i_size must be the size returned by shared_memory_open. */
+		void shared_memory_close( void * i_address, size_t i_size );
+
+		/** Removes the name of a shared memory object, so that it can't be opened anymore. The existing mappings remain
+			valid, and the memory is released when the last one is closed. */
+		void shared_memory_remove( const char * i_name );
+
+		/** Suspends the calling thread for about the given time. It is used to wait for another process without spinning. */
+		void sleep_milliseconds( unsigned i_milliseconds );
+
+		/* SharedMutex - non re-entrant mutex that can be placed in shared memory and locked by more processes. A zero 
+			filled SharedMutex is unlocked, so it does not need to be constructed. lock and unlock are implemented by 
+			the platform. If a process dies while it owns the mutex, the mutex remains locked. */
+		class SharedMutex
+		{
+		public:
+
+			void lock();
+
+			void unlock();
+
+		private:
+			volatile uint32_t m_lock;
+		};
+
+	#endif
+
+	#if MEMO_ENABLE_INLINE_TLS
+
+		/* thread-local variables, defined by the platform (test/memo_externals_linux.cpp) */
+		extern __thread memo::IAllocator * g_current_thread_allocator __attribute__(( tls_model( "initial-exec" ) ));
+		extern __thread memo::ThreadRoot * g_thread_root __attribute__(( tls_model( "initial-exec" ) ));
+
+		inline memo::IAllocator * get_current_thread_allocator()
+		{
+			return g_current_thread_allocator;
+		}
+
+		inline void set_current_thread_allocator( memo::IAllocator * i_allocator )
+		{
+			g_current_thread_allocator = i_allocator;
+		}
+
+		inline memo::ThreadRoot * get_thread_root()
+		{
+			return g_thread_root;
+		}
+
+		inline void set_thread_root( memo::ThreadRoot * i_thread_context )
+		{
+			g_thread_root = i_thread_context;
+		}
+
+	#else
+
+		memo::IAllocator * get_current_thread_allocator();
+
+		void set_current_thread_allocator( memo::IAllocator * i_allocator );
 
-	void set_current_thread_allocator( memo::IAllocator * i_allocator );
+		memo::ThreadRoot * get_thread_root();
 
-	memo::ThreadRoot * get_thread_root();
+		void set_thread_root( memo::ThreadRoot * i_thread_context );
 
-	void set_thread_root( memo::ThreadRoot * i_thread_context );
+	#endif
 
 	void register_custom_allocators( memo::AllocatorConfigFactory & i_factory );
 
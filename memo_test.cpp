@@ -1,5 +1,11 @@
 
 #include <map>
+#include <vector>
+#include <thread>
+#if MEMO_ENABLE_SHARED_MEMORY && !defined( _WIN32 )
+	#include <unistd.h>
+	#include <sys/wait.h>
+#endif
 
 namespace memo
 {
@@ -20,13 +26,202 @@ namespace memo
 		}
 	};
 
+	struct _TestConcurrentClass : public _TestClass
+	{
+	};
+
 }
 
 MEMO_ENABLE_POOL( memo::_TestClass, 10 );
+MEMO_ENABLE_CONCURRENT_POOL( memo::_TestConcurrentClass, 100 );
 
 namespace  memo
 {
-	
+	typedef void (*_TestThreadProcedure)( size_t i_thread_index, void * i_context );
+
+	/* runs i_procedure on i_thread_count new threads, each with its own ThreadRoot, and waits for them to exit */
+	void _run_test_threads( size_t i_thread_count, _TestThreadProcedure i_procedure, void * i_context )
+	{
+		struct ThreadEntry
+		{
+			static void run( _TestThreadProcedure i_procedure, size_t i_thread_index, void * i_context )
+			{
+				ThreadRoot thread_root( "test_thread" );
+				( *i_procedure )( i_thread_index, i_context );
+			}
+		};
+
+		std::vector< std::thread > threads;
+		for( size_t thread_index = 0; thread_index < i_thread_count; thread_index++ )
+			threads.push_back( std::thread( &ThreadEntry::run, i_procedure, thread_index, i_context ) );
+		for( size_t thread_index = 0; thread_index < threads.size(); thread_index++ )
+			threads[ thread_index ].join();
+	}
+
+	// discards the state written by IAllocator::dump_state
+	struct _NullStateWriter : public IAllocator::StateWriter
+	{
+		virtual void tab( const char * ) { }
+		virtual void untab() { }
+		virtual void write( const char *, const char * ) { }
+	};
+
+	/* Blocks allocated by a group of threads, that can be freed by another group of threads. Every thread owns a
+		row of s_block_count blocks. */
+	struct _CrossThreadBlocks
+	{
+		static const size_t s_thread_count = 4;
+		static const size_t s_block_count = 512;
+
+		IAllocator * m_allocator;
+		void * m_blocks[ s_thread_count ][ s_block_count ];
+
+		_CrossThreadBlocks( IAllocator & i_allocator )
+			: m_allocator( &i_allocator ) { }
+
+		// fills the row of the thread with blocks, freeing and reallocating some of them
+		static void alloc_row( size_t i_thread_index, void * i_context )
+		{
+			_CrossThreadBlocks & blocks = *static_cast<_CrossThreadBlocks*>( i_context );
+			void ** row = blocks.m_blocks[ i_thread_index ];
+			for( size_t index = 0; index < s_block_count; index++ )
+			{
+				const size_t size = 8 + ( index * 7 + i_thread_index * 13 ) % 200;
+				row[ index ] = blocks.m_allocator->alloc( size, MEMO_MIN_ALIGNMENT, 0 );
+				MEMO_ASSERT( row[ index ] != nullptr );
+				memset( row[ index ], static_cast<int>( i_thread_index ), size );
+				if( index % 3 == 2 )
+				{
+					blocks.m_allocator->free( row[ index - 1 ] );
+					row[ index - 1 ] = blocks.m_allocator->alloc( 16, MEMO_MIN_ALIGNMENT, 0 );
+					MEMO_ASSERT( row[ index - 1 ] != nullptr );
+					memset( row[ index - 1 ], static_cast<int>( i_thread_index ), 16 );
+				}
+			}
+		}
+
+		// frees the row of the next thread, reallocating some blocks and allocating and freeing others in the meanwhile
+		static void free_next_row( size_t i_thread_index, void * i_context )
+		{
+			_CrossThreadBlocks & blocks = *static_cast<_CrossThreadBlocks*>( i_context );
+			const size_t owner_index = ( i_thread_index + 1 ) % s_thread_count;
+			void ** row = blocks.m_blocks[ owner_index ];
+			for( size_t index = 0; index < s_block_count; index++ )
+			{
+				if( index % 4 == 1 )
+				{
+					row[ index ] = blocks.m_allocator->realloc( row[ index ], 300, MEMO_MIN_ALIGNMENT, 0 );
+					MEMO_ASSERT( row[ index ] != nullptr );
+				}
+				MEMO_ASSERT( *static_cast<unsigned char*>( row[ index ] ) == static_cast<unsigned char>( owner_index ) );
+				blocks.m_allocator->free( row[ index ] );
+				row[ index ] = nullptr;
+
+				// the state of the allocator is dumped while the other threads are using it
+				if( i_thread_index == 0 && index % 64 == 0 )
+				{
+					_NullStateWriter state_writer;
+					blocks.m_allocator->dump_state( state_writer );
+				}
+				if( index % 5 == 0 )
+					blocks.m_allocator->free( blocks.m_allocator->alloc( 24, MEMO_MIN_ALIGNMENT, 0 ) );
+			}
+		}
+
+		/* allocates the blocks on s_thread_count threads, and frees them on other s_thread_count threads, so that
+			every block is freed by a thread other than the one that allocated it */
+		void run()
+		{
+			_run_test_threads( s_thread_count, &alloc_row, this );
+			_run_test_threads( s_thread_count, &free_next_row, this );
+		}
+	};
+
+	/* Slots of a ConcurrentPool allocated and freed concurrently by many threads. The capacity of the pool is less than
+		the slots used, so that some allocations overflow to the current allocator. */
+	struct _ConcurrentPoolThreads
+	{
+		static const size_t s_thread_count = 4;
+		static const size_t s_slot_count = 256;
+		static const size_t s_slot_size = 32;
+
+		ConcurrentPool m_pool;
+		void * m_slots[ 2 * s_thread_count ][ s_slot_count ]; /**< the rows of the first group of threads, then the ones of the second group */
+
+		_ConcurrentPoolThreads()
+		{
+			const bool initialized = m_pool.init( UntypedPool::Config( s_slot_size, MEMO_MIN_ALIGNMENT, s_thread_count * s_slot_count / 2 ) );
+			MEMO_ASSERT( initialized );
+			MEMO_UNUSED( initialized );
+		}
+
+		// fills the slots with the index of the thread, and checks that no other thread is using them
+		static void fill_and_check( void * const * i_slots, size_t i_thread_index )
+		{
+			for( size_t index = 0; index < s_slot_count; index++ )
+				memset( i_slots[ index ], static_cast<int>( i_thread_index ), s_slot_size );
+			for( size_t index = 0; index < s_slot_count; index++ )
+			{
+				const unsigned char * bytes = static_cast<const unsigned char *>( i_slots[ index ] );
+				for( size_t byte_index = 0; byte_index < s_slot_size; byte_index++ )
+					MEMO_ASSERT( bytes[ byte_index ] == static_cast<unsigned char>( i_thread_index ) );
+			}
+		}
+
+		// allocates and frees slots, with single and batch operations, and leaves a row of slots allocated
+		void alloc_and_free( void * * o_slots, size_t i_thread_index )
+		{
+			for( size_t iteration = 0; iteration < 64; iteration++ )
+			{
+				const size_t batch_count = m_pool.alloc_batch( s_slot_count / 2, o_slots );
+				MEMO_ASSERT( batch_count == s_slot_count / 2 );
+				MEMO_UNUSED( batch_count );
+				for( size_t index = s_slot_count / 2; index < s_slot_count; index++ )
+				{
+					o_slots[ index ] = m_pool.alloc();
+					MEMO_ASSERT( o_slots[ index ] != nullptr );
+				}
+				fill_and_check( o_slots, i_thread_index );
+				for( size_t index = 0; index < s_slot_count / 2; index++ )
+					m_pool.free( o_slots[ index ] );
+				m_pool.free_batch( o_slots + s_slot_count / 2, s_slot_count / 2 );
+			}
+
+			for( size_t index = 0; index < s_slot_count; index++ )
+				o_slots[ index ] = m_pool.alloc();
+			fill_and_check( o_slots, i_thread_index );
+		}
+
+		void free_row( void * const * i_slots )
+		{
+			for( size_t index = 0; index < s_slot_count; index++ )
+				m_pool.free( i_slots[ index ] );
+		}
+
+		static void run_first_group( size_t i_thread_index, void * i_context )
+		{
+			_ConcurrentPoolThreads & threads = *static_cast<_ConcurrentPoolThreads*>( i_context );
+			threads.alloc_and_free( threads.m_slots[ i_thread_index ], i_thread_index );
+		}
+
+		// frees the row left by a thread of the first group, while the other threads allocate and free
+		static void run_second_group( size_t i_thread_index, void * i_context )
+		{
+			_ConcurrentPoolThreads & threads = *static_cast<_ConcurrentPoolThreads*>( i_context );
+			threads.free_row( threads.m_slots[ ( i_thread_index + 1 ) % s_thread_count ] );
+			void * * slots = threads.m_slots[ s_thread_count + i_thread_index ];
+			threads.alloc_and_free( slots, i_thread_index );
+			threads.free_row( slots );
+		}
+
+		/* the slots left by the first group of threads are freed by the second group, so every slot is freed by a
+			thread other than the one that allocated it */
+		void run()
+		{
+			_run_test_threads( s_thread_count, &run_first_group, this );
+			_run_test_threads( s_thread_count, &run_second_group, this );
+		}
+	};
 
 	void test_allocators()
 	{
@@ -70,8 +265,202 @@ namespace  memo
 				}
 			}
 			memo_externals::output_message( "done\n" );
-		}	
-		
+		}
+
+		// concurrent pool
+		{
+			memo_externals::output_message( "testing concurrent pool..." );
+			_TestConcurrentClass * objects[ 300 ];
+			for( size_t i = 0; i < iterations / 8; i++ )
+			{
+				// more objects than the capacity, so that the pool overflows to the current allocator
+				const size_t count = generate_rand_32() % 300;
+				for( size_t j = 0; j < count; j++ )
+					objects[ j ] = MEMO_NEW( _TestConcurrentClass );
+				for( size_t j = 0; j < count; j++ )
+				{
+					const size_t index = generate_rand_32() % ( count - j );
+					MEMO_DELETE( objects[ index ] );
+					objects[ index ] = objects[ count - j - 1 ];
+				}
+
+				const size_t batch_count = MEMO_NEW_BATCH( _TestConcurrentClass, count, objects );
+				MEMO_ASSERT( batch_count == count );
+				MEMO_DELETE_BATCH( objects, batch_count );
+			}
+
+			// a thread without a ThreadRoot exchanges single slots with the stack
+			ThreadRoot * thread_root = memo_externals::get_thread_root();
+			_TestConcurrentClass * object = MEMO_NEW( _TestConcurrentClass );
+			memo_externals::set_thread_root( nullptr );
+			for( size_t j = 0; j < 150; j++ )
+				objects[ j ] = MEMO_NEW( _TestConcurrentClass );
+			MEMO_DELETE( object );
+			for( size_t j = 0; j < 150; j++ )
+				MEMO_DELETE( objects[ j ] );
+			memo_externals::set_thread_root( thread_root );
+
+			// many threads allocating and freeing concurrently
+			_ConcurrentPoolThreads * pool_threads = MEMO_NEW( _ConcurrentPoolThreads );
+			pool_threads->run();
+			MEMO_DELETE( pool_threads );
+			memo_externals::output_message( "done\n" );
+		}
+
+		// growable pool
+		{
+			memo_externals::output_message( "testing growable pool..." );
+			UntypedPool pool;
+			pool.init( UntypedPool::Config( 48, 16, 8, 2.f ) );
+			void * blocks[ 100 ];
+			for( size_t i = 0; i < iterations / 64; i++ )
+			{
+				const size_t count = 1 + generate_rand_32() % 100;
+				for( size_t j = 0; j < count; j++ )
+				{
+					blocks[ j ] = pool.alloc_slot(); // the pool grows, so alloc_slot never fails
+					MEMO_ASSERT( blocks[ j ] != nullptr && is_aligned( blocks[ j ], 16 ) );
+					memset( blocks[ j ], static_cast<int>( j ), 48 );
+				}
+
+				// a chunk with a living block is not trimmed
+				const size_t living_index = generate_rand_32() % count;
+				for( size_t j = 0; j < count; j++ )
+				{
+					if( j != living_index )
+						pool.free( blocks[ j ] );
+				}
+				const size_t chunk_count = pool.chunk_count();
+				const size_t trimmed_count = pool.trim();
+				MEMO_ASSERT( pool.chunk_count() == chunk_count - trimmed_count );
+				MEMO_ASSERT( chunk_count == 0 || pool.chunk_count() <= 1 );
+
+				pool.free( blocks[ living_index ] );
+				pool.trim();
+				MEMO_ASSERT( pool.chunk_count() == 0 );
+				MEMO_ASSERT( pool.statistics().m_live_slots == 0 && pool.statistics().m_peak_slots >= count );
+			}
+			MEMO_ASSERT( pool.statistics().m_overflow_allocs == 0 && pool.statistics().m_overflow_frees == 0 );
+			memo_externals::output_message( "done\n" );
+		}
+
+		// pool statistics
+		{
+			memo_externals::output_message( "testing pool statistics..." );
+			UntypedPool pool;
+			pool.init( UntypedPool::Config( 16, 8, 8 ) );
+			void * blocks[ 12 ];
+			for( size_t j = 0; j < 12; j++ )
+				blocks[ j ] = pool.alloc();
+			MEMO_ASSERT( pool.statistics().m_live_slots == 8 && pool.statistics().m_overflow_allocs == 4 );
+			pool.free_batch( blocks + 6, 6 );
+			MEMO_ASSERT( pool.statistics().m_live_slots == 6 && pool.statistics().m_overflow_frees == 4 );
+			for( size_t j = 0; j < 6; j++ )
+				pool.free( blocks[ j ] );
+			MEMO_ASSERT( pool.statistics().m_live_slots == 0 && pool.statistics().m_peak_slots == 8 );
+			memo_externals::output_message( "done\n" );
+		}
+
+		// batches
+		{
+			memo_externals::output_message( "testing batches..." );
+			_TestClass * objects[ 32 ];
+			void * blocks[ 32 ];
+			StatAllocator::Config stat_allocator_config;
+			#if MEMO_ENABLE_TLSF
+				TlsfAllocator::Config * tls_config = MEMO_NEW( TlsfAllocator::Config );
+				tls_config->m_buffer_size = 1024 * 256;
+				stat_allocator_config.m_target = tls_config;
+			#else
+				stat_allocator_config.m_target = MEMO_NEW( DefaultAllocator::Config );
+			#endif
+			StatAllocator * stat_allocator = static_cast<StatAllocator*>( stat_allocator_config.create_allocator() );
+			for( size_t i = 0; i < iterations; i++ )
+			{
+				const size_t count = generate_rand_32() % 32;
+				const size_t object_count = MEMO_NEW_BATCH( _TestClass, count, objects );
+				MEMO_ASSERT( object_count == count );
+				if( object_count > 0 )
+					MEMO_DELETE( objects[ object_count - 1 ] );
+				MEMO_DELETE_BATCH( objects, object_count > 0 ? object_count - 1 : 0 );
+
+				const size_t block_size = generate_rand_32() % 100;
+				const size_t block_count = memo::alloc_batch( *stat_allocator, count, block_size, MEMO_MIN_ALIGNMENT, 0, blocks );
+				MEMO_ASSERT( block_count == count );
+				for( size_t j = 0; j < block_count; j++ )
+					memset( blocks[ j ], 0xAB, block_size );
+				memo::free_batch( blocks, block_count );
+			}
+			StatAllocator::Statistics stats;
+			stat_allocator->get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 );
+			MEMO_DELETE( stat_allocator );
+			memo_externals::output_message( "done\n" );
+		}
+
+		// in-place expansion
+		{
+			memo_externals::output_message( "testing in-place expansion..." );
+			StatAllocator::Config stat_allocator_config;
+			#if MEMO_ENABLE_TLSF
+				TlsfAllocator::Config * tls_config = MEMO_NEW( TlsfAllocator::Config );
+				tls_config->m_buffer_size = 1024 * 256;
+				stat_allocator_config.m_target = tls_config;
+			#else
+				stat_allocator_config.m_target = MEMO_NEW( DefaultAllocator::Config );
+			#endif
+			StatAllocator * stat_allocator = static_cast<StatAllocator*>( stat_allocator_config.create_allocator() );
+			for( size_t i = 0; i < iterations; i++ )
+			{
+				const size_t size = generate_rand_32() % 200;
+				void * block = memo::alloc( *stat_allocator, size, MEMO_MIN_ALIGNMENT, 0 );
+				void * unaligned_block = memo::unaligned_alloc( *stat_allocator, size );
+				
+				const size_t usable_size = memo::usable_size( block );
+				const size_t unaligned_usable_size = memo::unaligned_usable_size( unaligned_block );
+				MEMO_ASSERT( usable_size == 0 || usable_size >= size );
+				MEMO_ASSERT( unaligned_usable_size == 0 || unaligned_usable_size >= size );
+				if( usable_size != 0 )
+				{
+					const bool expanded = memo::try_expand( block, usable_size );
+					MEMO_ASSERT( expanded );
+					MEMO_UNUSED( expanded );
+					memset( block, 0xAB, usable_size );
+				}
+				if( unaligned_usable_size != 0 )
+				{
+					const bool expanded = memo::unaligned_try_expand( unaligned_block, unaligned_usable_size );
+					MEMO_ASSERT( expanded );
+					MEMO_UNUSED( expanded );
+					memset( unaligned_block, 0xAB, unaligned_usable_size );
+				}
+
+				memo::free( block );
+				memo::unaligned_free( unaligned_block );
+			}
+
+			#if MEMO_ENABLE_TLSF
+				// a block followed by a free block can grow, a block followed by a used block can't
+				void * first = stat_allocator->unaligned_alloc( 64 );
+				void * second = stat_allocator->unaligned_alloc( 64 );
+				stat_allocator->unaligned_free( second );
+				bool expanded = stat_allocator->unaligned_try_expand( first, 1024 );
+				MEMO_ASSERT( expanded && stat_allocator->get_size( first ) == 1024 );
+				second = stat_allocator->unaligned_alloc( 64 );
+				expanded = stat_allocator->unaligned_try_expand( first, stat_allocator->unaligned_usable_size( first ) + 1 );
+				MEMO_ASSERT( !expanded );
+				MEMO_UNUSED( expanded );
+				stat_allocator->unaligned_free( second );
+				stat_allocator->unaligned_free( first );
+			#endif
+
+			StatAllocator::Statistics stats;
+			stat_allocator->get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 );
+			MEMO_DELETE( stat_allocator );
+			memo_externals::output_message( "done\n" );
+		}
+
 
 		// queue
 		{
@@ -100,7 +489,65 @@ namespace  memo
 				fifo_tester.fill_and_empty_test( iterations );
 			}
 			memo_externals::output_message( "done\n" );
-		}	
+		}
+
+		// handle allocator
+		{
+			memo_externals::output_message( "testing HandleAllocator..." );
+			memo::HandleAllocator handle_allocator( 1024 * 64, 256 );
+			const size_t handle_count = 128;
+			memo::Handle handles[ handle_count ];
+			for( size_t index = 0; index < handle_count; index++ )
+			{
+				handles[ index ] = handle_allocator.alloc( 100 + index * 3 );
+				MEMO_ASSERT( handle_allocator.is_valid( handles[ index ] ) );
+				memo::HandleAllocator::PinScope pin_scope( handle_allocator, handles[ index ] );
+				memset( pin_scope.address(), static_cast<int>( index ), handle_allocator.block_size( handles[ index ] ) );
+			}
+
+			// free the even blocks, and keep the second block pinned while compacting
+			for( size_t index = 0; index < handle_count; index += 2 )
+			{
+				handle_allocator.free( handles[ index ] );
+				MEMO_ASSERT( !handle_allocator.is_valid( handles[ index ] ) );
+			}
+			MEMO_ASSERT( handle_allocator.fragmented_size() > 0 );
+			void * pinned_address = handle_allocator.pin( handles[ 1 ] );
+			while( !handle_allocator.compact( 1024 ) )
+				{ }
+			MEMO_ASSERT( handle_allocator.pin( handles[ 1 ] ) == pinned_address );
+			handle_allocator.unpin( handles[ 1 ] );
+			handle_allocator.unpin( handles[ 1 ] );
+			MEMO_ASSERT( handle_allocator.fragmented_size() < 256 ); // only the hole before the pinned block remains
+			handle_allocator.compact( ~static_cast<size_t>( 0 ) );
+			MEMO_ASSERT( handle_allocator.fragmented_size() == 0 );
+
+			for( size_t index = 1; index < handle_count; index += 2 )
+			{
+				memo::HandleAllocator::PinScope pin_scope( handle_allocator, handles[ index ] );
+				const unsigned char * bytes = static_cast<const unsigned char *>( pin_scope.address() );
+				for( size_t byte_index = 0; byte_index < handle_allocator.block_size( handles[ index ] ); byte_index++ )
+					MEMO_ASSERT( bytes[ byte_index ] == static_cast<unsigned char>( index ) );
+			}
+
+			// fragment the buffer, then allocate a block that fits only after a compaction
+			for( size_t index = 1; index < handle_count; index += 4 )
+				handle_allocator.free( handles[ index ] );
+			const size_t big_size = handle_allocator.free_size_at_end() + handle_allocator.fragmented_size() / 2;
+			const memo::Handle big_handle = handle_allocator.alloc( big_size );
+			MEMO_ASSERT( !big_handle.is_null() && handle_allocator.fragmented_size() == 0 );
+			for( size_t index = 3; index < handle_count; index += 4 )
+			{
+				{
+					memo::HandleAllocator::PinScope pin_scope( handle_allocator, handles[ index ] );
+					MEMO_ASSERT( *static_cast<const unsigned char *>( pin_scope.address() ) == static_cast<unsigned char>( index ) );
+				}
+				handle_allocator.free( handles[ index ] );
+			}
+			handle_allocator.free( big_handle );
+			MEMO_ASSERT( handle_allocator.block_count() == 0 && handle_allocator.used_size() == 0 );
+			memo_externals::output_message( "done\n" );
+		}
 
 		// corruption detector allocator
 		{
@@ -147,6 +594,78 @@ namespace  memo
 			MEMO_DELETE( stat_allocator );
 		}
 
+		// statistics allocator with approximate peaks
+		{
+			memo_externals::output_message( "testing StatAllocator(approximate peaks)->DefaultAllocator...\n\t" );
+			StatAllocator::Config stat_allocator_config;
+			stat_allocator_config.m_target = MEMO_NEW( DefaultAllocator::Config );
+			stat_allocator_config.m_peak_mode = StatAllocator::eApproximatePeaks;
+			StatAllocator * stat_allocator = static_cast<StatAllocator*>( stat_allocator_config.create_allocator() );
+			memo::AllocatorTester stat_allocator_tester( *stat_allocator );
+			stat_allocator_tester.do_test_session( iterations );
+			StatAllocator::Statistics stats;
+			stat_allocator->get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 && stats.m_total_allocated_peak > 0 );
+
+			// the shards are updated without locks, and the threads free blocks allocated by other threads
+			_CrossThreadBlocks cross_thread_blocks( *stat_allocator );
+			cross_thread_blocks.run();
+			stat_allocator->get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 );
+			MEMO_DELETE( stat_allocator );
+		}
+
+		// thread cache allocator
+		{
+			memo_externals::output_message( "testing ThreadCacheAllocator->DefaultAllocator...\n\t" );
+			ThreadCacheAllocator::Config thread_cache_allocator_config;
+			thread_cache_allocator_config.m_target = MEMO_NEW( DefaultAllocator::Config );
+			IAllocator * thread_cache_allocator = thread_cache_allocator_config.create_allocator();
+			memo::AllocatorTester thread_cache_allocator_tester( *thread_cache_allocator );
+			thread_cache_allocator_tester.do_test_session( iterations );
+
+			// a cached block is moved by realloc if it does not respect the requested alignment
+			void * block = thread_cache_allocator->alloc( 40, MEMO_MIN_ALIGNMENT, 0 );
+			for( size_t alignment = MEMO_MIN_ALIGNMENT; alignment <= 256; alignment *= 2 )
+			{
+				block = thread_cache_allocator->realloc( block, 24, alignment, 8 );
+				MEMO_ASSERT( block != nullptr && is_aligned( address_add( block, 8 ), alignment ) );
+			}
+			thread_cache_allocator->free( block );
+			MEMO_DELETE( thread_cache_allocator );
+
+			// blocks freed by threads other than the ones that allocated them fill the magazines, that are drained
+			thread_cache_allocator_config.m_magazine_size = 16;
+			thread_cache_allocator = thread_cache_allocator_config.create_allocator();
+			_CrossThreadBlocks cross_thread_blocks( *thread_cache_allocator );
+			cross_thread_blocks.run();
+			MEMO_DELETE( thread_cache_allocator );
+		}
+
+		// pool allocator
+		{
+			memo_externals::output_message( "testing PoolAllocator->DefaultAllocator...\n\t" );
+			PoolAllocator::Config pool_allocator_config;
+			pool_allocator_config.m_target = MEMO_NEW( DefaultAllocator::Config );
+			pool_allocator_config.m_max_size = 200;
+			pool_allocator_config.m_capacity = 16;
+			PoolAllocator * pool_allocator = static_cast<PoolAllocator*>( pool_allocator_config.create_allocator() );
+			memo::AllocatorTester pool_allocator_tester( *pool_allocator );
+			pool_allocator_tester.do_test_session( iterations );
+
+			// a pooled block is moved by realloc if it does not respect the requested alignment
+			void * block = pool_allocator->alloc( 40, MEMO_MIN_ALIGNMENT, 0 );
+			for( size_t alignment = MEMO_MIN_ALIGNMENT; alignment <= 256; alignment *= 2 )
+			{
+				block = pool_allocator->realloc( block, 24, alignment, 8 );
+				MEMO_ASSERT( block != nullptr && is_aligned( address_add( block, 8 ), alignment ) );
+			}
+			pool_allocator->free( block );
+
+			pool_allocator->trim();
+			MEMO_DELETE( pool_allocator );
+		}
+
 		// debug + statistics allocator
 		{
 			memo_externals::output_message( "testing DebugAllocator->StatAllocator->DefaultAllocator...\n\t" );			
@@ -160,6 +679,21 @@ namespace  memo
 			MEMO_DELETE( stat_allocator );
 		}
 
+		// static stack
+		{
+			memo_externals::output_message( "testing Static<StatPolicy, DebugPolicy, DefaultBackend>...\n\t" );
+			typedef Static<StatPolicy, DebugPolicy, DefaultBackend> StaticAllocator;
+			MEMO_ASSERT( strcmp( StaticAllocator::type_name(), "static_stat_debug_default" ) == 0 );
+			StaticAllocator::Config static_allocator_config;
+			StaticAllocator * static_allocator = static_cast<StaticAllocator*>( static_allocator_config.create_allocator() );
+			memo::AllocatorTester static_allocator_tester( *static_allocator );
+			static_allocator_tester.do_test_session( iterations );
+			StatAllocator::Statistics stats;
+			static_allocator->stack().get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 );
+			MEMO_DELETE( static_allocator );
+		}
+
 		// tlsf
 		#if MEMO_ENABLE_TLSF
 		{
@@ -171,6 +705,382 @@ namespace  memo
 			tls_tester.do_test_session( 15000 );
 		}
 
+		// growable tlsf
+		{
+			memo_externals::output_message( "testing growable TlsfAllocator...\n\t" );
+			TlsfAllocator::Config tls_config;
+			tls_config.m_buffer_size = 1024 * 64;
+			tls_config.m_growth_size = 1024 * 64;
+			tls_config.m_max_size = 1024 * 1024 * 16;
+			tls_config.m_release_free_regions = true;
+			TlsfAllocator tls_allocator( tls_config );
+			memo::AllocatorTester tls_tester( tls_allocator );
+			tls_tester.do_test_session( iterations );
+			MEMO_ASSERT( tls_allocator.region_count() <= 2 ); // only one free extra region is kept
+
+			// a block bigger than the growth size gets its own region, and the maximum size is respected
+			void * big_block = tls_allocator.alloc( 1024 * 1024, 64, 0 );
+			MEMO_ASSERT( big_block != nullptr && tls_allocator.usable_size( big_block ) >= 1024 * 1024 );
+			MEMO_ASSERT( tls_allocator.alloc( 1024 * 1024 * 16, MEMO_MIN_ALIGNMENT, 0 ) == nullptr );
+			tls_allocator.free( big_block );
+		}
+
+		// tlsf in the virtual memory
+		#if MEMO_ENABLE_VIRTUAL_MEMORY
+		{
+			memo_externals::output_message( "testing TlsfAllocator in the virtual memory...\n\t" );
+			TlsfAllocator::Config tls_config;
+			tls_config.m_buffer_size = 1024 * 1024 * 2;
+			tls_config.m_growth_size = 1024 * 1024 * 2;
+			tls_config.m_huge_pages = true;
+			tls_config.m_discard_threshold = 1024 * 64;
+			TlsfAllocator tls_allocator( tls_config );
+			memo::AllocatorTester tls_tester( tls_allocator );
+			tls_tester.do_test_session( iterations );
+
+			// the pages inside the freed blocks are discarded, but the blocks around them must be preserved
+			void * blocks[ 16 ];
+			for( size_t index = 0; index < 16; index++ )
+			{
+				blocks[ index ] = ( index & 1 ) ? tls_allocator.alloc( 1024 * 200, 4096, 0 ) : tls_allocator.unaligned_alloc( 1024 * 150 );
+				MEMO_ASSERT( blocks[ index ] != nullptr );
+				memset( blocks[ index ], static_cast<int>( index ), 1024 * 150 );
+			}
+			for( size_t index = 1; index < 16; index += 3 )
+			{
+				if( index & 1 )
+					tls_allocator.free( blocks[ index ] );
+				else
+					tls_allocator.unaligned_free( blocks[ index ] );
+				blocks[ index ] = nullptr;
+			}
+			for( size_t index = 0; index < 16; index++ )
+			{
+				if( blocks[ index ] == nullptr )
+					continue;
+				const unsigned char * bytes = static_cast<unsigned char *>( blocks[ index ] );
+				MEMO_ASSERT( bytes[ 0 ] == index && bytes[ 1024 * 150 - 1 ] == index );
+				MEMO_UNUSED( bytes );
+				if( index & 1 )
+					tls_allocator.free( blocks[ index ] );
+				else
+					tls_allocator.unaligned_free( blocks[ index ] );
+			}
+		}
+		#endif
+
+		// tlsf with a region bigger than 4 GB, reserved from the virtual memory so that only the touched pages take memory
+		#if MEMO_ENABLE_VIRTUAL_MEMORY && defined( __LP64__ ) && MEMO_TLSF_FL_INDEX_MAX > 33
+		{
+			memo_externals::output_message( "testing TlsfAllocator with a 6 GB region..." );
+			TlsfAllocator::Config tls_config;
+			tls_config.m_buffer_size = static_cast<size_t>( 6 ) << 30;
+			tls_config.m_virtual_memory = true;
+			TlsfAllocator tls_allocator( tls_config );
+			void * big_block = tls_allocator.alloc( static_cast<size_t>( 5 ) << 30, 4096, 0 );
+			MEMO_ASSERT( big_block != nullptr && tls_allocator.usable_size( big_block ) >= ( static_cast<size_t>( 5 ) << 30 ) );
+			void * small_block = tls_allocator.unaligned_alloc( 64 );
+			MEMO_ASSERT( small_block != nullptr );
+			static_cast<char *>( big_block )[ ( static_cast<size_t>( 5 ) << 30 ) - 1 ] = 1;
+			tls_allocator.free( big_block );
+			tls_allocator.unaligned_free( small_block );
+			memo_externals::output_message( "done\n" );
+		}
+		#endif
+
+		// linear allocator
+		{
+			memo_externals::output_message( "testing LinearAllocator...\n\t" );
+			LinearAllocator::Config linear_config;
+			linear_config.m_buffer_size = 1024 * 1024 * 64;
+			LinearAllocator linear_allocator( linear_config );
+			memo::AllocatorTester linear_tester( linear_allocator );
+			linear_tester.do_test_session( iterations );
+			linear_allocator.reset();
+
+			// rewinding to a mark frees the blocks allocated after it
+			void * first_block = linear_allocator.unaligned_alloc( 100 );
+			const LinearAllocator::Mark mark = linear_allocator.mark();
+			void * block = linear_allocator.alloc( 200, 64, 8 );
+			MEMO_ASSERT( block != nullptr && is_aligned( address_add( block, 8 ), 64 ) );
+			MEMO_ASSERT( linear_allocator.try_expand( block, 1000 ) && linear_allocator.usable_size( block ) == 1000 );
+			MEMO_ASSERT( !linear_allocator.try_expand( first_block, 1000 ) );
+			linear_allocator.rewind_to( mark );
+			MEMO_ASSERT( linear_allocator.used_size() == mark );
+			MEMO_ASSERT( linear_allocator.alloc( 200, 64, 8 ) == block );
+
+			// the headers stay aligned with any alignment offset, even after a block with an odd size
+			linear_allocator.reset();
+			linear_allocator.unaligned_alloc( 5 );
+			for( size_t offset = 1; offset < 32; offset += 3 )
+			{
+				void * offset_block = linear_allocator.alloc( 24, 16, offset );
+				MEMO_ASSERT( offset_block != nullptr && is_aligned( address_add( offset_block, offset ), 16 ) );
+				MEMO_ASSERT( linear_allocator.usable_size( offset_block ) == 24 );
+				MEMO_ASSERT( linear_allocator.try_expand( offset_block, 27 ) && linear_allocator.usable_size( offset_block ) == 27 );
+				memset( offset_block, 0xAB, 27 );
+				MEMO_UNUSED( offset_block );
+			}
+
+			// when the buffer is exhausted allocations fail
+			linear_allocator.reset();
+			MEMO_ASSERT( linear_allocator.unaligned_alloc( linear_config.m_buffer_size ) == nullptr );
+			MEMO_ASSERT( linear_allocator.unaligned_alloc( linear_config.m_buffer_size / 2 ) != nullptr );
+			MEMO_ASSERT( linear_allocator.unaligned_alloc( linear_config.m_buffer_size / 2 ) == nullptr );
+			MEMO_UNUSED( first_block );
+			MEMO_UNUSED( block );
+		}
+
+		// slab allocator
+		{
+			memo_externals::output_message( "testing SlabAllocator...\n\t" );
+			SlabAllocator::Config slab_config;
+			slab_config.m_buffer_size = 1024 * 1024;
+			SlabAllocator slab_allocator( slab_config );
+			memo::AllocatorTester slab_tester( slab_allocator );
+			slab_tester.do_test_session( iterations );
+
+			// a freed block is reused by the next allocation of the same size class
+			void * block = slab_allocator.unaligned_alloc( 40 );
+			MEMO_ASSERT( block != nullptr && slab_allocator.unaligned_usable_size( block ) == 48 );
+			MEMO_ASSERT( slab_allocator.unaligned_try_expand( block, 48 ) && !slab_allocator.unaligned_try_expand( block, 49 ) );
+			MEMO_ASSERT( slab_allocator.unaligned_realloc( block, 33 ) == block );
+			slab_allocator.unaligned_free( block );
+			MEMO_ASSERT( slab_allocator.alloc( 48, 8, 0 ) == block );
+			slab_allocator.free( block );
+
+			// when the slabs are over, small blocks are allocated by the target
+			void * blocks[ 1024 ];
+			for( size_t index = 0; index < 1024; index++ )
+			{
+				blocks[ index ] = slab_allocator.unaligned_alloc( 1000 + index % 24 );
+				MEMO_ASSERT( blocks[ index ] != nullptr );
+				memset( blocks[ index ], static_cast<int>( index ), 1000 );
+			}
+			for( size_t index = 0; index < 1024; index++ )
+			{
+				MEMO_ASSERT( static_cast<unsigned char *>( blocks[ index ] )[ 999 ] == static_cast<unsigned char>( index ) );
+				slab_allocator.unaligned_dbg_check( blocks[ index ] );
+				slab_allocator.unaligned_free( blocks[ index ] );
+			}
+			MEMO_UNUSED( block );
+		}
+
+		// buddy allocator
+		{
+			memo_externals::output_message( "testing BuddyAllocator...\n\t" );
+			BuddyAllocator::Config buddy_config;
+			buddy_config.m_buffer_size = 1024 * 1024 * 8;
+			buddy_config.m_min_block_size = 64;
+			BuddyAllocator buddy_allocator( buddy_config );
+			memo::AllocatorTester buddy_tester( buddy_allocator );
+			buddy_tester.do_test_session( iterations );
+		}
+		{
+			BuddyAllocator::Config buddy_config;
+			buddy_config.m_buffer_size = 1024 * 1024 * 4;
+			BuddyAllocator buddy_allocator( buddy_config );
+			MEMO_ASSERT( buddy_allocator.min_block_size() == 1024 * 4 && buddy_allocator.max_block_size() == 1024 * 1024 * 4 );
+
+			// blocks are aligned to their size
+			void * first_block = buddy_allocator.alloc( 1024 * 4, 1024 * 4, 0 );
+			void * second_block = buddy_allocator.alloc( 1024 * 64, 1024 * 64, 0 );
+			MEMO_ASSERT( first_block != nullptr && is_aligned( first_block, 1024 * 4 ) && buddy_allocator.usable_size( first_block ) == 1024 * 4 );
+			MEMO_ASSERT( second_block != nullptr && is_aligned( second_block, 1024 * 64 ) && buddy_allocator.usable_size( second_block ) == 1024 * 64 );
+			MEMO_ASSERT( buddy_allocator.unaligned_alloc( 1024 * 1024 * 4 ) == nullptr );
+
+			// a block grows in-place if the buddies that follow it are free
+			MEMO_ASSERT( buddy_allocator.try_expand( first_block, 1024 * 16 ) && buddy_allocator.usable_size( first_block ) == 1024 * 16 );
+			void * third_block = buddy_allocator.unaligned_alloc( 1024 * 4 );
+			MEMO_ASSERT( third_block == address_add( first_block, 1024 * 16 ) );
+			MEMO_ASSERT( !buddy_allocator.try_expand( first_block, 1024 * 32 ) );
+
+			// freed blocks are merged with their buddies
+			buddy_allocator.free( first_block );
+			buddy_allocator.free( second_block );
+			buddy_allocator.unaligned_free( third_block );
+			void * whole_block = buddy_allocator.unaligned_alloc( 1024 * 1024 * 4 );
+			MEMO_ASSERT( whole_block == first_block );
+			buddy_allocator.unaligned_free( whole_block );
+			memo_externals::output_message( "\tdone\n" );
+		}
+
+		// shared region allocator
+		#if MEMO_ENABLE_SHARED_MEMORY
+		{
+			memo_externals::output_message( "testing SharedRegionAllocator...\n\t" );
+			SharedRegionAllocator::Config shared_config;
+			strcpy( shared_config.m_name, "memo_test_shared_region" );
+			shared_config.m_size = 1024 * 1024 * 4;
+			memo_externals::shared_memory_remove( shared_config.m_name ); // in case a previous run has crashed
+			SharedRegionAllocator creator( shared_config );
+			MEMO_ASSERT( creator.is_open() && creator.is_creator() );
+			memo::AllocatorTester shared_tester( creator );
+			shared_tester.do_test_session( iterations );
+
+			// a second mapping of the same object, at another address, shares the heap
+			SharedRegionAllocator attached( shared_config );
+			MEMO_ASSERT( attached.is_open() && !attached.is_creator() );
+			void * blocks[ 64 ];
+			for( size_t index = 0; index < 64; index++ )
+			{
+				blocks[ index ] = creator.alloc( 1000 + index * 7, 64, 0 );
+				MEMO_ASSERT( blocks[ index ] != nullptr && is_aligned( blocks[ index ], 64 ) );
+				memset( blocks[ index ], static_cast<int>( index ), 1000 );
+			}
+			for( size_t index = 0; index < 64; index++ )
+			{
+				void * block = attached.address_of( creator.offset_of( blocks[ index ] ) );
+				MEMO_ASSERT( block != blocks[ index ] );
+				MEMO_ASSERT( static_cast<unsigned char *>( block )[ 999 ] == static_cast<unsigned char>( index ) );
+				attached.dbg_check( block );
+				attached.free( block );
+			}
+
+			#if !defined( _WIN32 )
+				// a child process allocates blocks and sends their offsets through a pipe, the parent frees them
+				int offset_pipe[ 2 ];
+				const int pipe_result = pipe( offset_pipe );
+				MEMO_ASSERT( pipe_result == 0 );
+				MEMO_UNUSED( pipe_result );
+				const pid_t child = fork();
+				if( child == 0 )
+				{
+					close( offset_pipe[ 0 ] );
+					SharedRegionAllocator child_allocator( shared_config );
+					bool succeeded = child_allocator.is_open() && !child_allocator.is_creator();
+					for( size_t index = 0; succeeded && index < 64; index++ )
+					{
+						void * block = child_allocator.alloc( 500 + index * 13, 32, 0 );
+						succeeded = block != nullptr;
+						if( succeeded )
+						{
+							memset( block, static_cast<int>( index ), 500 );
+							const size_t offset = child_allocator.offset_of( block );
+							succeeded = write( offset_pipe[ 1 ], &offset, sizeof( offset ) ) == sizeof( offset );
+						}
+					}
+					close( offset_pipe[ 1 ] );
+					_exit( succeeded ? 0 : 1 ); // the destructors of the parent must not run in the child
+				}
+				MEMO_ASSERT( child > 0 );
+				close( offset_pipe[ 1 ] );
+				size_t child_offsets[ 64 ], child_block_count = 0;
+				while( child_block_count < 64 && read( offset_pipe[ 0 ], &child_offsets[ child_block_count ], sizeof( size_t ) ) == sizeof( size_t ) )
+					child_block_count++;
+				close( offset_pipe[ 0 ] );
+				int child_status = 0;
+				waitpid( child, &child_status, 0 );
+				MEMO_ASSERT( WIFEXITED( child_status ) && WEXITSTATUS( child_status ) == 0 && child_block_count == 64 );
+				for( size_t index = 0; index < child_block_count; index++ )
+				{
+					void * block = creator.address_of( child_offsets[ index ] );
+					MEMO_ASSERT( is_aligned( block, 32 ) && static_cast<unsigned char *>( block )[ 499 ] == static_cast<unsigned char>( index ) );
+					creator.dbg_check( block );
+					creator.free( block );
+				}
+			#endif
+
+			// after all the frees the heap is a single free block again
+			void * whole_block = attached.unaligned_alloc( attached.size() / 2 );
+			MEMO_ASSERT( whole_block != nullptr );
+			MEMO_ASSERT( attached.unaligned_try_expand( whole_block, attached.size() - 1024 * 16 ) );
+			creator.unaligned_free( creator.address_of( attached.offset_of( whole_block ) ) );
+			memo_externals::output_message( "\tdone\n" );
+		}
+		#endif
+
+		// tlsf arenas
+		{
+			memo_externals::output_message( "testing TlsfArenaAllocator...\n\t" );
+			TlsfArenaAllocator::Config arena_config;
+			TlsfArenaAllocator arena_allocator( arena_config );
+			memo::AllocatorTester arena_tester( arena_allocator );
+			arena_tester.do_test_session( iterations );
+
+			/* the arenas abandoned by the first group of threads are adopted by the second one, so blocks are pushed 
+				in the remote-free lists while the owners are draining them */
+			_CrossThreadBlocks cross_thread_blocks( arena_allocator );
+			cross_thread_blocks.run();
+		}
+		{
+			/* a block freed by a thread without a ThreadRoot goes in the remote-free list of the arena, and it must be
+				given back to tlsf by the next allocation of the owner, otherwise the arena (that can't grow) is full */
+			TlsfArenaAllocator::Config arena_config;
+			arena_config.m_arena_size = 1024 * 64;
+			arena_config.m_growth_size = 0;
+			TlsfArenaAllocator arena_allocator( arena_config );
+			ThreadRoot * thread_root = memo_externals::get_thread_root();
+			void * block = arena_allocator.unaligned_alloc( 1024 * 48 );
+			MEMO_ASSERT( block != nullptr );
+			memo_externals::set_thread_root( nullptr );
+			arena_allocator.unaligned_free( block );
+			memo_externals::set_thread_root( thread_root );
+			block = arena_allocator.alloc( 1024 * 48, 64, 0 );
+			MEMO_ASSERT( block != nullptr );
+			arena_allocator.free( block );
+		}
+
+		// node arenas
+		#if MEMO_ENABLE_NUMA
+		{
+			memo_externals::output_message( "testing NodeArenaAllocator...\n\t" );
+			NodeArenaAllocator::Config node_config;
+			node_config.m_arena_size = 1024 * 1024 * 4;
+			node_config.m_growth_size = 1024 * 1024;
+			NodeArenaAllocator node_allocator( node_config );
+			MEMO_ASSERT( node_allocator.arena_count() == memo_externals::numa_node_count() );
+			memo::AllocatorTester node_tester( node_allocator );
+			node_tester.do_test_session( iterations );
+		}
+		{
+			// a region bound to a node
+			TlsfAllocator::Config tls_config;
+			tls_config.m_buffer_size = 1024 * 1024;
+			tls_config.m_numa_node = memo_externals::numa_current_node();
+			TlsfAllocator tls_allocator( tls_config );
+			MEMO_ASSERT( tls_allocator.numa_node() == tls_config.m_numa_node );
+			void * block = tls_allocator.alloc( 1024 * 512, 64, 0 );
+			MEMO_ASSERT( block != nullptr );
+			memset( block, 0xCD, 1024 * 512 );
+			tls_allocator.free( block );
+		}
+		#endif
+
+		// tlsf dispatched through the page map
+		#if MEMO_ENABLE_PAGE_MAP
+		{
+			memo_externals::output_message( "testing TlsfAllocator in the page map...\n" );
+			TlsfAllocator::Config tls_config;
+			tls_config.m_buffer_size = 1024 * 1024;
+			TlsfAllocator tls_allocator( tls_config );
+			tls_allocator.register_in_page_map();
+			MEMO_ASSERT( tls_allocator.is_page_mapped() );
+			void * blocks[ 64 ];
+			for( size_t index = 0; index < 64; index++ )
+			{
+				blocks[ index ] = memo::alloc( tls_allocator, index * 7, MEMO_MIN_ALIGNMENT << ( index % 4 ), 0 );
+				MEMO_ASSERT( PageMap::find_allocator( blocks[ index ] ) == &tls_allocator );
+				memset( blocks[ index ], static_cast<int>( index ), index * 7 );
+			}
+			for( size_t index = 0; index < 64; index += 2 )
+			{
+				blocks[ index ] = memo::realloc( blocks[ index ], index * 11, MEMO_MIN_ALIGNMENT << ( index % 4 ), 0 );
+				MEMO_ASSERT( index * 7 == 0 || static_cast<unsigned char*>( blocks[ index ] )[ index * 7 - 1 ] == index );
+			}
+			for( size_t index = 0; index < 64; index++ )
+				memo::free( blocks[ index ] );
+
+			void * unaligned_block = memo::unaligned_alloc( tls_allocator, 40 );
+			unaligned_block = memo::unaligned_realloc( unaligned_block, 4000 );
+			memo::unaligned_free( unaligned_block );
+
+			void * default_block = memo::alloc( get_default_allocator(), 40, MEMO_MIN_ALIGNMENT, 0 );
+			MEMO_ASSERT( PageMap::find_allocator( default_block ) == nullptr );
+			memo::free( default_block );
+		}
+		#endif
+
 		// debug + statistics allocator
 		{
 			memo_externals::output_message( "testing DebugAllocator->StatAllocator->TlsfAllocator...\n\t" );
@@ -185,6 +1095,35 @@ namespace  memo
 			stat_allocator_tester.do_test_session( iterations );
 			MEMO_DELETE( stat_allocator );
 		}
+
+		// static stack on tlsf
+		{
+			memo_externals::output_message( "testing Static<StatPolicy, DebugPolicy, TlsfBackend>...\n\t" );
+			typedef Static<StatPolicy, DebugPolicy, TlsfBackend> StaticAllocator;
+			StaticAllocator::Config static_allocator_config;
+			static_allocator_config.m_stack.m_buffer_size = 1024 * 1024 * 4;
+			StaticAllocator * static_allocator = static_cast<StaticAllocator*>( static_allocator_config.create_allocator() );
+			memo::AllocatorTester static_allocator_tester( *static_allocator );
+			static_allocator_tester.do_test_session( iterations );
+			StatAllocator::Statistics stats;
+			static_allocator->stack().get_stats( stats );
+			MEMO_ASSERT( stats.m_allocation_count == 0 && stats.m_total_allocated == 0 );
+			MEMO_DELETE( static_allocator );
+		}
+
+		// thread cache + tlsf
+		{
+			memo_externals::output_message( "testing ThreadCacheAllocator->TlsfAllocator...\n\t" );
+			TlsfAllocator::Config * tls_config = MEMO_NEW( TlsfAllocator::Config );
+			tls_config->m_buffer_size = 1024 * 1024 * 4;
+			ThreadCacheAllocator::Config thread_cache_allocator_config;
+			thread_cache_allocator_config.m_target = tls_config;
+			thread_cache_allocator_config.m_magazine_size = 16;
+			IAllocator * thread_cache_allocator = thread_cache_allocator_config.create_allocator();
+			memo::AllocatorTester thread_cache_allocator_tester( *thread_cache_allocator );
+			thread_cache_allocator_tester.do_test_session( iterations );
+			MEMO_DELETE( thread_cache_allocator );
+		}
 		#endif
 
 		// data stack
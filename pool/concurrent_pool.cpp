@@ -0,0 +1,330 @@
+
+namespace memo
+{
+	/* Free slots of the global stack are linked by index, so that the top of the stack fits in 64 bits together with
+		its tag. Index zero means no slot. */
+	struct ConcurrentPool::Link
+	{
+		uint32_t m_next_in_batch; /**< index of the next slot of the same batch */
+		uint32_t m_next_batch; /**< index of the first slot of the next batch in the stack. Meaningful only in the first slot of a batch */
+	};
+
+	// Free slots of a thread, allocated with the default allocator
+	struct ConcurrentPool::ThreadCache : public ThreadRoot::LocalObject
+	{
+		ConcurrentPool * m_pool;
+		ThreadRoot * m_thread_root;
+		ThreadCache * m_prev_cache; /**< previous cache of the same pool, protected by the mutex of the pool */
+		ThreadCache * m_next_cache; /**< next cache of the same pool, protected by the mutex of the pool */
+		size_t m_count;
+		void * m_slots[ 2 * s_batch_size ];
+
+		ThreadCache( ConcurrentPool & i_pool, ThreadRoot & i_thread_root )
+			: m_pool( &i_pool ), m_thread_root( &i_thread_root ), m_prev_cache( nullptr ), m_next_cache( nullptr ), m_count( 0 ) { }
+
+		virtual void on_thread_exit()
+			{ m_pool->destroy_thread_cache( this ); }
+	};
+
+	// ConcurrentPool::constructor
+	ConcurrentPool::ConcurrentPool()
+		: m_buffer_start( nullptr ), m_buffer_end( nullptr ), m_top( 0 ), m_high_water( 0 ), m_first_thread_cache( nullptr )
+	{
+
+	}
+
+	// ConcurrentPool::init
+	bool ConcurrentPool::init( const UntypedPool::Config & i_config )
+	{
+		MEMO_ASSERT( i_config.m_element_size > 0 && i_config.m_element_alignment > 0 && i_config.m_element_count > 0 );
+		MEMO_ASSERT( i_config.m_element_count < 0xFFFFFFFF ); // the slots are indexed with 32 bits, and zero is reserved
+
+		uninit();
+
+		m_config = i_config;
+		m_config.m_element_size = std::max( m_config.m_element_size, sizeof(Link) );
+		m_config.m_element_alignment = std::max( m_config.m_element_alignment, MEMO_ALIGNMENT_OF(Link) );
+
+		const size_t buffer_size = m_config.m_element_size * m_config.m_element_count;
+		m_buffer_start = get_default_allocator().alloc( buffer_size, m_config.m_element_alignment, 0 );
+		if( m_buffer_start == nullptr )
+		{
+			m_buffer_end = nullptr;
+			return false;
+		}
+		m_buffer_end = address_add( m_buffer_start, buffer_size );
+
+		// the stack is empty, and all the slots are above the high-water mark
+		m_top = 0;
+		m_high_water = 1;
+		return true;
+	}
+
+	// ConcurrentPool::uninit
+	void ConcurrentPool::uninit()
+	{
+		while( m_first_thread_cache != nullptr )
+		{
+			ThreadCache * thread_cache = m_first_thread_cache;
+			thread_cache->m_thread_root->remove_local_object( thread_cache );
+			destroy_thread_cache( thread_cache );
+		}
+
+		if( m_buffer_start != nullptr )
+		{
+			get_default_allocator().free( m_buffer_start );
+			m_buffer_start = nullptr;
+			m_buffer_end = nullptr;
+			m_top = 0;
+			m_high_water = 0;
+		}
+	}
+
+	// ConcurrentPool::alloc
+	void * ConcurrentPool::alloc()
+	{
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+
+		ThreadCache * thread_cache = get_thread_cache();
+		if( thread_cache != nullptr )
+		{
+			if( thread_cache->m_count == 0 )
+			{
+				// the cache is refilled with a batch from the stack, or with slots never allocated
+				uint32_t index = pop_batch();
+				if( index == 0 )
+					index = take_unused_batch();
+				while( index != 0 )
+				{
+					Link * slot = slot_at( index );
+					thread_cache->m_slots[ thread_cache->m_count++ ] = slot;
+					index = slot->m_next_in_batch;
+				}
+			}
+			if( thread_cache->m_count > 0 )
+				return thread_cache->m_slots[ --thread_cache->m_count ];
+		}
+		else
+		{
+			// without a cache the first slot of the batch is taken, and the rest goes back to the stack
+			uint32_t index = pop_batch();
+			if( index == 0 )
+				index = take_unused_batch();
+			if( index != 0 )
+			{
+				Link * slot = slot_at( index );
+				if( slot->m_next_in_batch != 0 )
+					push_batch( slot->m_next_in_batch );
+				return slot;
+			}
+		}
+
+		return memo::alloc( m_config.m_element_size, m_config.m_element_alignment, 0 );
+	}
+
+	// ConcurrentPool::free
+	void ConcurrentPool::free( void * i_element )
+	{
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+		MEMO_ASSERT( i_element != nullptr );
+		MEMO_ASSERT( is_aligned( i_element, m_config.m_element_alignment ) );
+
+		if( !is_in_buffer( i_element ) )
+		{
+			memo::free( i_element );
+			return;
+		}
+
+		ThreadCache * thread_cache = get_thread_cache();
+		if( thread_cache != nullptr )
+		{
+			if( thread_cache->m_count == 2 * s_batch_size )
+				drain( *thread_cache, s_batch_size );
+			thread_cache->m_slots[ thread_cache->m_count++ ] = i_element;
+		}
+		else
+		{
+			// without a cache the slot is pushed as a batch of one
+			Link * slot = static_cast<Link *>( i_element );
+			slot->m_next_in_batch = 0;
+			push_batch( index_of( slot ) );
+		}
+	}
+
+	// ConcurrentPool::alloc_batch
+	size_t ConcurrentPool::alloc_batch( size_t i_count, void * * o_elements )
+	{
+		size_t index = 0;
+		for( ; index < i_count; index++ )
+		{
+			o_elements[ index ] = alloc();
+			if( o_elements[ index ] == nullptr )
+				break;
+		}
+		return index;
+	}
+
+	// ConcurrentPool::free_batch
+	void ConcurrentPool::free_batch( void * const * i_elements, size_t i_count )
+	{
+		for( size_t index = 0; index < i_count; index++ )
+			free( i_elements[ index ] );
+	}
+
+	// ConcurrentPool::flush_thread_cache
+	void ConcurrentPool::flush_thread_cache()
+	{
+		ThreadRoot * thread_root = memo_externals::get_thread_root();
+		if( thread_root != nullptr )
+		{
+			ThreadCache * thread_cache = static_cast<ThreadCache *>( thread_root->find_local_object( this ) );
+			while( thread_cache != nullptr && thread_cache->m_count > 0 )
+				drain( *thread_cache, thread_cache->m_count < s_batch_size ? thread_cache->m_count : s_batch_size );
+		}
+	}
+
+	// ConcurrentPool::slot_at
+	ConcurrentPool::Link * ConcurrentPool::slot_at( uint32_t i_index ) const
+	{
+		MEMO_ASSERT( i_index > 0 && i_index <= m_config.m_element_count );
+		return static_cast<Link *>( address_add( m_buffer_start, ( i_index - 1 ) * m_config.m_element_size ) );
+	}
+
+	// ConcurrentPool::index_of
+	uint32_t ConcurrentPool::index_of( const void * i_slot ) const
+	{
+		MEMO_ASSERT( is_in_buffer( i_slot ) );
+		return static_cast<uint32_t>( address_diff( i_slot, m_buffer_start ) / m_config.m_element_size + 1 );
+	}
+
+	// ConcurrentPool::push_batch - pushes on the stack the batch starting with the given slot
+	void ConcurrentPool::push_batch( uint32_t i_first_index )
+	{
+		Link * first_slot = slot_at( i_first_index );
+		uint64_t top = memo_externals::atomic_load_uint64( &m_top );
+		for( ;; )
+		{
+			first_slot->m_next_batch = static_cast<uint32_t>( top );
+			const uint64_t new_top = ( ( top >> 32 ) + 1 ) << 32 | i_first_index;
+			const uint64_t prev_top = memo_externals::atomic_compare_exchange_uint64( &m_top, new_top, top );
+			if( prev_top == top )
+				return;
+			top = prev_top;
+		}
+	}
+
+	// ConcurrentPool::pop_batch - pops a batch from the stack, returning the index of its first slot, or zero if the stack is empty
+	uint32_t ConcurrentPool::pop_batch()
+	{
+		uint64_t top = memo_externals::atomic_load_uint64( &m_top );
+		for( ;; )
+		{
+			const uint32_t first_index = static_cast<uint32_t>( top );
+			if( first_index == 0 )
+				return 0;
+
+			/* another thread may pop the batch and use its first slot while the link is read. In this case the value
+				is garbage, but the tag of the top has changed, so the compare-exchange fails. The buffer is never
+				deallocated while the pool is in use, so the read is always legal. */
+			const uint32_t next_batch = static_cast<volatile Link *>( slot_at( first_index ) )->m_next_batch;
+			const uint64_t new_top = ( ( top >> 32 ) + 1 ) << 32 | next_batch;
+			const uint64_t prev_top = memo_externals::atomic_compare_exchange_uint64( &m_top, new_top, top );
+			if( prev_top == top )
+				return first_index;
+			top = prev_top;
+		}
+	}
+
+	/* ConcurrentPool::take_unused_batch - moves the high-water mark forward by a batch, and links the slots of the batch.
+		Returns the index of the first slot, or zero if all the slots have already been allocated. */
+	uint32_t ConcurrentPool::take_unused_batch()
+	{
+		const uint64_t slot_count = m_config.m_element_count;
+		uint64_t first_index = memo_externals::atomic_load_uint64( &m_high_water ), end_index;
+		for( ;; )
+		{
+			if( first_index > slot_count )
+				return 0;
+
+			end_index = first_index + s_batch_size <= slot_count + 1 ? first_index + s_batch_size : slot_count + 1;
+			const uint64_t prev_first_index = memo_externals::atomic_compare_exchange_uint64( &m_high_water, end_index, first_index );
+			if( prev_first_index == first_index )
+				break;
+			first_index = prev_first_index;
+		}
+
+		// no other thread can see the slots of the batch yet
+		for( uint64_t index = first_index; index < end_index; index++ )
+			slot_at( static_cast<uint32_t>( index ) )->m_next_in_batch = index + 1 < end_index ? static_cast<uint32_t>( index + 1 ) : 0;
+		return static_cast<uint32_t>( first_index );
+	}
+
+	// ConcurrentPool::get_thread_cache
+	ConcurrentPool::ThreadCache * ConcurrentPool::get_thread_cache()
+	{
+		ThreadRoot * thread_root = memo_externals::get_thread_root();
+		if( thread_root == nullptr )
+			return nullptr;
+
+		ThreadRoot::LocalObject * local_object = thread_root->find_local_object( this );
+		if( local_object != nullptr )
+			return static_cast<ThreadCache *>( local_object );
+
+		return create_thread_cache( *thread_root );
+	}
+
+	// ConcurrentPool::create_thread_cache
+	ConcurrentPool::ThreadCache * ConcurrentPool::create_thread_cache( ThreadRoot & i_thread_root )
+	{
+		ThreadCache * thread_cache = MEMO_NEW_ALLOC( safe_get_default_allocator(), ThreadCache, *this, i_thread_root );
+		if( thread_cache == nullptr )
+			return nullptr;
+
+		{
+			MutexLock lock( m_mutex );
+			thread_cache->m_next_cache = m_first_thread_cache;
+			if( m_first_thread_cache != nullptr )
+				m_first_thread_cache->m_prev_cache = thread_cache;
+			m_first_thread_cache = thread_cache;
+		}
+
+		i_thread_root.add_local_object( this, thread_cache );
+
+		return thread_cache;
+	}
+
+	// ConcurrentPool::destroy_thread_cache
+	void ConcurrentPool::destroy_thread_cache( ThreadCache * i_thread_cache )
+	{
+		while( i_thread_cache->m_count > 0 )
+			drain( *i_thread_cache, i_thread_cache->m_count < s_batch_size ? i_thread_cache->m_count : s_batch_size );
+
+		{
+			MutexLock lock( m_mutex );
+			if( i_thread_cache->m_prev_cache != nullptr )
+				i_thread_cache->m_prev_cache->m_next_cache = i_thread_cache->m_next_cache;
+			else
+				m_first_thread_cache = i_thread_cache->m_next_cache;
+			if( i_thread_cache->m_next_cache != nullptr )
+				i_thread_cache->m_next_cache->m_prev_cache = i_thread_cache->m_prev_cache;
+		}
+
+		MEMO_DELETE_ALLOC( safe_get_default_allocator(), i_thread_cache );
+	}
+
+	// ConcurrentPool::drain - pushes on the stack the last i_count slots of the cache as a batch
+	void ConcurrentPool::drain( ThreadCache & i_thread_cache, size_t i_count )
+	{
+		MEMO_ASSERT( i_count > 0 && i_count <= i_thread_cache.m_count && i_count <= s_batch_size );
+
+		const size_t first = i_thread_cache.m_count - i_count;
+		for( size_t index = first; index < i_thread_cache.m_count; index++ )
+		{
+			Link * slot = static_cast<Link *>( i_thread_cache.m_slots[ index ] );
+			slot->m_next_in_batch = index + 1 < i_thread_cache.m_count ? index_of( i_thread_cache.m_slots[ index + 1 ] ) : 0;
+		}
+		push_batch( index_of( i_thread_cache.m_slots[ first ] ) );
+		i_thread_cache.m_count = first;
+	}
+
+} // namespace memo
@@ -0,0 +1,97 @@
+
+namespace memo
+{
+	/**	\class ConcurrentPool
+		Thread-safe version of memo::UntypedPool. When initialized, the pool allocates a buffer with the default allocator,
+		large enough to contain the number of elements specified in the configuration.
+		Every thread keeps a cache of free slots, so that most allocations and deallocations do not need any lock or
+		atomic operation. The caches exchange batches of slots with a global lock-free stack: when a cache is empty a
+		batch is popped from the stack, and when it is full a batch is pushed to it. The top of the stack is a slot index
+		paired with a tag incremented by every operation, so that a slot popped and pushed again by another thread is
+		detected (ABA problem). The slots never allocated are not in the stack: when it is empty, a batch is taken above a
+		high-water mark, so init is constant time and the pages of the buffer are touched only when they are used.
+		The caches are linked to the ThreadRoot of every thread, and are given back to the stack when the thread exits.
+		Threads without a ThreadRoot exchange single slots with the stack.
+		When the stack is empty the pool allocates using the current allocator, like an UntypedPool that can't grow. A slot can be freed by
+		any thread: in this case it goes in the cache of the thread that frees it.
+		The slots have at least the size and the alignment of two uint32_t, and the pool can't have more than 2^32 - 1
+		slots. This class is thread safe, but init and uninit must not be called while other threads are using the pool.
+	*/
+	class ConcurrentPool
+	{
+	public:
+
+		/** Number of slots exchanged at once by the thread caches with the global stack. Every cache holds up to two batches. */
+		static const size_t s_batch_size = 32;
+
+		/** Constructs an unitialized pool. Call ConcurrentPool::init before using any other method. */
+		ConcurrentPool();
+
+		/** Destroys the pool, uninitializing it if necessary. The pool can be destroyed only when there are no living blocks
+			allocated by the it. */
+		~ConcurrentPool()			{ uninit(); }
+
+		/** Allocates a buffer with the default allocator, and formats it to be used for fixed size allocations.
+			@params i_config configuration of the pool
+			@return true if the buffer was successfully allocated and formatted, false otherwise */
+		bool init( const UntypedPool::Config & i_config );
+
+		/** Destroys all the thread caches and deallocates the buffer used by the pool. This method should be called only
+			when there are no living blocks allocated by the pool, and no other thread is using it. It's legal to call this
+			method before init or twice. */
+		void uninit();
+
+		/** Allocates a block of memory. The size and the alignment of the block are those specified in the configuration of the pool.
+			If there is not a free slot in the pool, this method allocates using the current allocator.
+			@return address of the newly allocated block, or nullptr if both the pool and the current allocator could not allocate the block. */
+		void * alloc();
+
+		/** Frees a block of memory allocated with alloc. If the block is outside the pool, this method uses memo::free.
+			@param i_element address of the block to free. Can't be nullptr. */
+		void free( void * i_element );
+
+		/** Allocates many blocks of memory. The size and the alignment of the blocks are those specified in the configuration of the pool.
+			@param i_count number of blocks to allocate
+			@param o_elements array that receives the addresses of the blocks
+			@return number of blocks allocated. It is less than i_count only if the current allocator has failed. */
+		size_t alloc_batch( size_t i_count, void * * o_elements );
+
+		/** Frees many blocks of memory, allocated with alloc or alloc_batch.
+			@param i_elements array of the addresses of the blocks to free. None of them can be nullptr.
+			@param i_count number of blocks to free */
+		void free_batch( void * const * i_elements, size_t i_count );
+
+		/** Gives back to the global stack all the slots cached by the calling thread */
+		void flush_thread_cache();
+
+	private:
+		ConcurrentPool( const ConcurrentPool & ); // not implemented
+		ConcurrentPool & operator = ( const ConcurrentPool & ); // not implemented
+
+		struct Link;
+		struct ThreadCache;
+
+		Link * slot_at( uint32_t i_index ) const;
+		uint32_t index_of( const void * i_slot ) const;
+		bool is_in_buffer( const void * i_element ) const
+			{ return i_element >= m_buffer_start && i_element < m_buffer_end; }
+
+		void push_batch( uint32_t i_first_index );
+		uint32_t pop_batch();
+		uint32_t take_unused_batch();
+
+		ThreadCache * get_thread_cache();
+		ThreadCache * create_thread_cache( ThreadRoot & i_thread_root );
+		void destroy_thread_cache( ThreadCache * i_thread_cache );
+		void drain( ThreadCache & i_thread_cache, size_t i_count );
+
+	private: // data members
+		UntypedPool::Config m_config;
+		void * m_buffer_start, * m_buffer_end;
+		volatile uint64_t m_top; /**< the high 32 bits are the tag, the low 32 bits the index of the first slot of the top batch */
+		volatile uint64_t m_high_water; /**< index of the first slot never allocated */
+		memo_externals::Mutex m_mutex; /**< protects the list of the thread caches */
+		ThreadCache * m_first_thread_cache;
+	};
+
+} // namespace memo
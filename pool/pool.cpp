@@ -1,2 +1,4 @@
 
 #include "untyped_pool.cpp"
+#include "concurrent_pool.cpp"
+#include "pool_allocator.cpp"
@@ -4,6 +4,8 @@
 
 #include "untyped_pool.h"
 #include "typed_pool.h"
+#include "concurrent_pool.h"
+#include "pool_allocator.h"
 
 /** \def MEMO_ENABLE_POOL( TYPE, DEFAULT_CAPACITY )
 	 Enables a memory pool for the type TYPE, with capacity DEFAULT_CAPACITY, or with the capacity specified in the memory configuration file.
@@ -11,7 +13,8 @@
 	 the pool: array allocations are performed with the default dispatcher (that is, the thread current allocator is used).
 	 TypedPool is not thread safe, but the AllocationDispatcher defined by this macro protects the pool with a mutex.
 	 The pool allocates a memory buffer the first time it is created, and places in it objects up to the capacity. When the capacity is over,
-	 TypedPool uses the default allocator.
+	 the pool grows by chunks, each with twice the capacity of the previous one (see UntypedPool::Config::m_growth_factor).
+	 The usage counters of the pool (see UntypedPool::Statistics) are written by MemoryManager::dump_contexts, keyed by TYPE.
 	This macro must be used in the global namespace, only once, and after TYPE has been defined. */
 #define MEMO_ENABLE_POOL( TYPE, DEFAULT_CAPACITY ) namespace memo {																		\
 	template <>	class AllocationDispatcher<TYPE> : public memo::PoolDispatcher< TYPE, AllocationDispatcher<TYPE > >	\
@@ -26,21 +29,73 @@
 		}																																\
 	}; }
 
+/** \def MEMO_ENABLE_CONCURRENT_POOL( TYPE, DEFAULT_CAPACITY )
+	 Like MEMO_ENABLE_POOL, but the AllocationDispatcher uses a memo::ConcurrentPool instead of a TypedPool protected by a
+	 mutex. Every thread allocates and frees objects in its own cache of free slots, and the caches exchange batches of
+	 slots with a lock-free stack, so threads creating and destroying objects of TYPE at the same time do not serialize.
+	 Use it for types that are created and destroyed by many threads. A type can be enabled with only one of the two macros.
+	This macro must be used in the global namespace, only once, and after TYPE has been defined. */
+#define MEMO_ENABLE_CONCURRENT_POOL( TYPE, DEFAULT_CAPACITY ) namespace memo {															\
+	template <>	class AllocationDispatcher<TYPE> : public memo::ConcurrentPoolDispatcher< TYPE, AllocationDispatcher<TYPE > >	\
+	{																																	\
+	public:																																\
+		static const char * type_name() { return #TYPE; }																				\
+		static size_t get_pool_capacity()																								\
+		{																																\
+			size_t capacity = DEFAULT_CAPACITY;																							\
+			MemoryManager::get_instance().get_pool_object_count( type_name(), &capacity );												\
+			return capacity;																											\
+		}																																\
+	}; }
+
 namespace memo
 {
+	/** \class RegisteredPool
+		Interface of a pool whose state is dumped by MemoryManager::dump_contexts. The pools enabled with MEMO_ENABLE_POOL
+		register themselves when they are created, so that their usage counters can be used to tune their capacity. */
+	class RegisteredPool
+	{
+	public:
+
+		/** Returns the name of the pooled type, used as key in the dump */
+		virtual const char * type_name() const = 0;
+
+		/** Writes out in a human readable way the state of the pool */
+		virtual void dump_state( IAllocator::StateWriter & i_state_writer ) = 0;
+
+	protected:
+
+		RegisteredPool() : m_next_pool( nullptr ) { }
+		~RegisteredPool() { }
+
+		/** Adds the pool to the list of the memory manager. It should be called at the end of the constructor of the
+			derived class, as the pool may be dumped by another thread as soon as it is registered. */
+		void register_pool();
+
+		/** Removes the pool from the list of the memory manager. It must be called before the pool is destroyed. */
+		void unregister_pool();
+
+	private:
+		RegisteredPool( const RegisteredPool & ); // not implemented
+		RegisteredPool & operator = ( const RegisteredPool & ); // not implemented
+
+		friend class MemoryManager;
+		RegisteredPool * m_next_pool; /**< next pool in the list of the memory manager */
+	};
+
 	/** Generic class template PoolDispatcher - dispatch the allocation of single objects to a pool,
 		and allocation of arrays to the DefaultAllocationDispatcher. 
 		You can define a specialization of AllocationDispatcher that derives from PoolDispatcher
 		to enable pooling of a specific type.
 		Allocation of the type TYPE made with MEMO_NEW will be performed with a memo::TypedPool sized
-		with DEFAULT_OBJECT_COUNT. If the pool is full, TypedPool allocates with the default allocator.
+		with DEFAULT_OBJECT_COUNT. If the pool is full, TypedPool adds a chunk with twice the capacity of the previous one.
 		This class is thread-safe. */
 	template < typename TYPE, typename COUNT_GETTER >
 		class PoolDispatcher : public DefaultAllocationDispatcher<TYPE>
 	{
 	private:
 
-		struct Data
+		struct Data : public RegisteredPool
 		{
 			memo_externals::Mutex m_mutex;
 			TypedPool< TYPE> m_pool;
@@ -55,7 +110,24 @@ namespace memo
 				memo::output_mem_size( capacity * sizeof( TYPE ) );
 				memo_externals::output_message( "\n" );
 
-				m_pool.init( capacity );
+				m_pool.init( capacity, 2.f );
+				register_pool();
+			}
+
+			~Data()
+			{
+				unregister_pool();
+			}
+
+			const char * type_name() const
+			{
+				return COUNT_GETTER::type_name();
+			}
+
+			void dump_state( IAllocator::StateWriter & i_state_writer )
+			{
+				MutexLock lock( m_mutex );
+				m_pool.dump_state( i_state_writer );
 			}
 		};
 
@@ -83,5 +155,107 @@ namespace memo
 			MutexLock lock( data.m_mutex );
 			data.m_pool.free( i_pointer );
 		}
+
+		/** new_batch<TYPE>( i_count, o_objects ) - allocates and default-constructs many objects, locking the pool once.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_NEW_BATCH instead. */ 
+		static size_t new_batch( size_t i_count, TYPE * * o_objects )
+		{
+			void * * blocks = reinterpret_cast< void * * >( o_objects );
+
+			size_t count;
+			{
+				Data & data = get_data();
+				MutexLock lock( data.m_mutex );
+				count = data.m_pool.alloc_batch( i_count, blocks );
+			}
+
+			for( size_t index = 0; index < count; index++ )
+				o_objects[ index ] = new( blocks[ index ] ) TYPE;
+
+			return count;
+		}
+
+		/** delete_batch( io_objects, i_count ) - destroys and deallocates many objects, locking the pool once.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE_BATCH instead. */
+		static void delete_batch( TYPE * * io_objects, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				io_objects[ index ]->~TYPE();
+
+			Data & data = get_data();
+			MutexLock lock( data.m_mutex );
+			data.m_pool.free_batch( reinterpret_cast< void * * >( io_objects ), i_count );
+		}
+	};
+
+	/** Generic class template ConcurrentPoolDispatcher - like PoolDispatcher, but the objects are allocated with a
+		memo::ConcurrentPool, so that no mutex is locked by MEMO_NEW and MEMO_DELETE. 
+		You can define a specialization of AllocationDispatcher that derives from ConcurrentPoolDispatcher
+		to enable concurrent pooling of a specific type (see MEMO_ENABLE_CONCURRENT_POOL).
+		This class is thread-safe. */
+	template < typename TYPE, typename COUNT_GETTER >
+		class ConcurrentPoolDispatcher : public DefaultAllocationDispatcher<TYPE>
+	{
+	private:
+
+		struct Data
+		{
+			ConcurrentPool m_pool;
+			Data()
+			{
+				const size_t capacity = COUNT_GETTER::get_pool_capacity();
+				
+				memo_externals::output_message( COUNT_GETTER::type_name() );
+				memo_externals::output_message( ": using a concurrent pool with capacity " );
+				memo::output_integer( capacity );
+				memo_externals::output_message( ", size: " );
+				memo::output_mem_size( capacity * sizeof( TYPE ) );
+				memo_externals::output_message( "\n" );
+
+				m_pool.init( UntypedPool::Config( sizeof(TYPE), MEMO_ALIGNMENT_OF(TYPE), capacity ) );
+			}
+		};
+
+		static Data & get_data()
+			{ static Data s_data; return s_data; }
+
+	public:
+
+		/** typed_alloc<TYPE>() - allocates an object of a given type from the pool. No constructor is called. 
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_NEW instead. */
+		static void * typed_alloc()
+		{
+			return get_data().m_pool.alloc();
+		}
+
+		/** _delete( i_pointer ) - destroys and deallocates an object of a given type with the allocator used to allocate it.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE instead. */
+		static void _delete( TYPE * i_pointer )
+		{
+			i_pointer->~TYPE();
+			get_data().m_pool.free( i_pointer );
+		}
+
+		/** new_batch<TYPE>( i_count, o_objects ) - allocates and default-constructs many objects.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_NEW_BATCH instead. */ 
+		static size_t new_batch( size_t i_count, TYPE * * o_objects )
+		{
+			void * * blocks = reinterpret_cast< void * * >( o_objects );
+			const size_t count = get_data().m_pool.alloc_batch( i_count, blocks );
+			for( size_t index = 0; index < count; index++ )
+				o_objects[ index ] = new( blocks[ index ] ) TYPE;
+
+			return count;
+		}
+
+		/** delete_batch( io_objects, i_count ) - destroys and deallocates many objects.
+			This function is an internal service, and is not supposed to be called directly. Use MEMO_DELETE_BATCH instead. */
+		static void delete_batch( TYPE * * io_objects, size_t i_count )
+		{
+			for( size_t index = 0; index < i_count; index++ )
+				io_objects[ index ]->~TYPE();
+
+			get_data().m_pool.free_batch( reinterpret_cast< void * * >( io_objects ), i_count );
+		}
 	};
 }
\ No newline at end of file
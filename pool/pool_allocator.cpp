@@ -0,0 +1,319 @@
+
+namespace memo
+{
+	struct PoolAllocator::Header
+	{
+		size_t m_size_class; /**< size class of the block, or s_not_pooled if the block has been allocated by the dest allocator */
+
+		static const size_t s_not_pooled = ~static_cast<size_t>( 0 );
+	};
+
+	// PoolAllocator::Config::configure_allocator
+	IAllocator * PoolAllocator::Config::configure_allocator( IAllocator * i_new_allocator ) const
+	{
+		PoolAllocator * allocator;
+		if( i_new_allocator != nullptr )
+			allocator = static_cast< PoolAllocator * >( i_new_allocator );
+		else
+			allocator = MEMO_NEW( PoolAllocator, *this );
+
+		DecoratorAllocator::Config::configure_allocator( allocator );
+
+		return allocator;
+	}
+
+	// PoolAllocator::Config::try_recognize_property
+	bool PoolAllocator::Config::try_recognize_property( serialization::IConfigReader & i_config_reader )
+	{
+		if( DecoratorAllocator::Config::try_recognize_property( i_config_reader ) )
+		{
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "max_size" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_max_size ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "capacity" ) )
+		{
+			if( !i_config_reader.curr_property_vakue_as_uint( &m_capacity ) || m_capacity == 0 )
+				i_config_reader.output_message( serialization::eWrongContent );
+
+			return true;
+		}
+		else if( i_config_reader.try_recognize_property( "growth_factor" ) )
+		{
+			size_t growth_factor = 0;
+			if( !i_config_reader.curr_property_vakue_as_uint( &growth_factor ) )
+				i_config_reader.output_message( serialization::eWrongContent );
+			else
+				m_growth_factor = static_cast<float>( growth_factor );
+
+			return true;
+		}
+
+		return false;
+	}
+
+	// PoolAllocator::constructor
+	PoolAllocator::PoolAllocator( const Config & i_config )
+		: m_max_size( 0 ), m_class_count( 0 )
+	{
+		const size_t max_size = i_config.m_max_size < size_of_class( s_max_class_count - 1 ) ? i_config.m_max_size : size_of_class( s_max_class_count - 1 );
+		const size_t capacity = i_config.m_capacity > 0 ? i_config.m_capacity : 1;
+		const size_t class_count = size_class_of( max_size ) + 1;
+
+		// if a pool can't be initialized, the bigger sizes are allocated by the dest allocator
+		while( m_class_count < class_count )
+		{
+			const UntypedPool::Config pool_config( size_of_class( m_class_count ) + sizeof( Header ), MEMO_MIN_ALIGNMENT, capacity, i_config.m_growth_factor );
+			if( !m_pools[ m_class_count ].init( pool_config ) )
+			{
+				memo_externals::output_message( "PoolAllocator: initialization of a pool failed\n" );
+				break;
+			}
+			m_max_size = size_of_class( m_class_count );
+			m_class_count++;
+		}
+	}
+
+	// PoolAllocator::trim
+	size_t PoolAllocator::trim()
+	{
+		size_t released_chunks = 0;
+		for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+			released_chunks += m_pools[ size_class ].trim();
+		return released_chunks;
+	}
+
+	/* PoolAllocator::pool_alloc - allocates a block in the pool of the size class of i_size. Returns nullptr if the
+		pool can't grow, so that the caller can use the dest allocator. */
+	void * PoolAllocator::pool_alloc( size_t i_size )
+	{
+		const size_t size_class = size_class_of( i_size );
+		if( size_class >= m_class_count )
+			return nullptr;
+
+		Header * header = static_cast<Header *>( m_pools[ size_class ].alloc_slot() );
+		if( header == nullptr )
+			return nullptr;
+
+		header->m_size_class = size_class;
+		return header + 1;
+	}
+
+	// PoolAllocator::pool_free
+	void PoolAllocator::pool_free( Header * i_header )
+	{
+		MEMO_ASSERT( i_header->m_size_class < m_class_count );
+		m_pools[ i_header->m_size_class ].free_slot( i_header );
+	}
+
+	// PoolAllocator::pool_realloc
+	void * PoolAllocator::pool_realloc( Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned )
+	{
+		const size_t prev_size = size_of_class( i_header->m_size_class );
+		void * prev_block = i_header + 1;
+
+		// the block is not moved if it's big enough and it respects the requested alignment
+		if( i_new_size <= prev_size && ( !i_aligned || is_aligned( address_add( prev_block, i_alignment_offset ), i_alignment ) ) )
+			return prev_block;
+
+		void * new_block = i_aligned ? alloc( i_new_size, i_alignment, i_alignment_offset ) : unaligned_alloc( i_new_size );
+		if( new_block == nullptr )
+			return nullptr;
+
+		memcpy( new_block, prev_block, std::min( prev_size, i_new_size ) );
+		pool_free( i_header );
+		return new_block;
+	}
+
+	// PoolAllocator::alloc
+	void * PoolAllocator::alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		if( is_pool_size( i_size, i_alignment, i_alignment_offset ) )
+		{
+			void * block = pool_alloc( i_size );
+			if( block != nullptr )
+				return block;
+		}
+
+		Header * header = static_cast<Header *>( dest_allocator().alloc( i_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+		if( header == nullptr )
+			return nullptr;
+
+		header->m_size_class = Header::s_not_pooled;
+		return header + 1;
+	}
+
+	// PoolAllocator::realloc
+	void * PoolAllocator::realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return pool_realloc( header, i_new_size, i_alignment, i_alignment_offset, true );
+
+		Header * new_header = static_cast<Header *>( dest_allocator().realloc( header, i_new_size + sizeof( Header ), i_alignment, i_alignment_offset + sizeof( Header ) ) );
+		if( new_header == nullptr )
+			return nullptr;
+
+		return new_header + 1;
+	}
+
+	// PoolAllocator::free
+	void PoolAllocator::free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			pool_free( header );
+		else
+			dest_allocator().free( header );
+	}
+
+	// PoolAllocator::dbg_check
+	void PoolAllocator::dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+		{
+			MEMO_ASSERT( header->m_size_class < m_class_count );
+		}
+		else
+			dest_allocator().dbg_check( header );
+	}
+
+	// PoolAllocator::try_expand
+	bool PoolAllocator::try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return i_new_size <= size_of_class( header->m_size_class );
+
+		return dest_allocator().try_expand( header, i_new_size + sizeof( Header ) );
+	}
+
+	// PoolAllocator::usable_size
+	size_t PoolAllocator::usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return size_of_class( header->m_size_class );
+
+		// the dest allocator returns 0 if it does not know the size
+		const size_t dest_size = dest_allocator().usable_size( header );
+		return dest_size > sizeof( Header ) ? dest_size - sizeof( Header ) : 0;
+	}
+
+	// PoolAllocator::unaligned_alloc
+	void * PoolAllocator::unaligned_alloc( size_t i_size )
+	{
+		if( i_size <= m_max_size )
+		{
+			void * block = pool_alloc( i_size );
+			if( block != nullptr )
+				return block;
+		}
+
+		Header * header = static_cast<Header *>( dest_allocator().unaligned_alloc( i_size + sizeof( Header ) ) );
+		if( header == nullptr )
+			return nullptr;
+
+		header->m_size_class = Header::s_not_pooled;
+		return header + 1;
+	}
+
+	// PoolAllocator::unaligned_realloc
+	void * PoolAllocator::unaligned_realloc( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return pool_realloc( header, i_new_size, 0, 0, false );
+
+		Header * new_header = static_cast<Header *>( dest_allocator().unaligned_realloc( header, i_new_size + sizeof( Header ) ) );
+		if( new_header == nullptr )
+			return nullptr;
+
+		return new_header + 1;
+	}
+
+	// PoolAllocator::unaligned_free
+	void PoolAllocator::unaligned_free( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			pool_free( header );
+		else
+			dest_allocator().unaligned_free( header );
+	}
+
+	// PoolAllocator::unaligned_dbg_check
+	void PoolAllocator::unaligned_dbg_check( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+		{
+			MEMO_ASSERT( header->m_size_class < m_class_count );
+		}
+		else
+			dest_allocator().unaligned_dbg_check( header );
+	}
+
+	// PoolAllocator::unaligned_try_expand
+	bool PoolAllocator::unaligned_try_expand( void * i_address, size_t i_new_size )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return i_new_size <= size_of_class( header->m_size_class );
+
+		return dest_allocator().unaligned_try_expand( header, i_new_size + sizeof( Header ) );
+	}
+
+	// PoolAllocator::unaligned_usable_size
+	size_t PoolAllocator::unaligned_usable_size( void * i_address )
+	{
+		MEMO_ASSERT( i_address != nullptr );
+
+		Header * header = static_cast<Header *>( i_address ) - 1;
+		if( header->m_size_class != Header::s_not_pooled )
+			return size_of_class( header->m_size_class );
+
+		const size_t dest_size = dest_allocator().unaligned_usable_size( header );
+		return dest_size > sizeof( Header ) ? dest_size - sizeof( Header ) : 0;
+	}
+
+	// PoolAllocator::dump_state
+	void PoolAllocator::dump_state( StateWriter & i_state_writer )
+	{
+		size_t chunk_count = 0;
+		for( size_t size_class = 0; size_class < m_class_count; size_class++ )
+			chunk_count += m_pools[ size_class ].chunk_count();
+
+		i_state_writer.write( "type", "pool" );
+		i_state_writer.write_mem_size( "max_size", m_max_size );
+		i_state_writer.write_uint( "size_classes", m_class_count );
+		i_state_writer.write_uint( "chunks", chunk_count );
+
+		DecoratorAllocator::dump_state( i_state_writer );
+	}
+
+} // namespace memo
@@ -0,0 +1,177 @@
+
+namespace memo
+{
+	/**	\class PoolAllocator
+		Decorator allocator that serves small blocks from an array of UntypedPool, one for every size class. The size
+		classes are the powers of 2 from 8 bytes up to the maximum size. Blocks bigger than the maximum size, or requiring
+		an alignment bigger than MEMO_MIN_ALIGNMENT, are allocated by the target allocator.
+		The pools grow by chunks when they are full (see UntypedPool::Config::m_growth_factor). If a pool can't grow,
+		the target allocator is used for its size class. The buffers and the chunks of the pools are allocated with the default allocator.
+		A size_t is added as overhead to every memory block, to store its size class.
+		It is suitable for contexts that allocate many small objects of different types, like strings and nodes of
+		containers, that can't be pooled by type with MEMO_ENABLE_POOL.
+		The allocator is not thread safe.
+
+		The following parameters are supported in the configuration file:
+		- target: inherited from DecoratorAllocator, is the name of the type of target allocator (for example "default_allocator",
+			"tlsf_allocator").
+		- max_size: maximum size of the blocks served by the pools. It is rounded up to a power of 2. The default is 512.
+		- capacity: number of blocks in the first buffer of every pool. The default is 256.
+		- growth_factor: ratio between the capacity of a new chunk of a pool and the capacity of the previous one. The
+			default is 2. */
+	class PoolAllocator : public DecoratorAllocator
+	{
+	public:
+
+		/** Static function returning the name of the allocator class, used to register the type.
+		   This name can be used to instantiate this allocator in the configuration file. */
+		static const char * type_name() { return "pool_allocator"; }
+
+
+								///// configuration /////
+
+		/** Config structure for PoolAllocator */
+		struct Config : public DecoratorAllocator::Config
+		{
+		public:
+
+			size_t m_max_size; /**< maximum size of the blocks served by the pools */
+			size_t m_capacity; /**< number of blocks in the first buffer of every pool */
+			float m_growth_factor; /**< ratio between the capacity of a new chunk of a pool and the capacity of the previous one */
+
+			Config()
+				: m_max_size( 512 ), m_capacity( 256 ), m_growth_factor( 2.f ) { }
+
+		protected:
+
+			/** configures and returns a new allocator, eventually creating it using MEMO_NEW if i_new_allocator is nullptr */
+			virtual IAllocator * configure_allocator( IAllocator * i_new_allocator ) const;
+
+			/** Tries to recognize the current property from the stream, and eventually reads its value.
+			  @param i_config_reader the source stream
+			  @return true if the property has been recognized, false otherwise */
+			bool try_recognize_property( serialization::IConfigReader & i_config_reader );
+		};
+
+		/** Constructs the allocator, initializing the pools. The dest allocator is created by the config structure (see DecoratorAllocator::Config) */
+		PoolAllocator( const Config & i_config );
+
+		/** Trims all the pools (see UntypedPool::trim)
+			@return number of chunks deallocated */
+		size_t trim();
+
+
+								///// aligned allocations /////
+
+		/** allocates an aligned memory block. Implements IAllocator::alloc.
+			Small blocks are taken from the pool of their size class, the others are allocated by the dest allocator.
+		  @param i_size size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from beginning of the block of the address that respects the alignment
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * alloc( size_t i_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** changes the size of the memory block allocated by alloc, possibly moving it in a new location. Implements IAllocator::realloc.
+			A block of a pool is not moved if the new size does not exceed the size of its class and the block respects the
+			requested alignment.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @param i_alignment alignment requested for the block. It must be an integer power of 2
+		  @param i_alignment_offset offset from the address that respects the alignment
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * realloc( void * i_address, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset );
+
+		/** deallocates a memory block allocated by alloc or realloc. Implements IAllocator::free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void free( void * i_address );
+
+		/** Implements IAllocator::dbg_check.
+		  @param i_address address of the memory block to check */
+		void dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by alloc or realloc without moving it. Implements IAllocator::try_expand.
+			A block of a pool can be resized up to the size of its class.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by alloc or realloc. Implements IAllocator::usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t usable_size( void * i_address );
+
+
+							///// unaligned allocations /////
+
+		/** allocates a new memory block. Implements IAllocator::unaligned_alloc.
+			Small blocks are taken from the pool of their size class, the others are allocated by the dest allocator.
+		  @param i_size size of the block in bytes
+		  @return the address of the first byte in the block, or nullptr if the allocation fails */
+		void * unaligned_alloc( size_t i_size );
+
+		/** changes the size of the memory block allocated by unaligned_alloc. Implements IAllocator::unaligned_realloc.
+			A block of a pool is not moved if the new size does not exceed the size of its class.
+		  @param i_address address of the memory block to reallocate. This parameter cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return the new address of the first byte in the block, or nullptr if the reallocation fails */
+		void * unaligned_realloc( void * i_address, size_t i_new_size );
+
+		/** deallocates a memory block allocated by unaligned_alloc or unaligned_realloc. Implements IAllocator::unaligned_free.
+		  @param i_address address of the memory block to free. It cannot be nullptr. */
+		void unaligned_free( void * i_address );
+
+		/** Implements IAllocator::unaligned_dbg_check.
+		  @param i_address address of the memory block to check */
+		void unaligned_dbg_check( void * i_address );
+
+		/** tries to resize a memory block allocated by unaligned_alloc or unaligned_realloc without moving it.
+			Implements IAllocator::unaligned_try_expand. A block of a pool can be resized up to the size of its class.
+		  @param i_address address of the memory block to resize. It cannot be nullptr.
+		  @param i_new_size new size of the block in bytes
+		  @return true if the block has been resized, false otherwise */
+		bool unaligned_try_expand( void * i_address, size_t i_new_size );
+
+		/** retrieves the usable size of a memory block allocated by unaligned_alloc or unaligned_realloc.
+			Implements IAllocator::unaligned_usable_size.
+		  @param i_address address of the memory block. It cannot be nullptr.
+		  @return the usable size of the block */
+		size_t unaligned_usable_size( void * i_address );
+
+		/** Writes out in a human readable way the state of the allocator */
+		void dump_state( StateWriter & i_state_writer );
+
+	private:
+		PoolAllocator( const PoolAllocator & ); // not implemented
+		PoolAllocator & operator = ( const PoolAllocator & ); // not implemented
+
+		struct Header;
+
+		static const size_t s_min_class_size = 8;
+		static const size_t s_max_class_count = 16; /**< the biggest class is 256 KB */
+
+		static size_t size_of_class( size_t i_size_class )
+			{ return s_min_class_size << i_size_class; }
+
+		static size_t size_class_of( size_t i_size )
+		{
+			size_t size_class = 0;
+			while( size_of_class( size_class ) < i_size )
+				size_class++;
+			return size_class;
+		}
+
+		bool is_pool_size( size_t i_size, size_t i_alignment, size_t i_alignment_offset ) const
+			{ return i_size <= m_max_size && i_alignment <= MEMO_MIN_ALIGNMENT && ( i_alignment_offset & ( i_alignment - 1 ) ) == 0; }
+
+		void * pool_alloc( size_t i_size );
+		void pool_free( Header * i_header );
+		void * pool_realloc( Header * i_header, size_t i_new_size, size_t i_alignment, size_t i_alignment_offset, bool i_aligned );
+
+	private: // data members
+		size_t m_max_size;
+		size_t m_class_count;
+		UntypedPool m_pools[ s_max_class_count ];
+	};
+
+} // namespace memo
@@ -6,8 +6,9 @@ namespace memo
 		buffer with the default allocator. This buffer is large enough to contain the number of elements specified during the
 		initialization (see UntypedPool::init).
 		The pool keeps a linked list of free slots. So both allocations and deallocation are constant time and very fast.
-		There is not space overhead, nor any fragmentation. The only drawback is that the pool must be initialized with a size.
-		When the pool is full, this class can allocate transparently using the default allocator.
+		There is not space overhead, nor any fragmentation.
+		When the pool is full, this class can allocate transparently using the default allocator, or it can grow by chunks
+		(see UntypedPool).
 		If you want to use a pool not for a specific type (with the only constraint of the fixed size), you may use memo::UntypedPool.
 		This class is not thread safe.
 	*/
@@ -18,26 +19,41 @@ namespace memo
 
 		TypedPool() { }
 
-		TypedPool( size_t i_object_count )
+		TypedPool( size_t i_object_count, float i_growth_factor = 0.f )
 		{ 
-			init( i_object_count );
+			init( i_object_count, i_growth_factor );
 		}
 
 		/** Allocates a buffer with the default allocator, and formats it to be used for fixed size allocations.
 			@params i_object_count number of objects in the pool
+			@params i_growth_factor ratio between the capacity of a new chunk and the capacity of the previous one (see 
+				UntypedPool::Config::m_growth_factor). If it is zero the pool does not grow.
 			@return true if the buffer was successfully allocated and formatted, false otherwise */
-		bool init( size_t i_object_count )
+		bool init( size_t i_object_count, float i_growth_factor = 0.f )
 		{
-			const UntypedPool::Config config( sizeof(TYPE), MEMO_ALIGNMENT_OF(TYPE), i_object_count );
+			const UntypedPool::Config config( sizeof(TYPE), MEMO_ALIGNMENT_OF(TYPE), i_object_count, i_growth_factor );
 			return m_pool.init( config );
 		}
 
-		/** Deallocates the buffer used by the pool. This method should be called only when there are no living blocks 
+		/** Deallocates the buffer and the chunks used by the pool. This method should be called only when there are no living blocks 
 			allocated by the pool. It's legal to call this method before init or twice. */
 		void uninit()								{ m_pool.uninit(); }
+
+		/** Deallocates the chunks whose slots are all free (see UntypedPool::trim).
+			@return number of chunks deallocated */
+		size_t trim()								{ return m_pool.trim(); }
+
+		/** Returns the number of chunks allocated because the pool has grown */
+		size_t chunk_count() const					{ return m_pool.chunk_count(); }
+
+		/** Returns the usage counters of the pool (see UntypedPool::Statistics) */
+		const UntypedPool::Statistics & statistics() const		{ return m_pool.statistics(); }
+
+		/** Writes out in a human readable way the configuration and the usage counters of the pool */
+		void dump_state( IAllocator::StateWriter & i_state_writer ) const		{ m_pool.dump_state( i_state_writer ); }
 		
 		/** Allocates a block of memory. The size and the alignment of the block are those of TYPE.
-			If there is not a free sot in the pool, this method allocates using the default allocator.
+			If there is not a free sot in the pool, this method grows the pool if it can, otherwise it allocates using the default allocator.
 			This method allocates a block without constructing any object. You may use the new in-place to construct an object:
 			\code{.cpp}
 				new ( my_pool.alloc() ) MY_TYPE( arg1, arg2 ... )
@@ -65,6 +81,18 @@ namespace memo
 			@param i_element address of the block to free. Can't be nullptr. */
 		void free_slot( void * i_address )			{ m_pool.free_slot( i_address ); }
 
+		/** Allocates many blocks of memory. The size and the alignment of the blocks are those of TYPE. The blocks are taken from
+			the pool while there are free slots, then the default allocator is used. No object is constructed.
+			@param i_count number of blocks to allocate
+			@param o_addresses array that receives the addresses of the blocks
+			@return number of blocks allocated. It is less than i_count only if the default allocator has failed. */
+		size_t alloc_batch( size_t i_count, void * * o_addresses )			{ return m_pool.alloc_batch( i_count, o_addresses ); }
+
+		/** Frees many blocks of memory, allocated with alloc, alloc_slot or alloc_batch. No destructor is called.
+			@param i_addresses array of the addresses of the blocks to free. None of them can be nullptr.
+			@param i_count number of blocks to free */
+		void free_batch( void * const * i_addresses, size_t i_count )		{ m_pool.free_batch( i_addresses, i_count ); }
+
 		/** Allocates a block of memory, and default-construct an object on it.
 			If there is not a free sot in the pool, this method allocates using the default allocator.
 			This method allocates a block constructing the object. Use alloc if you just want to allocate the memory.
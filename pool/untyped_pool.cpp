@@ -1,8 +1,17 @@
 
 namespace memo
 {
+	// Extra buffer allocated when the pool grows. The slots follow the header.
+	struct UntypedPool::Chunk
+	{
+		Chunk * m_next; /**< previous chunk in order of allocation */
+		FreeSlot * m_start, * m_end; /**< range of the slots */
+		size_t m_free_count; /**< used by trim */
+	};
+
 	UntypedPool::UntypedPool()
-		: m_buffer_start( nullptr ), m_buffer_end( nullptr ), m_first_free( nullptr )
+		: m_buffer_start( nullptr ), m_buffer_end( nullptr ), m_first_free( nullptr ), m_high_water( nullptr ), m_high_water_end( nullptr ),
+		  m_first_chunk( nullptr ), m_next_chunk_count( 0 )
 	{
 
 	}
@@ -16,6 +25,8 @@ namespace memo
 		m_config = i_config;
 		m_config.m_element_size = std::max( m_config.m_element_size, sizeof(FreeSlot) );
 		m_config.m_element_alignment = std::max( m_config.m_element_alignment, MEMO_ALIGNMENT_OF(FreeSlot) );
+		m_next_chunk_count = static_cast<size_t>( m_config.m_element_count * m_config.m_growth_factor );
+		m_statistics = Statistics();
 
 		m_first_free = nullptr;
 		const size_t buffer_size = m_config.m_element_size * m_config.m_element_count;
@@ -27,49 +38,203 @@ namespace memo
 		}
 		else
 		{
+			// no slot is written here, the high-water mark will move through the buffer while allocating
 			m_buffer_end = static_cast<FreeSlot*>( address_add( m_buffer_start, buffer_size ) );
-			format_free_space();
+			m_high_water = m_buffer_start;
+			m_high_water_end = m_buffer_end;
 			return true;
 		}		
 	}
 
 	void UntypedPool::uninit()
 	{
+		while( m_first_chunk != nullptr )
+		{
+			Chunk * chunk = m_first_chunk;
+			m_first_chunk = chunk->m_next;
+			get_default_allocator().free( chunk );
+		}
+
 		if( m_buffer_start != nullptr )
 		{
 			get_default_allocator().free( m_buffer_start );
 			m_buffer_start = nullptr;
 			m_buffer_end = nullptr;
 			m_first_free = nullptr;
+			m_high_water = nullptr;
+			m_high_water_end = nullptr;
 		}
 	}
 
-	void UntypedPool::format_free_space()
+	size_t UntypedPool::alloc_batch( size_t i_count, void * * o_elements )
 	{
-		MEMO_ASSERT( m_buffer_start != nullptr && m_buffer_end != nullptr && m_buffer_start <= m_buffer_end );
-		
-		FreeSlot * curr = m_buffer_start, * next;
-		
-		if( curr < m_buffer_end )
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+
+		size_t index = 0;
+		FreeSlot * first_free = m_first_free;
+		for( ; index < i_count && first_free != nullptr; index++ )
 		{
-			m_first_free = curr;
+			o_elements[ index ] = first_free;
+			first_free = first_free->m_next;
 		}
-		else
+		m_first_free = first_free;
+		on_slots_taken( index );
+
+		for( ; index < i_count; index++ )
 		{
-			m_first_free = nullptr;
+			o_elements[ index ] = alloc();
+			if( o_elements[ index ] == nullptr )
+				break;
 		}
 
-		while( curr < m_buffer_end )
+		return index;
+	}
+
+	void UntypedPool::free_batch( void * const * i_elements, size_t i_count )
+	{
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+
+		FreeSlot * first_free = m_first_free;
+		size_t overflow_count = 0;
+		for( size_t index = 0; index < i_count; index++ )
 		{
-			next = static_cast<FreeSlot *>( address_add( curr, m_config.m_element_size ) );
-			if( next < m_buffer_end )
-				curr->m_next = next;
+			void * element = i_elements[ index ];
+			MEMO_ASSERT( element != nullptr );
+			if( is_in_pool( element ) )
+			{
+				FreeSlot * new_free_slot = static_cast<FreeSlot *>( element );
+				new_free_slot->m_next = first_free;
+				first_free = new_free_slot;
+			}
 			else
-				curr->m_next = nullptr;
+			{
+				memo::free( element );
+				overflow_count++;
+			}
+		}
+		m_first_free = first_free;
+		m_statistics.m_live_slots -= i_count - overflow_count;
+		m_statistics.m_overflow_frees += overflow_count;
+	}
+
+	// allocates a new chunk, and moves the high-water mark to its first slot
+	bool UntypedPool::add_chunk()
+	{
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+		MEMO_ASSERT( m_first_free == nullptr && m_high_water == m_high_water_end ); // the pool must be full
+
+		if( m_config.m_growth_factor <= 0.f )
+			return false;
+
+		const size_t element_count = std::max<size_t>( m_next_chunk_count, 1 );
+		const size_t alignment = std::max( m_config.m_element_alignment, MEMO_ALIGNMENT_OF(Chunk) );
+		const size_t header_size = ( sizeof(Chunk) + alignment - 1 ) & ~( alignment - 1 );
+		const size_t slots_size = element_count * m_config.m_element_size;
+		Chunk * chunk = static_cast<Chunk*>( get_default_allocator().alloc( header_size + slots_size, alignment, 0 ) );
+		if( chunk == nullptr )
+			return false;
+
+		chunk->m_start = static_cast<FreeSlot*>( address_add( chunk, header_size ) );
+		chunk->m_end = static_cast<FreeSlot*>( address_add( chunk->m_start, slots_size ) );
+		chunk->m_free_count = 0;
+		chunk->m_next = m_first_chunk;
+		m_first_chunk = chunk;
+
+		m_high_water = chunk->m_start;
+		m_high_water_end = chunk->m_end;
 
-			curr = next;
+		m_next_chunk_count = std::max<size_t>( static_cast<size_t>( element_count * m_config.m_growth_factor ), 1 );
+		return true;
+	}
+
+	// finds the chunk containing an element, starting from the most recent one
+	UntypedPool::Chunk * UntypedPool::find_chunk( const void * i_element ) const
+	{
+		for( Chunk * chunk = m_first_chunk; chunk != nullptr; chunk = chunk->m_next )
+		{
+			if( i_element >= chunk->m_start && i_element < chunk->m_end )
+				return chunk;
+		}
+		return nullptr;
+	}
+
+	size_t UntypedPool::chunk_count() const
+	{
+		size_t count = 0;
+		for( Chunk * chunk = m_first_chunk; chunk != nullptr; chunk = chunk->m_next )
+			count++;
+		return count;
+	}
+
+	void UntypedPool::dump_state( IAllocator::StateWriter & i_state_writer ) const
+	{
+		i_state_writer.write_mem_size( "element_size", m_config.m_element_size );
+		i_state_writer.write_uint( "capacity", m_config.m_element_count );
+		i_state_writer.write_uint( "chunks", chunk_count() );
+		i_state_writer.write_uint( "live_slots", m_statistics.m_live_slots );
+		i_state_writer.write_uint( "peak_slots", m_statistics.m_peak_slots );
+		i_state_writer.write_uint( "overflow_allocs", m_statistics.m_overflow_allocs );
+		i_state_writer.write_uint( "overflow_frees", m_statistics.m_overflow_frees );
+	}
+
+	size_t UntypedPool::trim()
+	{
+		if( m_first_chunk == nullptr )
+			return 0;
+
+		// counts the free slots of every chunk
+		for( Chunk * chunk = m_first_chunk; chunk != nullptr; chunk = chunk->m_next )
+			chunk->m_free_count = 0;
+		for( FreeSlot * slot = m_first_free; slot != nullptr; slot = slot->m_next )
+		{
+			Chunk * chunk = find_chunk( slot );
+			if( chunk != nullptr )
+				chunk->m_free_count++;
+		}
+		Chunk * high_water_chunk = m_high_water < m_high_water_end ? find_chunk( m_high_water ) : nullptr;
+		if( high_water_chunk != nullptr )
+			high_water_chunk->m_free_count += address_diff( m_high_water_end, m_high_water ) / m_config.m_element_size;
+
+		// removes from the free list the slots of the chunks to deallocate
+		FreeSlot * * prev_link = &m_first_free;
+		for( FreeSlot * slot = m_first_free; slot != nullptr; slot = slot->m_next )
+		{
+			Chunk * chunk = find_chunk( slot );
+			if( chunk == nullptr || chunk->m_free_count * m_config.m_element_size != address_diff( chunk->m_end, chunk->m_start ) )
+			{
+				*prev_link = slot;
+				prev_link = &slot->m_next;
+			}
+		}
+		*prev_link = nullptr;
+
+		// deallocates the chunks
+		size_t released_count = 0;
+		Chunk * * prev_chunk_link = &m_first_chunk;
+		while( *prev_chunk_link != nullptr )
+		{
+			Chunk * chunk = *prev_chunk_link;
+			if( chunk->m_free_count * m_config.m_element_size == address_diff( chunk->m_end, chunk->m_start ) )
+			{
+				*prev_chunk_link = chunk->m_next;
+				if( chunk == high_water_chunk )
+				{
+					m_high_water = nullptr;
+					m_high_water_end = nullptr;
+				}
+				get_default_allocator().free( chunk );
+				released_count++;
+			}
+			else
+			{
+				prev_chunk_link = &chunk->m_next;
+			}
 		}
 
-		MEMO_ASSERT( curr == m_buffer_end ); // the size of the buffer should be aligned to the size of an element
+		// the growth restarts from the most recent chunk left
+		const size_t last_count = m_first_chunk != nullptr ? address_diff( m_first_chunk->m_end, m_first_chunk->m_start ) / m_config.m_element_size
+			: m_config.m_element_count;
+		m_next_chunk_count = std::max<size_t>( static_cast<size_t>( last_count * m_config.m_growth_factor ), 1 );
+		return released_count;
 	}
 }
\ No newline at end of file
@@ -4,9 +4,15 @@ namespace memo
 	/**	\class UntypedPool
 		Class providing efficient fixed-size allocation services. When initialized, the pool allocates a buffer with the default allocator.
 		This buffer is large enough to contain the number of elements specified in the configuration (see UntypedPool::init).
-		The pool keeps a linked list of free slots. So both allocations and deallocation are constant time and very fast.
-		There is not space overhead, nor any fragmentation. The only drawback is that the pool must be initialized with a size.
-		When the pool is full, this class can allocate transparently using the default allocator.
+		The pool keeps a linked list of the freed slots, while the slots never allocated are taken incrementing a pointer
+		(high-water mark). So both allocations and deallocation are constant time and very fast, and init is constant time
+		too: the pages of the buffer are touched only when the slots on them are allocated.
+		There is not space overhead, nor any fragmentation.
+		When the pool is full, this class can allocate transparently using the default allocator. If the configuration
+		specifies a growth factor, the pool instead allocates an extra buffer (chunk), whose capacity is the capacity of the
+		previous one multiplied by the growth factor. Blocks freed in a chunk are found by address, scanning the chunks from
+		the most recent one, so with a growth factor of 2 or more there are always few chunks. The chunks whose slots are all
+		free can be released with trim.
 		If you want to use a pool for a specific type, you may use memo::TypedPool.
 		This class is not thread safe.
 	*/
@@ -17,14 +23,29 @@ namespace memo
 		struct Config
 		{
 			Config()
-				: m_element_size( 0 ), m_element_alignment( 0 ), m_element_count( 0 ) { }
+				: m_element_size( 0 ), m_element_alignment( 0 ), m_element_count( 0 ), m_growth_factor( 0.f ) { }
 
-			Config( size_t i_element_size, size_t i_element_alignment, size_t i_element_count ) 
-				: m_element_size( i_element_size ), m_element_alignment( i_element_alignment ), m_element_count( i_element_count ) { }
+			Config( size_t i_element_size, size_t i_element_alignment, size_t i_element_count, float i_growth_factor = 0.f ) 
+				: m_element_size( i_element_size ), m_element_alignment( i_element_alignment ), m_element_count( i_element_count ),
+				  m_growth_factor( i_growth_factor ) { }
 
 			size_t m_element_size; /**< size of an allocable element */
 			size_t m_element_alignment; /**< alignment of an allocable element */
 			size_t m_element_count; /**< number of elements that  */
+			float m_growth_factor; /**< ratio between the capacity of a new chunk and the capacity of the previous one. If it
+										is zero the pool does not grow, and allocates with the default allocator when it is full. */
+		};
+
+		/** Counters of the usage of the pool, cleared by init. They can be used to tune the capacity of the pool. */
+		struct Statistics
+		{
+			Statistics()
+				: m_live_slots( 0 ), m_peak_slots( 0 ), m_overflow_allocs( 0 ), m_overflow_frees( 0 ) { }
+
+			size_t m_live_slots; /**< number of slots of the pool currently allocated */
+			size_t m_peak_slots; /**< maximum number of slots of the pool allocated at the same time */
+			size_t m_overflow_allocs; /**< number of blocks allocated outside the pool, because it was full and could not grow */
+			size_t m_overflow_frees; /**< number of blocks outside the pool that have been freed */
 		};
 
 		/** Constructs an unitialized pool. Call UntypedPool::init before using any other method. */
@@ -39,17 +60,32 @@ namespace memo
 			@return true if the buffer was successfully allocated and formatted, false otherwise */
 		bool init( const Config & i_config );
 
-		/** Deallocates the buffer used by the pool. This method should be called only when there are no living blocks 
+		/** Deallocates the buffer and the chunks used by the pool. This method should be called only when there are no living blocks 
 			allocated by the pool. It's legal to call this method before init or twice. */
 		void uninit();
 
+		/** Deallocates the chunks whose slots are all free. The first buffer is never deallocated. This method walks the
+			whole list of free slots, so it should not be called frequently.
+			@return number of chunks deallocated */
+		size_t trim();
+
+		/** Returns the number of chunks allocated because the pool has grown */
+		size_t chunk_count() const;
+
+		/** Returns the usage counters of the pool */
+		const Statistics & statistics() const			{ return m_statistics; }
+
+		/** Writes out in a human readable way the configuration and the usage counters of the pool */
+		void dump_state( IAllocator::StateWriter & i_state_writer ) const;
+
 		/** Allocates a block of memory. The size and the alignment of the block are those specified in the configuration of the pool.
-			If there is not a free sot in the pool, this method allocates using the default allocator.
+			If there is not a free sot in the pool, this method adds a chunk to the pool if it can grow, otherwise it allocates
+			using the default allocator.
 			@return address of the newly allocated block, or nullptr if both the pool and the default allocator could not allocate the block. */
 		void * alloc();
 
 		/** Allocates a block of memory. The size and the alignment of the block are those specified in the configuration of the pool.
-			Unlike UntypedPool::alloc, this method allocates only in the pool.
+			Unlike UntypedPool::alloc, this method allocates only in the pool (possibly adding a chunk).
 			@return address of the newly allocated block, or nullptr if the pool could not allocate the block. */
 		void * alloc_slot();
 
@@ -63,6 +99,18 @@ namespace memo
 			@param i_element address of the block to free. Can't be nullptr. */
 		void free_slot( void * i_element );
 
+		/** Allocates many blocks of memory. The size and the alignment of the blocks are those specified in the configuration of the pool.
+			The blocks are taken from the pool while there are free slots, then the pool grows, if it can, or the default allocator is used.
+			@param i_count number of blocks to allocate
+			@param o_elements array that receives the addresses of the blocks
+			@return number of blocks allocated. It is less than i_count only if the default allocator has failed. */
+		size_t alloc_batch( size_t i_count, void * * o_elements );
+
+		/** Frees many blocks of memory, allocated with alloc, alloc_slot or alloc_batch.
+			@param i_elements array of the addresses of the blocks to free. None of them can be nullptr.
+			@param i_count number of blocks to free */
+		void free_batch( void * const * i_elements, size_t i_count );
+
 	private:
 
 		struct FreeSlot
@@ -70,11 +118,25 @@ namespace memo
 			FreeSlot * m_next;
 		};
 
-		void format_free_space();
+		struct Chunk;
+
+		void * take_slot();
+		void on_slots_taken( size_t i_count );
+		bool add_chunk();
+		Chunk * find_chunk( const void * i_element ) const;
+		bool is_in_pool( const void * i_element ) const
+		{
+			return ( i_element >= m_buffer_start && i_element < m_buffer_end ) || 
+				( m_first_chunk != nullptr && find_chunk( i_element ) != nullptr );
+		}
 
 	private:
 		Config m_config;
 		FreeSlot * m_buffer_start, * m_buffer_end, * m_first_free;
+		FreeSlot * m_high_water, * m_high_water_end; /**< slots never allocated, in the buffer or in the most recent chunk */
+		Chunk * m_first_chunk; /**< most recent chunk */
+		size_t m_next_chunk_count; /**< number of elements of the next chunk */
+		Statistics m_statistics;
 	};
 
 } // namespace memo
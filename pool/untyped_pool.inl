@@ -2,15 +2,31 @@
 
 namespace memo
 {
-	MEMO_INLINE void * UntypedPool::alloc_slot()
+	// updates the counters after some slots have been allocated
+	MEMO_INLINE void UntypedPool::on_slots_taken( size_t i_count )
 	{
-		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+		m_statistics.m_live_slots += i_count;
+		if( m_statistics.m_peak_slots < m_statistics.m_live_slots )
+			m_statistics.m_peak_slots = m_statistics.m_live_slots;
+	}
 
+	// takes a slot from the free list, or above the high-water mark, possibly adding a chunk
+	MEMO_INLINE void * UntypedPool::take_slot()
+	{
 		if( m_first_free != nullptr )
 		{
 			void * result = m_first_free;
 			m_first_free = m_first_free->m_next;
 			MEMO_ASSERT( is_aligned( result, m_config.m_element_alignment ) );
+			on_slots_taken( 1 );
+			return result;
+		}
+		else if( m_high_water < m_high_water_end || add_chunk() )
+		{
+			void * result = m_high_water;
+			m_high_water = static_cast<FreeSlot *>( address_add( m_high_water, m_config.m_element_size ) );
+			MEMO_ASSERT( is_aligned( result, m_config.m_element_alignment ) );
+			on_slots_taken( 1 );
 			return result;
 		}
 		else
@@ -19,32 +35,37 @@ namespace memo
 		}
 	}
 
+	MEMO_INLINE void * UntypedPool::alloc_slot()
+	{
+		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
+
+		return take_slot();
+	}
+
 	MEMO_INLINE void UntypedPool::free_slot( void * i_element )
 	{
 		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
 
-		MEMO_ASSERT( i_element >= m_buffer_start && i_element < m_buffer_end );
+		MEMO_ASSERT( is_in_pool( i_element ) );
 
 		FreeSlot * new_free_slot = static_cast<FreeSlot *>( i_element );
 		new_free_slot->m_next = m_first_free;
 		m_first_free = new_free_slot;
+		m_statistics.m_live_slots--;
 	}
 
 	MEMO_INLINE void * UntypedPool::alloc()
 	{
 		MEMO_ASSERT( m_buffer_start != nullptr ); // call init first
 
-		if( m_first_free != nullptr )
-		{
-			void * result = m_first_free;
-			m_first_free = m_first_free->m_next;
-			MEMO_ASSERT( is_aligned( result, m_config.m_element_alignment ) );
+		void * result = take_slot();
+		if( result != nullptr )
 			return result;
-		}
-		else
-		{
-			return memo::alloc( m_config.m_element_size, m_config.m_element_alignment, 0 );
-		}
+
+		result = memo::alloc( m_config.m_element_size, m_config.m_element_alignment, 0 );
+		if( result != nullptr )
+			m_statistics.m_overflow_allocs++;
+		return result;
 	}
 
 	MEMO_INLINE void UntypedPool::free( void * i_element )
@@ -54,15 +75,17 @@ namespace memo
 		MEMO_ASSERT( i_element != nullptr );
 		MEMO_ASSERT( is_aligned( i_element, m_config.m_element_alignment ) );
 
-		if( i_element >= m_buffer_start && i_element < m_buffer_end )
+		if( is_in_pool( i_element ) )
 		{
 			FreeSlot * new_free_slot = static_cast<FreeSlot *>( i_element );
 			new_free_slot->m_next = m_first_free;
 			m_first_free = new_free_slot;
+			m_statistics.m_live_slots--;
 		}
 		else
 		{
 			memo::free( i_element );
+			m_statistics.m_overflow_frees++;
 		}
 	}
 
@@ -49,13 +49,12 @@ namespace memo
 		// deallocate
 		void deallocate( pointer i_pointer, size_type i_count )
 		{ 
-			MEMO_UNUSED( i_count );
 			if( i_pointer != nullptr )
 			{
 				if( MEMO_ALIGNMENT_OF( TYPE ) > MEMO_MIN_ALIGNMENT ) 
-					memo::free( i_pointer );
+					memo::free_sized( i_pointer, i_count * sizeof(TYPE) );
 				else
-					memo::unaligned_free( i_pointer );
+					memo::unaligned_free_sized( i_pointer, i_count * sizeof(TYPE) );
 			}			
 		}
 
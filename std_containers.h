@@ -1,26 +1,5 @@
 
 
-namespace std
-{
-	// forwards of std strings
-	template < typename charT, typename TRAITS, typename ALLOCATOR > class basic_string;
-
-	// forwards of std containers
-	template < typename TYPE, class ALLOCATOR > class vector;
-	template < typename TYPE, class ALLOCATOR > class list;
-	template < typename TYPE, class ALLOCATOR > class queue;
-	template < typename TYPE, class ALLOCATOR > class deque;
-	template < typename KEY, typename VALUE, typename COMPARE, typename ALLOCATOR > class map;
-	template < typename KEY, typename VALUE, typename COMPARE, typename ALLOCATOR > class multimap;
-	template < typename VALUE, typename COMPARE, typename ALLOCATOR > class set;
-	template < typename VALUE, typename COMPARE, typename ALLOCATOR > class multiset;
-	template < typename KEY, typename VALUE, typename HASH, typename PRED, typename ALLOCATOR > class unordered_map;
-	template < typename KEY, typename VALUE, typename HASH, typename PRED, typename ALLOCATOR > class unordered_multimap;
-	template < typename KEY, typename HASH, typename PRED, typename ALLOCATOR > class unordered_set;
-	template < typename KEY, typename HASH, typename PRED, typename ALLOCATOR > class unordered_multiset;
-
-} // namespace std
-
 namespace memo
 {
 	// std_string
@@ -47,11 +26,11 @@ namespace memo
 
 	// std_map< KEY, VALUE >::type
 	template <typename KEY, typename VALUE> struct std_map
-		{ typedef std::map< KEY, VALUE, typename std::less< KEY >, typename StdAllocator< std::pair<KEY, VALUE> > > type; };
+		{ typedef std::map< KEY, VALUE, std::less< KEY >, StdAllocator< std::pair<const KEY, VALUE> > > type; };
 
 	// std_multimap< KEY, VALUE >::type
 	template <typename KEY, typename VALUE> struct std_multimap
-		{ typedef std::multimap< KEY, VALUE, std::less< KEY >, StdAllocator< std::pair<KEY, VALUE> > > type; };
+		{ typedef std::multimap< KEY, VALUE, std::less< KEY >, StdAllocator< std::pair<const KEY, VALUE> > > type; };
 
 	// std_set< VALUE >::type
 	template <typename VALUE> struct std_set
@@ -63,22 +42,22 @@ namespace memo
 
 	// std_unordered_map< KEY, VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
 	template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > struct std_unordered_map
-		{ typedef std::unordered_map< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<KEY, VALUE> > > type; };
+		{ typedef std::unordered_map< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > > type; };
 
 	// std_unordered_multimap< KEY, VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
 	template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > struct std_unordered_multimap
-		{ typedef std::unordered_multimap< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<KEY, VALUE> > > type; };
+		{ typedef std::unordered_multimap< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > > type; };
 
-	// std_unordered_set< VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
-	template < typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > struct std_unordered_set
+	// std_unordered_set< VALUE, HASH = std::hash<VALUE>, PREDICATE = std::equal_to<VALUE> >::type
+	template < typename VALUE, typename HASH = std::hash<VALUE>, typename PREDICATE = std::equal_to<VALUE> > struct std_unordered_set
 		{ typedef std::unordered_set< VALUE, HASH, PREDICATE, StdAllocator< VALUE > > type; };
 
-	// std_unordered_multiset< VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
-	template < typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > struct std_unordered_multiset
+	// std_unordered_multiset< VALUE, HASH = std::hash<VALUE>, PREDICATE = std::equal_to<VALUE> >::type
+	template < typename VALUE, typename HASH = std::hash<VALUE>, typename PREDICATE = std::equal_to<VALUE> > struct std_unordered_multiset
 		{ typedef std::unordered_multiset< VALUE, HASH, PREDICATE, StdAllocator< VALUE > > type; };
 
 	// std_priority_queue< VALUE, CONTAINER = std_vector<KEY>, PREDICATE = std::less<KEY> >::type
-	template < typename VALUE, typename CONTAINER = memo::std_vector<VALUE>::type, typename PREDICATE = std::less< typename CONTAINER::value_type > > struct std_priority_queue
+	template < typename VALUE, typename CONTAINER = typename memo::std_vector<VALUE>::type, typename PREDICATE = std::less< typename CONTAINER::value_type > > struct std_priority_queue
 		{ typedef std::priority_queue< VALUE, CONTAINER, PREDICATE > type; };
 
 	#if MEMO_ENABLE_TEMPLATE_USING
@@ -106,34 +85,34 @@ namespace memo
 
 		// StdMap< KEY, VALUE, PREDICATE = std::less >
 		template < typename KEY, typename VALUE, typename PREDICATE = typename std::less< KEY > >
-			using StdMap = std::map< KEY, VALUE, PREDICATE, typename StdAllocator< std::pair<KEY, VALUE> > >;
+			using StdMap = std::map< KEY, VALUE, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > >;
 
 		// StdMultiMap< KEY, VALUE, PREDICATE = std::less >
 		template <typename KEY, typename VALUE, typename PREDICATE = typename std::less< KEY > > 
-			using StdMultiMap = std::multimap< KEY, VALUE, PREDICATE, typename StdAllocator< std::pair<KEY, VALUE> > >;
+			using StdMultiMap = std::multimap< KEY, VALUE, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > >;
 
 		// StdSet< VALUE, PREDICATE = std::less >
 		template <typename VALUE, typename PREDICATE = typename std::less< VALUE > >
-			using StdSet = std::set< VALUE, PREDICATE, typename StdAllocator< VALUE > >;
+			using StdSet = std::set< VALUE, PREDICATE, StdAllocator< VALUE > >;
 
 		// StdMultiSet< KEY, VALUE, PREDICATE = std::less >
 		template <typename VALUE, typename PREDICATE = typename std::less< VALUE > >
-			using StdMultiSet = std::multiset< VALUE, PREDICATE, typename StdAllocator< VALUE > >;
+			using StdMultiSet = std::multiset< VALUE, PREDICATE, StdAllocator< VALUE > >;
 
 		// StdUnorderedMap< KEY, VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
 		template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > 
-			using StdUnorderedMap = std::unordered_map< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<KEY, VALUE> > >;
+			using StdUnorderedMap = std::unordered_map< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > >;
 
 		// StdUnorderedMultimap< KEY, VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
 		template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > 
-			using StdUnorderedMultimap = std::unordered_multimap< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<KEY, VALUE> > > ;
+			using StdUnorderedMultimap = std::unordered_multimap< KEY, VALUE, HASH, PREDICATE, StdAllocator< std::pair<const KEY, VALUE> > > ;
 
 		// StdUnorderedSet< VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
-		template < typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> >
+		template < typename VALUE, typename HASH = std::hash<VALUE>, typename PREDICATE = std::equal_to<VALUE> >
 			using StdUnorderedSet = std::unordered_set< VALUE, HASH, PREDICATE, StdAllocator< VALUE > > ;
 
 		// StdUnorderedMultiset< VALUE, HASH = std::hash<KEY>, PREDICATE = std::equal_to<KEY> >::type
-		template < typename VALUE, typename HASH = std::hash<KEY>, typename PREDICATE = std::equal_to<KEY> > 
+		template < typename VALUE, typename HASH = std::hash<VALUE>, typename PREDICATE = std::equal_to<VALUE> > 
 			using StdUnorderedMultiset = std::unordered_multiset< VALUE, HASH, PREDICATE, StdAllocator< VALUE > >;
 					
 		// StdPriorityQueue< VALUE, CONTAINER = StdVector<KEY>, PREDICATE = std::less<KEY> >
@@ -1,4 +1,4 @@
 
-#include "..\memo.h"
+#include "../memo.h"
 
 
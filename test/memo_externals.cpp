@@ -1,5 +1,5 @@
 
-#include "..\memo.h"
+#include "../memo.h"
 
 #include <windows.h>
 
@@ -24,10 +24,32 @@ namespace memo_externals
 
 	void Mutex::lock()
 	{
+		if( InterlockedExchange( &m_lock, 1 ) == 0 )
+		{
+			#if MEMO_ENABLE_MUTEX_STATS
+				m_stats.m_acquisitions++;
+			#endif
+			return;
+		}
+
+		#if MEMO_ENABLE_MUTEX_STATS
+			LARGE_INTEGER start_time;
+			QueryPerformanceCounter( &start_time );
+		#endif
+
 		while( InterlockedExchange( &m_lock, 1 ) != 0 )
 		{
 			SwitchToThread();
 		}
+
+		#if MEMO_ENABLE_MUTEX_STATS
+			LARGE_INTEGER end_time, frequency;
+			QueryPerformanceCounter( &end_time );
+			QueryPerformanceFrequency( &frequency );
+			m_stats.m_acquisitions++;
+			m_stats.m_contended_acquisitions++;
+			m_stats.m_wait_nanoseconds += static_cast<uint64_t>( end_time.QuadPart - start_time.QuadPart ) * 1000000000 / static_cast<uint64_t>( frequency.QuadPart );
+		#endif
 	}
 
 	void Mutex::unlock()
@@ -59,6 +81,167 @@ namespace memo_externals
 		g_thread_context = i_thread_context;
 	}
 
+	#if MEMO_ENABLE_VIRTUAL_MEMORY
+
+		/* Ranges are reserved and committed at once: committed pages take physical memory only when they are touched.
+			VirtualAlloc aligns a range to the allocation granularity (usually 64K). A range with a bigger alignment is 
+			obtained reserving a bigger range to find an aligned address, and reserving again at that address, after 
+			having released the bigger range. Another thread may take the address in the meanwhile, so the operation is 
+			retried. Large pages require the SeLockMemoryPrivilege, and they are locked in physical memory. */
+		void * virtual_alloc( size_t i_size, size_t i_alignment, bool i_huge_pages )
+		{
+			if( i_huge_pages )
+			{
+				const size_t large_page_size = GetLargePageMinimum();
+				if( large_page_size != 0 && ( i_size % large_page_size ) == 0 && i_alignment <= large_page_size )
+				{
+					void * address = VirtualAlloc( nullptr, i_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE );
+					if( address != nullptr )
+						return address;
+				}
+			}
+
+			SYSTEM_INFO system_info;
+			GetSystemInfo( &system_info );
+			if( i_alignment <= system_info.dwAllocationGranularity )
+				return VirtualAlloc( nullptr, i_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+
+			for( int attempt = 0; attempt < 16; attempt++ )
+			{
+				void * reserved = VirtualAlloc( nullptr, i_size + i_alignment, MEM_RESERVE, PAGE_NOACCESS );
+				if( reserved == nullptr )
+					return nullptr;
+				void * address = reinterpret_cast<void *>( ( reinterpret_cast<uintptr_t>( reserved ) + i_alignment - 1 ) & ~( i_alignment - 1 ) );
+				VirtualFree( reserved, 0, MEM_RELEASE );
+
+				address = VirtualAlloc( address, i_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+				if( address != nullptr )
+					return address;
+			}
+			return nullptr;
+		}
+
+		void virtual_free( void * i_address, size_t i_size )
+		{
+			MEMO_UNUSED( i_size );
+			VirtualFree( i_address, 0, MEM_RELEASE );
+		}
+
+		void virtual_discard( void * i_address, size_t i_size )
+		{
+			VirtualAlloc( i_address, i_size, MEM_RESET, PAGE_READWRITE );
+		}
+
+		size_t virtual_page_size()
+		{
+			SYSTEM_INFO system_info;
+			GetSystemInfo( &system_info );
+			return system_info.dwPageSize;
+		}
+
+	#endif
+
+	#if MEMO_ENABLE_NUMA
+
+		/* A range is bound to a node decommitting its pages, and committing them again with VirtualAllocExNuma, that
+			sets the preferred node of the pages. Ranges of large pages can't be decommitted, so they are not bound. */
+		size_t numa_node_count()
+		{
+			ULONG highest_node = 0;
+			if( !GetNumaHighestNodeNumber( &highest_node ) )
+				return 1;
+			return static_cast<size_t>( highest_node ) + 1;
+		}
+
+		size_t numa_current_node()
+		{
+			PROCESSOR_NUMBER processor;
+			GetCurrentProcessorNumberEx( &processor );
+			USHORT node = 0;
+			if( !GetNumaProcessorNodeEx( &processor, &node ) || node >= numa_node_count() )
+				return 0;
+			return node;
+		}
+
+		void virtual_bind( void * i_address, size_t i_size, size_t i_node )
+		{
+			if( VirtualFree( i_address, i_size, MEM_DECOMMIT ) )
+				VirtualAllocExNuma( GetCurrentProcess(), i_address, i_size, MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>( i_node ) );
+		}
+
+	#endif
+
+	#if MEMO_ENABLE_SHARED_MEMORY
+
+		/* Shared memory objects are named file mappings backed by the paging file. A mapping object lives until the last
+			handle and the last view are closed, so the handle is closed after mapping the view, and removing the name is
+			not needed. SharedMutex is a spin lock yielding the processor, like Mutex. */
+		void * shared_memory_open( const char * i_name, size_t * io_size, bool * o_created )
+		{
+			char name[ 256 ];
+			if( _snprintf_s( name, sizeof( name ), _TRUNCATE, "Local\\%s", i_name ) < 0 )
+				return nullptr;
+
+			const uint64_t size = *io_size;
+			HANDLE mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 
+				static_cast<DWORD>( size >> 32 ), static_cast<DWORD>( size ), name );
+			if( mapping == nullptr )
+				return nullptr;
+			const bool created = GetLastError() != ERROR_ALREADY_EXISTS;
+
+			// an existing object is mapped whole, as its size may differ from the requested one
+			void * address = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, created ? *io_size : 0 );
+			CloseHandle( mapping );
+			if( address == nullptr )
+				return nullptr;
+
+			if( !created )
+			{
+				MEMORY_BASIC_INFORMATION info;
+				if( VirtualQuery( address, &info, sizeof( info ) ) == 0 )
+				{
+					UnmapViewOfFile( address );
+					return nullptr;
+				}
+				*io_size = info.RegionSize;
+			}
+
+			*o_created = created;
+			return address;
+		}
+
+		void shared_memory_close( void * i_address, size_t i_size )
+		{
+			MEMO_UNUSED( i_size );
+			UnmapViewOfFile( i_address );
+		}
+
+		void shared_memory_remove( const char * i_name )
+		{
+			MEMO_UNUSED( i_name );
+		}
+
+		void sleep_milliseconds( unsigned i_milliseconds )
+		{
+			Sleep( i_milliseconds );
+		}
+
+		void SharedMutex::lock()
+		{
+			while( InterlockedExchange( &m_lock, 1 ) != 0 )
+			{
+				SwitchToThread();
+			}
+		}
+
+		void SharedMutex::unlock()
+		{
+			MEMO_ASSERT( m_lock == 1 );
+			InterlockedExchange( &m_lock, 0 );
+		}
+
+	#endif
+
 	void register_custom_allocators( memo::AllocatorConfigFactory & i_factory )
 	{
 		MEMO_UNUSED( i_factory );
@@ -0,0 +1,385 @@
+#include "../memo.h"
+
+#include <stdio.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
+#include <linux/futex.h>
+#include <linux/mempolicy.h>
+
+namespace memo_externals
+{
+	void output_message( const char * i_message )
+	{
+		printf( "%s", i_message );
+		fflush( stdout );
+	}
+
+	void assert_failure( const char * i_condition )
+	{
+		printf( "assert failed: %s\n", i_condition );
+		fflush( stdout );
+		raise( SIGTRAP );
+	}
+	
+	void debug_break()
+	{
+		raise( SIGTRAP );
+	}
+
+
+	/* The state of the mutex is 0 if it is unlocked, 1 if it is locked and no thread is sleeping on it, 2 if
+		it is locked and some threads may be sleeping on it. A contended lock spins for g_mutex_spin_count 
+		iterations, hoping that the owner releases the mutex soon, and then sleeps on the futex. Sleeping threads
+		are not woken in FIFO order, so the mutex is not fair. */
+	static const unsigned g_mutex_spin_count = 128;
+
+	static inline void cpu_relax()
+	{
+		#if defined( __i386__ ) || defined( __x86_64__ )
+			__builtin_ia32_pause();
+		#elif defined( __aarch64__ )
+			__asm__ __volatile__( "yield" );
+		#endif
+	}
+
+	#if MEMO_ENABLE_MUTEX_STATS
+		static inline uint64_t get_time_nanoseconds()
+		{
+			timespec time;
+			clock_gettime( CLOCK_MONOTONIC, &time );
+			return static_cast<uint64_t>( time.tv_sec ) * 1000000000 + static_cast<uint64_t>( time.tv_nsec );
+		}
+	#endif
+
+	static inline bool try_acquire( volatile uint32_t & io_lock )
+	{
+		uint32_t expected = 0;
+		return __atomic_compare_exchange_n( &io_lock, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED );
+	}
+
+	// park: marks the mutex as having waiters, and sleeps until the owner wakes us
+	static void park( volatile uint32_t & io_lock, int i_futex_wait_operation )
+	{
+		while( __atomic_exchange_n( &io_lock, 2, __ATOMIC_ACQUIRE ) != 0 )
+		{
+			syscall( SYS_futex, reinterpret_cast<volatile int*>( &io_lock ), i_futex_wait_operation, 2, nullptr, nullptr, 0 );
+		}
+	}
+
+	/* lock_contended: called when try_acquire has failed. Spins, reading the state without writing it, until the 
+		mutex is released or the spin count is exhausted, and then parks */
+	static void lock_contended( volatile uint32_t & io_lock, int i_futex_wait_operation )
+	{
+		for( unsigned spin = 0; spin < g_mutex_spin_count; spin++ )
+		{
+			cpu_relax();
+			if( __atomic_load_n( &io_lock, __ATOMIC_RELAXED ) == 0 && try_acquire( io_lock ) )
+				return;
+		}
+
+		park( io_lock, i_futex_wait_operation );
+	}
+
+	// release: unlocks the mutex, and wakes a sleeping thread if there may be any
+	static void release( volatile uint32_t & io_lock, int i_futex_wake_operation )
+	{
+		MEMO_ASSERT( __atomic_load_n( &io_lock, __ATOMIC_RELAXED ) != 0 );
+		if( __atomic_exchange_n( &io_lock, 0, __ATOMIC_RELEASE ) == 2 )
+		{
+			syscall( SYS_futex, reinterpret_cast<volatile int*>( &io_lock ), i_futex_wake_operation, 1, nullptr, nullptr, 0 );
+		}
+	}
+
+	void Mutex::lock()
+	{
+		if( try_acquire( m_lock ) )
+		{
+			#if MEMO_ENABLE_MUTEX_STATS
+				m_stats.m_acquisitions++;
+			#endif
+			return;
+		}
+
+		#if MEMO_ENABLE_MUTEX_STATS
+			const uint64_t start_time = get_time_nanoseconds();
+		#endif
+
+		lock_contended( m_lock, FUTEX_WAIT_PRIVATE );
+
+		#if MEMO_ENABLE_MUTEX_STATS
+			m_stats.m_acquisitions++;
+			m_stats.m_contended_acquisitions++;
+			m_stats.m_wait_nanoseconds += get_time_nanoseconds() - start_time;
+		#endif
+	}
+
+	void Mutex::unlock()
+	{
+		release( m_lock, FUTEX_WAKE_PRIVATE );
+	}
+
+	#if MEMO_ENABLE_VIRTUAL_MEMORY
+
+		/* Ranges are mapped with MAP_NORESERVE, so the kernel does not account the whole range as committed, and assigns
+			the pages on the first touch. An aligned range is obtained mapping a bigger range, and unmapping the excess at
+			both ends. Huge pages are requested first with MAP_HUGETLB, that succeeds only if the administrator has reserved 
+			huge pages, and then with madvise( MADV_HUGEPAGE ), that enables transparent huge pages on the range. */
+		static const size_t g_huge_page_size = 2 * 1024 * 1024;
+
+		void * virtual_alloc( size_t i_size, size_t i_alignment, bool i_huge_pages )
+		{
+			const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+			size_t alignment = std::max( i_alignment, virtual_page_size() );
+
+			if( i_huge_pages )
+			{
+				#ifdef MAP_HUGETLB
+					if( ( i_size % g_huge_page_size ) == 0 && alignment <= g_huge_page_size )
+					{
+						// without MAP_NORESERVE the mapping fails if the reserved huge pages are not enough, instead of faulting later
+						void * address = mmap( nullptr, i_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+						if( address != MAP_FAILED )
+							return address;
+					}
+				#endif
+
+				// transparent huge pages are used only in the parts of the range aligned to the huge page size
+				alignment = std::max( alignment, g_huge_page_size );
+			}
+
+			const size_t mapped_size = i_size + alignment - virtual_page_size();
+			char * mapped = static_cast<char *>( mmap( nullptr, mapped_size, PROT_READ | PROT_WRITE, flags, -1, 0 ) );
+			if( mapped == MAP_FAILED )
+				return nullptr;
+
+			char * address = reinterpret_cast<char *>( ( reinterpret_cast<uintptr_t>( mapped ) + alignment - 1 ) & ~( alignment - 1 ) );
+			if( address != mapped )
+				munmap( mapped, address - mapped );
+			if( address + i_size != mapped + mapped_size )
+				munmap( address + i_size, ( mapped + mapped_size ) - ( address + i_size ) );
+
+			#ifdef MADV_HUGEPAGE
+				if( i_huge_pages )
+					madvise( address, i_size, MADV_HUGEPAGE );
+			#endif
+
+			return address;
+		}
+
+		void virtual_free( void * i_address, size_t i_size )
+		{
+			munmap( i_address, i_size );
+		}
+
+		void virtual_discard( void * i_address, size_t i_size )
+		{
+			// the pages are given back to the kernel, and they are zero-filled when touched again
+			madvise( i_address, i_size, MADV_DONTNEED );
+		}
+
+		size_t virtual_page_size()
+		{
+			static const size_t page_size = static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+			return page_size;
+		}
+
+	#endif
+
+	#if MEMO_ENABLE_NUMA
+
+		/* The nodes are read from sysfs, where the file lists the nodes as ranges, like "0-1" or "0,2-3". Nodes without
+			memory or without processors may appear, so the count is the highest index plus one. The node of the current
+			processor is returned directly by getcpu. Pages are bound with the preferred policy, so that when the node
+			is exhausted the kernel takes memory from other nodes instead of failing. */
+		static size_t read_numa_node_count()
+		{
+			FILE * file = fopen( "/sys/devices/system/node/possible", "r" );
+			if( file == nullptr )
+				return 1;
+
+			unsigned long highest_node = 0, node;
+			char separator = 0;
+			while( fscanf( file, "%lu%c", &node, &separator ) >= 1 )
+			{
+				highest_node = std::max( highest_node, node );
+				if( separator == '\n' )
+					break;
+			}
+			fclose( file );
+			return static_cast<size_t>( highest_node ) + 1;
+		}
+
+		size_t numa_node_count()
+		{
+			static const size_t node_count = read_numa_node_count();
+			return node_count;
+		}
+
+		size_t numa_current_node()
+		{
+			const size_t node_count = numa_node_count();
+			if( node_count == 1 )
+				return 0;
+
+			unsigned cpu = 0, node = 0;
+			if( syscall( SYS_getcpu, &cpu, &node, nullptr ) != 0 || node >= node_count )
+				return 0;
+			return node;
+		}
+
+		void virtual_bind( void * i_address, size_t i_size, size_t i_node )
+		{
+			static const size_t bits_per_word = sizeof( unsigned long ) * 8;
+			unsigned long node_mask[ 16 ] = { 0 };
+			if( i_node >= bits_per_word * 16 )
+				return;
+			node_mask[ i_node / bits_per_word ] = 1ul << ( i_node % bits_per_word );
+
+			// the kernel ignores the last bit of the mask, so the number of bits passed is one more than the actual one
+			syscall( SYS_mbind, i_address, i_size, MPOL_PREFERRED, node_mask, bits_per_word * 16 + 1, 0 );
+		}
+
+	#endif
+
+	#if MEMO_ENABLE_SHARED_MEMORY
+
+		/* Shared memory objects are created with shm_open, so that other processes can open them by name. A process
+			opening an existing object may find it still empty, if the creator has not yet set its size, so it waits
+			for a limited time until the size is set, and then maps the whole object. SharedMutex works like Mutex, but it uses the process-shared 
+			variant of the futex operations, whose wait queue is keyed by the physical page instead of the address. */
+		static const unsigned g_shared_memory_open_retries = 1000; /**< times an empty object is checked, every millisecond */
+
+		void * shared_memory_open( const char * i_name, size_t * io_size, bool * o_created )
+		{
+			char path[ 256 ];
+			if( snprintf( path, sizeof( path ), "/%s", i_name ) >= static_cast<int>( sizeof( path ) ) )
+				return nullptr;
+
+			bool created = true;
+			int file = shm_open( path, O_RDWR | O_CREAT | O_EXCL, 0600 );
+			if( file >= 0 )
+			{
+				if( ftruncate( file, static_cast<off_t>( *io_size ) ) != 0 )
+				{
+					close( file );
+					shm_unlink( path );
+					return nullptr;
+				}
+			}
+			else if( errno == EEXIST )
+			{
+				created = false;
+				file = shm_open( path, O_RDWR, 0600 );
+				if( file < 0 )
+					return nullptr;
+
+				// the creator may have died before setting the size, so the wait is limited
+				struct stat file_stat;
+				file_stat.st_size = 0;
+				for( unsigned retry = 0; fstat( file, &file_stat ) == 0 && file_stat.st_size == 0 && retry < g_shared_memory_open_retries; retry++ )
+				{
+					const timespec delay = { 0, 1000 * 1000 };
+					nanosleep( &delay, nullptr );
+				}
+				if( file_stat.st_size <= 0 )
+				{
+					close( file );
+					return nullptr;
+				}
+				*io_size = static_cast<size_t>( file_stat.st_size );
+			}
+			else
+				return nullptr;
+
+			// the mapping keeps the object alive, so the descriptor is not needed anymore
+			void * address = mmap( nullptr, *io_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0 );
+			close( file );
+			if( address == MAP_FAILED )
+			{
+				if( created )
+					shm_unlink( path );
+				return nullptr;
+			}
+
+			*o_created = created;
+			return address;
+		}
+
+		void shared_memory_close( void * i_address, size_t i_size )
+		{
+			munmap( i_address, i_size );
+		}
+
+		void shared_memory_remove( const char * i_name )
+		{
+			char path[ 256 ];
+			if( snprintf( path, sizeof( path ), "/%s", i_name ) < static_cast<int>( sizeof( path ) ) )
+				shm_unlink( path );
+		}
+
+		void sleep_milliseconds( unsigned i_milliseconds )
+		{
+			const timespec delay = { static_cast<time_t>( i_milliseconds / 1000 ), static_cast<long>( i_milliseconds % 1000 ) * 1000 * 1000 };
+			nanosleep( &delay, nullptr );
+		}
+
+		// the mutex may be used by other processes, so the shared futex operations are used
+		void SharedMutex::lock()
+		{
+			if( !try_acquire( m_lock ) )
+				lock_contended( m_lock, FUTEX_WAIT );
+		}
+
+		void SharedMutex::unlock()
+		{
+			release( m_lock, FUTEX_WAKE );
+		}
+
+	#endif
+
+	#if MEMO_ENABLE_INLINE_TLS
+
+		// the accessors are defined inline in memo_externals.h
+		__thread memo::IAllocator * g_current_thread_allocator __attribute__(( tls_model( "initial-exec" ) ));
+		__thread memo::ThreadRoot * g_thread_root __attribute__(( tls_model( "initial-exec" ) ));
+
+	#else
+
+		__thread memo::IAllocator * g_allocator;
+		__thread memo::ThreadRoot * g_thread_context; 
+		
+		memo::IAllocator * get_current_thread_allocator()
+		{
+			return g_allocator;
+		}
+
+		void set_current_thread_allocator( memo::IAllocator * i_allocator )
+		{
+			g_allocator = i_allocator;
+		}
+
+		memo::ThreadRoot * get_thread_root()
+		{
+			return g_thread_context;
+		}
+
+		void set_thread_root( memo::ThreadRoot * i_thread_context )
+		{
+			g_thread_context = i_thread_context;
+		}
+
+	#endif
+
+	void register_custom_allocators( memo::AllocatorConfigFactory & i_factory )
+	{
+		MEMO_UNUSED( i_factory );
+	}
+
+} // namespace memo_externals